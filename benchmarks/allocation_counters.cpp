@@ -0,0 +1,226 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include "allocation_counters.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#	include <sys/resource.h>
+#endif
+
+#ifdef PV_BENCHMARK_ALLOCATION_COUNTERS
+
+namespace {
+std::atomic< std::uint64_t > allocation_count = 0;
+std::atomic< std::uint64_t > allocated_bytes  = 0;
+
+void *counted_allocation(std::size_t size) noexcept {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	return std::malloc(size > 0 ? size : 1);
+}
+
+void *counted_aligned_allocation(std::size_t size, std::align_val_t alignment) noexcept {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	const auto align = static_cast< std::size_t >(alignment);
+#	ifdef _WIN32
+	return _aligned_malloc(size > 0 ? size : 1, align);
+#	else
+	// aligned_alloc requires the size to be a multiple of the alignment
+	return std::aligned_alloc(align, ((size > 0 ? size : 1) + align - 1) / align * align);
+#	endif
+}
+
+void aligned_free(void *ptr) noexcept {
+#	ifdef _WIN32
+	_aligned_free(ptr);
+#	else
+	std::free(ptr);
+#	endif
+}
+} // namespace
+
+// Replacements of the global allocation and deallocation functions
+
+void *operator new(std::size_t size) {
+	if (void *ptr = counted_allocation(size)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return counted_allocation(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return counted_allocation(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	if (void *ptr = counted_aligned_allocation(size, alignment)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return counted_aligned_allocation(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return counted_aligned_allocation(size, alignment);
+}
+
+// GCC mistakes the free() calls below for mismatched deallocations once the inlined delete calls are traced back to
+// operator new (which is replaced by malloc-based versions above)
+#if defined(__GNUC__) && !defined(__clang__)
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+	aligned_free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#	pragma GCC diagnostic pop
+#endif
+
+#endif // PV_BENCHMARK_ALLOCATION_COUNTERS
+
+namespace {
+/**
+ * @returns The peak resident set size of the process in bytes (or 0 if unknown)
+ */
+double peak_resident_bytes() {
+#if defined(__unix__) || defined(__APPLE__)
+	rusage usage = {};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+
+#	ifdef __APPLE__
+	return static_cast< double >(usage.ru_maxrss);
+#	else
+	// Reported in KiB
+	return static_cast< double >(usage.ru_maxrss) * 1024;
+#	endif
+#else
+	return 0;
+#endif
+}
+} // namespace
+
+bool allocation_counters::available() {
+#ifdef PV_BENCHMARK_ALLOCATION_COUNTERS
+	return true;
+#else
+	return false;
+#endif
+}
+
+allocation_counters::totals allocation_counters::current() {
+#ifdef PV_BENCHMARK_ALLOCATION_COUNTERS
+	return { allocation_count.load(std::memory_order_relaxed), allocated_bytes.load(std::memory_order_relaxed) };
+#else
+	return {};
+#endif
+}
+
+void allocation_counters::start() {
+	m_start = current();
+}
+
+void allocation_counters::stop() {
+	m_stop = current();
+}
+
+void allocation_counters::report(benchmark::State &state) const {
+	if (!available() || state.iterations() == 0) {
+		return;
+	}
+
+	state.counters["allocs/op"] = benchmark::Counter(static_cast< double >(m_stop.allocations - m_start.allocations)
+														 / static_cast< double >(state.iterations()));
+
+	const double peak_rss = peak_resident_bytes();
+	if (peak_rss > 0) {
+		state.counters["peak-rss"] = benchmark::Counter(peak_rss, benchmark::Counter::kDefaults,
+														benchmark::Counter::kIs1024);
+	}
+}
+
+void allocation_counters::report_footprint(benchmark::State &state, const totals &before, const totals &after,
+										   std::uint64_t inline_bytes, std::int64_t elements) {
+	if (!available() || elements <= 0) {
+		return;
+	}
+
+	const auto heap_bytes = static_cast< double >(after.bytes - before.bytes);
+
+	state.counters["bytes/elem"] =
+		benchmark::Counter((static_cast< double >(inline_bytes) + heap_bytes) / static_cast< double >(elements));
+}
@@ -0,0 +1,53 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_BENCHMARKS_ALLOCATION_COUNTERS_HPP__
+#define PV_BENCHMARKS_ALLOCATION_COUNTERS_HPP__
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+/**
+ * Counts the heap allocations performed by the benchmark executable (via a replacement of the global operator new)
+ * and reports them along with the peak resident set size of the process. If support was disabled at configure time,
+ * the counters are not available and all reporting functions turn into no-ops.
+ */
+class allocation_counters {
+public:
+	struct totals {
+		std::uint64_t allocations = 0;
+		std::uint64_t bytes       = 0;
+	};
+
+	static bool available();
+
+	/**
+	 * @returns The amount of allocations (and allocated bytes) performed by the process so far
+	 */
+	static totals current();
+
+	void start();
+	void stop();
+
+	/**
+	 * Adds the average amount of allocations per iteration of the benchmark and the peak resident set size to the
+	 * given benchmark state
+	 */
+	void report(benchmark::State &state) const;
+
+	/**
+	 * Adds the memory footprint per element to the given benchmark state. The footprint consists of the given inline
+	 * size (e.g. the size of the objects stored in a container) plus the heap memory allocated between the two given
+	 * snapshots, distributed over the given amount of elements.
+	 */
+	static void report_footprint(benchmark::State &state, const totals &before, const totals &after,
+								 std::uint64_t inline_bytes, std::int64_t elements);
+
+private:
+	totals m_start;
+	totals m_stop;
+};
+
+#endif // PV_BENCHMARKS_ALLOCATION_COUNTERS_HPP__
@@ -0,0 +1,237 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/batch_scheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct task_result {
+	double latency_ns   = 0;
+	std::uint64_t value = 0;
+};
+
+class Task {
+public:
+	Task() = default;
+	Task(task_result *result, std::uint64_t seed) : m_result(result), m_seed(seed), m_submitted(clock_type::now()) {}
+	virtual ~Task() = default;
+
+	virtual void run() = 0;
+
+protected:
+	void finish(std::uint64_t value) {
+		m_result->value      = value;
+		m_result->latency_ns = std::chrono::duration< double, std::nano >(clock_type::now() - m_submitted).count();
+	}
+
+	task_result *m_result = nullptr;
+	std::uint64_t m_seed  = 0;
+	clock_type::time_point m_submitted;
+};
+
+class HashTask : public Task {
+public:
+	using Task::Task;
+
+	void run() override {
+		std::uint64_t hash = m_seed ^ std::uint64_t{ 0xcbf29ce484222325 };
+		for (int i = 0; i < 16; ++i) {
+			hash = (hash ^ static_cast< std::uint64_t >(i)) * std::uint64_t{ 0x100000001b3 };
+		}
+		finish(hash);
+	}
+};
+
+class XorShiftTask : public Task {
+public:
+	using Task::Task;
+
+	void run() override {
+		std::uint64_t x = m_seed | 1;
+		for (int i = 0; i < 16; ++i) {
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+		}
+		finish(x);
+	}
+};
+
+class SumTask : public Task {
+public:
+	using Task::Task;
+
+	void run() override {
+		std::uint64_t sum = 0;
+		for (std::uint64_t i = 0; i < 16; ++i) {
+			sum += (m_seed + i) * i;
+		}
+		finish(sum);
+	}
+};
+
+class CollatzTask : public Task {
+public:
+	using Task::Task;
+
+	void run() override {
+		std::uint64_t n     = (m_seed % 1000) + 1;
+		std::uint64_t steps = 0;
+		while (n != 1 && steps < 32) {
+			n = n % 2 == 0 ? n / 2 : 3 * n + 1;
+			steps++;
+		}
+		finish(steps);
+	}
+};
+
+using task_variant = pv::polymorphic_variant< Task, HashTask, XorShiftTask, SumTask, CollatzTask >;
+
+/**
+ * The baseline: a thread pool that executes the tasks one after the other in the order they have been submitted
+ */
+class fifo_scheduler {
+public:
+	explicit fifo_scheduler(std::size_t worker_count) {
+		for (std::size_t i = 0; i < worker_count; ++i) {
+			m_workers.emplace_back([this]() { work(); });
+		}
+	}
+
+	~fifo_scheduler() {
+		{
+			std::lock_guard< std::mutex > guard(m_mutex);
+			m_stop = true;
+		}
+		m_work_available.notify_all();
+
+		for (std::thread &worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	void submit(task_variant &&task) {
+		{
+			std::lock_guard< std::mutex > guard(m_mutex);
+			m_tasks.push_back(std::move(task));
+			m_unfinished++;
+		}
+		m_work_available.notify_one();
+	}
+
+	void wait() {
+		std::unique_lock< std::mutex > lock(m_mutex);
+		m_all_done.wait(lock, [this]() { return m_unfinished == 0; });
+	}
+
+private:
+	void work() {
+		std::unique_lock< std::mutex > lock(m_mutex);
+		while (true) {
+			m_work_available.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+			if (m_tasks.empty()) {
+				return;
+			}
+
+			task_variant task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+
+			lock.unlock();
+			task->run();
+			lock.lock();
+
+			if (--m_unfinished == 0) {
+				m_all_done.notify_all();
+			}
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_work_available;
+	std::condition_variable m_all_done;
+	std::deque< task_variant > m_tasks;
+	std::size_t m_unfinished = 0;
+	bool m_stop              = false;
+	std::vector< std::thread > m_workers;
+};
+
+task_variant make_task(std::size_t type, task_result *result, std::uint64_t seed) {
+	switch (type) {
+		case 0:
+			return task_variant(HashTask(result, seed));
+		case 1:
+			return task_variant(XorShiftTask(result, seed));
+		case 2:
+			return task_variant(SumTask(result, seed));
+		default:
+			return task_variant(CollatzTask(result, seed));
+	}
+}
+
+constexpr std::size_t worker_count = 4;
+
+template< typename Scheduler > void run_tasks(benchmark::State &state) {
+	const auto task_count = static_cast< std::size_t >(state.range(0));
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution< std::size_t > type_dist(0, 3);
+	std::vector< std::size_t > types(task_count);
+	std::generate(types.begin(), types.end(), [&]() { return type_dist(rng); });
+
+	std::vector< task_result > results(task_count);
+	std::vector< double > latencies;
+
+	Scheduler scheduler(worker_count);
+
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < task_count; ++i) {
+			scheduler.submit(make_task(types[i], &results[i], i));
+		}
+
+		scheduler.wait();
+
+		state.PauseTiming();
+		for (const task_result &result : results) {
+			latencies.push_back(result.latency_ns);
+		}
+		state.ResumeTiming();
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&latencies](double p) {
+		return latencies[static_cast< std::size_t >(p * static_cast< double >(latencies.size() - 1))];
+	};
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["p50_latency_us"] = percentile(0.5) / 1000;
+	state.counters["p99_latency_us"] = percentile(0.99) / 1000;
+}
+
+} // namespace
+
+static void BM_scheduler_batched(benchmark::State &state) {
+	run_tasks< pv::batch_scheduler< Task, HashTask, XorShiftTask, SumTask, CollatzTask > >(state);
+}
+
+BENCHMARK(BM_scheduler_batched)->RangeMultiplier(8)->Range(512, 1 << 15)->UseRealTime();
+
+static void BM_scheduler_fifo(benchmark::State &state) {
+	run_tasks< fifo_scheduler >(state);
+}
+
+BENCHMARK(BM_scheduler_fifo)->RangeMultiplier(8)->Range(512, 1 << 15)->UseRealTime();
@@ -5,16 +5,21 @@
 #include <benchmark/benchmark.h>
 
 #include <pv/polymorphic_variant.hpp>
+#include <pv/tagged_ptr.hpp>
 
 #include <algorithm>
 #include <random>
 #include <vector>
 
+#include "allocation_counters.hpp"
 #include "benchmark_classes.hpp"
 #include "initializer.hpp"
+#include "perf_counters.hpp"
 
 
 template< typename T, bool visibleInit > void call_virtual_function(benchmark::State &state) {
+	const allocation_counters::totals before_init = allocation_counters::current();
+
 	typename initializer< T >::storage_type value = [&]() {
 		if constexpr (visibleInit) {
 			return initializer< T >::visibleInit();
@@ -23,6 +28,13 @@ template< typename T, bool visibleInit > void call_virtual_function(benchmark::S
 		}
 	}();
 
+	allocation_counters::report_footprint(state, before_init, allocation_counters::current(), sizeof(value), 1);
+
+	perf_counters counters;
+	allocation_counters allocations;
+	counters.start();
+	allocations.start();
+
 	for (auto _ : state) {
 		if constexpr (std::is_same_v< std::decay_t< T >, std::variant< Dog, Cat > >) {
 			benchmark::DoNotOptimize(std::visit([](auto &&val) { return val.make_noise(); }, value));
@@ -30,6 +42,11 @@ template< typename T, bool visibleInit > void call_virtual_function(benchmark::S
 			benchmark::DoNotOptimize(value->make_noise());
 		}
 	}
+
+	allocations.stop();
+	counters.stop();
+	counters.report(state, 1);
+	allocations.report(state);
 }
 
 template< typename T > static void BM_visibleInit(benchmark::State &state) {
@@ -52,9 +69,15 @@ static void BM_devirtualized(benchmark::State &state) {
 	Dog dog;
 	Animal *animal = &dog;
 
+	perf_counters counters;
+	counters.start();
+
 	for (auto _ : state) {
 		benchmark::DoNotOptimize(animal->make_noise());
 	}
+
+	counters.stop();
+	counters.report(state, 1);
 }
 
 BENCHMARK(BM_devirtualized);
@@ -65,6 +88,8 @@ template< typename T, bool visibleInit > void perform_linear_search(benchmark::S
 	std::mt19937 rng(dev());
 	std::uniform_int_distribution< int > dist(-5, 5);
 
+	const allocation_counters::totals before_init = allocation_counters::current();
+
 	std::vector< typename initializer< T >::storage_type > vec;
 	vec.reserve(static_cast< std::size_t >(state.range(0)));
 
@@ -78,8 +103,16 @@ template< typename T, bool visibleInit > void perform_linear_search(benchmark::S
 		}());
 	}
 
+	// The vector's buffer is part of the allocated memory
+	allocation_counters::report_footprint(state, before_init, allocation_counters::current(), 0, state.range(0));
+
 	std::shuffle(vec.begin(), vec.end(), rng);
 
+	perf_counters counters;
+	allocation_counters allocations;
+	counters.start();
+	allocations.start();
+
 	for (auto _ : state) {
 		// We search for an element that can't exist (due to the limits we chose for our RNG above)
 		// to ensure that we iterate over the entire vector and don't stop early
@@ -88,6 +121,12 @@ template< typename T, bool visibleInit > void perform_linear_search(benchmark::S
 				std::find_if(vec.begin(), vec.end(), [](const typename initializer< T >::storage_type &val) {
 					return std::visit([](auto &&v) { return v.get_member() > 10; }, val);
 				}));
+		} else if constexpr (std::is_same_v< pv::tagged_ptr< Animal, Dog, Cat >, std::decay_t< T > >) {
+			// Dispatches on the type index stored in the pointer, so that the call can be devirtualized
+			benchmark::DoNotOptimize(
+				std::find_if(vec.begin(), vec.end(), [](const typename initializer< T >::storage_type &val) {
+					return val.visit([](auto &&v) { return v.get_member() > 10; });
+				}));
 		} else {
 			benchmark::DoNotOptimize(
 				std::find_if(vec.begin(), vec.end(), [](const typename initializer< T >::storage_type &val) {
@@ -95,6 +134,11 @@ template< typename T, bool visibleInit > void perform_linear_search(benchmark::S
 				}));
 		}
 	}
+
+	allocations.stop();
+	counters.stop();
+	counters.report(state, state.range(0));
+	allocations.report(state);
 }
 
 template< typename T > static void BM_linearSearch_visibleInit(benchmark::State &state) {
@@ -117,6 +161,7 @@ constexpr const int64_t rangeEnd = constexpr_pow(8, 6);
 BENCHMARK(BM_linearSearch_visibleInit< pv::polymorphic_variant< Animal, Dog, Cat > >)->Range(1, rangeEnd);
 BENCHMARK(BM_linearSearch_visibleInit< Animal >)->Range(1, rangeEnd);
 BENCHMARK(BM_linearSearch_visibleInit< std::variant< Dog, Cat > >)->Range(1, rangeEnd);
+BENCHMARK(BM_linearSearch_visibleInit< pv::tagged_ptr< Animal, Dog, Cat > >)->Range(1, rangeEnd);
 
 template< typename T > static void BM_linearSearch_hiddenInit(benchmark::State &state) {
 	perform_linear_search< T, false >(state);
@@ -125,12 +170,15 @@ template< typename T > static void BM_linearSearch_hiddenInit(benchmark::State &
 BENCHMARK(BM_linearSearch_hiddenInit< pv::polymorphic_variant< Animal, Dog, Cat > >)->Range(1, rangeEnd);
 BENCHMARK(BM_linearSearch_hiddenInit< Animal >)->Range(1, rangeEnd);
 BENCHMARK(BM_linearSearch_hiddenInit< std::variant< Dog, Cat > >)->Range(1, rangeEnd);
+BENCHMARK(BM_linearSearch_hiddenInit< pv::tagged_ptr< Animal, Dog, Cat > >)->Range(1, rangeEnd);
 
 static void BM_linearSearch_devirtualized(benchmark::State &state) {
 	std::random_device dev;
 	std::mt19937 rng(dev());
 	std::uniform_int_distribution< int > dist(-5, 5);
 
+	const allocation_counters::totals before_init = allocation_counters::current();
+
 	std::vector< Dog > vec;
 	vec.reserve(static_cast< std::size_t >(state.range(0)));
 
@@ -138,14 +186,26 @@ static void BM_linearSearch_devirtualized(benchmark::State &state) {
 		vec.push_back(Dog(dist(rng)));
 	}
 
+	allocation_counters::report_footprint(state, before_init, allocation_counters::current(), 0, state.range(0));
+
 	std::shuffle(vec.begin(), vec.end(), rng);
 
+	perf_counters counters;
+	allocation_counters allocations;
+	counters.start();
+	allocations.start();
+
 	for (auto _ : state) {
 		benchmark::DoNotOptimize(
 			// We search for an element that can't exist (due to the limits we chose for our RNG above)
 			// to ensure that we iterate over the entire vector and don't stop early
 			std::find_if(vec.begin(), vec.end(), [](const Dog &dog) { return dog.get_member() > 10; }));
 	}
+
+	allocations.stop();
+	counters.stop();
+	counters.report(state, state.range(0));
+	allocations.report(state);
 }
 
 BENCHMARK(BM_linearSearch_devirtualized)->Range(1, rangeEnd);
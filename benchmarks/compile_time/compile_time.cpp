@@ -0,0 +1,99 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+// Instantiates polymorphic_variant PV_COMPILE_TIME_INSTANTIATIONS times (with distinct types) and applies a number of
+// operators to every instantiation. This translation unit is only compiled (not linked) in order to measure the time
+// and memory the compiler's frontend requires for it.
+
+#include <pv/polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#ifndef PV_COMPILE_TIME_INSTANTIATIONS
+#	define PV_COMPILE_TIME_INSTANTIATIONS 1
+#endif
+
+template< std::size_t I > class Value {
+public:
+	virtual ~Value() = default;
+
+	virtual int value() const = 0;
+
+	Value &operator+=(const Value &other) {
+		m_offset += other.value();
+		return *this;
+	}
+
+	Value &operator+=(int offset) {
+		m_offset += offset;
+		return *this;
+	}
+
+	friend bool operator==(const Value &lhs, const Value &rhs) { return lhs.value() == rhs.value(); }
+	friend bool operator!=(const Value &lhs, const Value &rhs) { return !(lhs == rhs); }
+	friend bool operator<(const Value &lhs, const Value &rhs) { return lhs.value() < rhs.value(); }
+	friend bool operator==(const Value &lhs, int rhs) { return lhs.value() == rhs; }
+
+protected:
+	int m_offset = 0;
+};
+
+template< std::size_t I > class Small : public Value< I > {
+public:
+	int value() const override { return this->m_offset + 1; }
+};
+
+template< std::size_t I > class Medium : public Value< I > {
+public:
+	int data[4] = {};
+
+	int value() const override { return this->m_offset + data[0]; }
+};
+
+template< std::size_t I > class Large : public Value< I > {
+public:
+	int data[16] = {};
+
+	int value() const override { return this->m_offset + data[15]; }
+};
+
+template< std::size_t I > class Empty : public Value< I > {
+public:
+	int value() const override { return this->m_offset; }
+};
+
+namespace pv {
+// Infer operator+ from operator+=
+template< std::size_t I > struct infer_operator_overloads< Value< I > > : std::true_type {};
+} // namespace pv
+
+template< std::size_t I >
+using value_variant = pv::polymorphic_variant< Value< I >, Small< I >, Medium< I >, Large< I >, Empty< I > >;
+
+template< std::size_t I > int exercise(int selector) {
+	value_variant< I > lhs;
+	value_variant< I > rhs = Large< I >{};
+
+	if (selector % 2 == 0) {
+		lhs.template emplace< Medium< I > >();
+	}
+
+	lhs += rhs;
+	lhs += selector;
+
+	const value_variant< I > sum = lhs + rhs;
+
+	return static_cast< int >(lhs == rhs) + static_cast< int >(lhs != rhs) + static_cast< int >(lhs < rhs)
+		   + static_cast< int >(lhs == selector) + static_cast< int >(rhs.get() == sum) + sum->value();
+}
+
+template< std::size_t... Instances > int exercise_all(int selector, std::index_sequence< Instances... >) {
+	return (exercise< Instances >(selector) + ...);
+}
+
+int main(int argc, char **) {
+	return exercise_all(argc, std::make_index_sequence< PV_COMPILE_TIME_INSTANTIATIONS >{}) == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+// Runs the given command (a compiler invocation) and reports the wall-clock time as well as the peak resident memory
+// it required. Usage: pv_measure_compile <label> <command> [<args>...]
+
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: %s <label> <command> [<args>...]\n", argv[0]);
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	const pid_t child = fork();
+	if (child < 0) {
+		std::perror("fork");
+		return 1;
+	}
+	if (child == 0) {
+		std::vector< char * > args(argv + 2, argv + argc);
+		args.push_back(nullptr);
+
+		execvp(args[0], args.data());
+		std::perror("execvp");
+		_exit(127);
+	}
+
+	int status = 0;
+	rusage usage{};
+	if (wait4(child, &status, 0, &usage) < 0) {
+		std::perror("wait4");
+		return 1;
+	}
+
+	const std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		std::fprintf(stderr, "%s: compilation failed\n", argv[1]);
+		return 1;
+	}
+
+	// ru_maxrss is reported in kilobytes on Linux (but in bytes on macOS)
+#ifdef __APPLE__
+	const double peak_mib = static_cast< double >(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+	const double peak_mib = static_cast< double >(usage.ru_maxrss) / 1024.0;
+#endif
+
+	std::printf("%-24s %8.2f s %10.1f MiB\n", argv[1], elapsed.count(), peak_mib);
+
+	return 0;
+}
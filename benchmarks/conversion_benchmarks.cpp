@@ -0,0 +1,205 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Event {
+public:
+	virtual ~Event() = default;
+
+	virtual std::size_t weight() const = 0;
+};
+
+class Click final : public Event {
+public:
+	int x;
+	int y;
+
+	Click(int x_, int y_) : x(x_), y(y_) {}
+
+	std::size_t weight() const override { return 1; }
+};
+
+class KeyPress final : public Event {
+public:
+	// Long enough to not fit into the small string buffer, so that copying allocates
+	std::string text;
+
+	KeyPress(std::string t) : text(std::move(t)) {}
+
+	std::size_t weight() const override { return text.size(); }
+};
+
+class Resize final : public Event {
+public:
+	int width;
+	int height;
+
+	Resize(int w, int h) : width(w), height(h) {}
+
+	std::size_t weight() const override { return 2; }
+};
+
+// The event types produced by the input stage and the ones accepted by the processing stage
+using input_event = pv::polymorphic_variant< Event, Click, KeyPress >;
+using any_event   = pv::polymorphic_variant< Event, Click, KeyPress, Resize >;
+
+constexpr std::size_t batch_size = 1 << 14;
+
+template< typename Variant > std::vector< Variant > make_batch(bool with_resizes) {
+	std::mt19937 rng(42);
+	std::vector< Variant > events;
+	events.reserve(batch_size);
+
+	for (std::size_t i = 0; i < batch_size; ++i) {
+		const int value = static_cast< int >(i);
+
+		switch (rng() % 3) {
+			case 0:
+				events.emplace_back(Click(value, value));
+				break;
+			case 1:
+				events.emplace_back(KeyPress("key press event number " + std::to_string(i)));
+				break;
+			default:
+				if constexpr (std::is_constructible_v< Variant, Resize >) {
+					if (with_resizes) {
+						events.emplace_back(Resize(value, value));
+						break;
+					}
+				}
+				events.emplace_back(Click(value, -value));
+				break;
+		}
+	}
+
+	return events;
+}
+
+// Widens by downcasting the base-class reference and copying the concrete object into a new variant
+any_event widen_via_dynamic_cast(const input_event &event) {
+	if (const Click *click = dynamic_cast< const Click * >(&event.get())) {
+		return any_event(*click);
+	}
+
+	return any_event(dynamic_cast< const KeyPress & >(event.get()));
+}
+
+void BM_conversion_widen_dynamicCast(benchmark::State &state) {
+	const std::vector< input_event > input = make_batch< input_event >(false);
+
+	for (auto _ : state) {
+		std::vector< any_event > output;
+		output.reserve(input.size());
+
+		for (const input_event &event : input) {
+			output.push_back(widen_via_dynamic_cast(event));
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(batch_size));
+}
+BENCHMARK(BM_conversion_widen_dynamicCast);
+
+void BM_conversion_widen_copy(benchmark::State &state) {
+	const std::vector< input_event > input = make_batch< input_event >(false);
+
+	for (auto _ : state) {
+		std::vector< any_event > output;
+		output.reserve(input.size());
+
+		for (const input_event &event : input) {
+			output.emplace_back(event);
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(batch_size));
+}
+BENCHMARK(BM_conversion_widen_copy);
+
+// Consumes the input batch (as a pipeline stage handing its events on would)
+void BM_conversion_widen_move(benchmark::State &state) {
+	const std::vector< input_event > prototype = make_batch< input_event >(false);
+	std::vector< input_event > input;
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		input = prototype;
+		state.ResumeTiming();
+
+		std::vector< any_event > output;
+		output.reserve(input.size());
+
+		for (input_event &event : input) {
+			output.emplace_back(std::move(event));
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(batch_size));
+}
+BENCHMARK(BM_conversion_widen_move);
+
+// Narrows by downcasting the base-class reference (skipping events that the input stage can't represent)
+void BM_conversion_narrow_dynamicCast(benchmark::State &state) {
+	const std::vector< any_event > input = make_batch< any_event >(true);
+
+	for (auto _ : state) {
+		std::vector< input_event > output;
+		output.reserve(input.size());
+
+		for (const any_event &event : input) {
+			if (const Click *click = dynamic_cast< const Click * >(&event.get())) {
+				output.emplace_back(*click);
+			} else if (const KeyPress *key_press = dynamic_cast< const KeyPress * >(&event.get())) {
+				output.emplace_back(*key_press);
+			}
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(batch_size));
+}
+BENCHMARK(BM_conversion_narrow_dynamicCast);
+
+void BM_conversion_narrow(benchmark::State &state) {
+	const std::vector< any_event > input = make_batch< any_event >(true);
+
+	for (auto _ : state) {
+		std::vector< input_event > output;
+		output.reserve(input.size());
+
+		for (const any_event &event : input) {
+			if (std::optional< input_event > narrowed = pv::narrow< input_event >(event)) {
+				output.push_back(std::move(*narrowed));
+			}
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(batch_size));
+}
+BENCHMARK(BM_conversion_narrow);
+
+} // namespace
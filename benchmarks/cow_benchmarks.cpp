@@ -0,0 +1,94 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/cow_polymorphic_variant.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "benchmark_classes.hpp"
+
+namespace {
+
+using plain_type  = pv::polymorphic_variant< Animal, Dog, Cat >;
+using cow_type    = pv::cow_polymorphic_variant< Animal, Dog, Cat >;
+using shared_type = std::shared_ptr< const Animal >;
+
+template< typename T > T make_prototype(int i) {
+	if constexpr (std::is_same_v< T, shared_type >) {
+		return i % 2 == 0 ? shared_type(std::make_shared< Dog >(i)) : shared_type(std::make_shared< Cat >(i));
+	} else {
+		return i % 2 == 0 ? T(Dog(i)) : T(Cat(i));
+	}
+}
+
+constexpr int prototype_count = 16;
+
+/**
+ * Copies a small set of distinct values many times (e.g. handing out the same configuration objects to many
+ * consumers) and reads from every copy afterwards
+ */
+template< typename T > void copy_and_read(benchmark::State &state) {
+	const auto copies = static_cast< std::size_t >(state.range(0));
+
+	std::vector< T > prototypes;
+	for (int i = 0; i < prototype_count; ++i) {
+		prototypes.push_back(make_prototype< T >(i));
+	}
+
+	for (auto _ : state) {
+		std::vector< T > values;
+		values.reserve(copies);
+
+		for (std::size_t i = 0; i < copies; ++i) {
+			values.push_back(prototypes[i % prototype_count]);
+		}
+
+		int sum = 0;
+		for (const T &current : values) {
+			sum += current->get_member();
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+template< typename T > static void BM_copyAndRead(benchmark::State &state) {
+	copy_and_read< T >(state);
+}
+
+BENCHMARK(BM_copyAndRead< plain_type >)->RangeMultiplier(8)->Range(64, 1 << 15);
+BENCHMARK(BM_copyAndRead< cow_type >)->RangeMultiplier(8)->Range(64, 1 << 15);
+BENCHMARK(BM_copyAndRead< shared_type >)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+static void BM_copyAndMutate_cow(benchmark::State &state) {
+	// Worst case for copy-on-write: every copy gets mutated
+	const cow_type prototype(Dog(1));
+
+	for (auto _ : state) {
+		cow_type copy = prototype;
+		copy->filler[0] = 42;
+		benchmark::DoNotOptimize(copy.cget());
+	}
+}
+
+BENCHMARK(BM_copyAndMutate_cow);
+
+static void BM_copyAndMutate_plain(benchmark::State &state) {
+	const plain_type prototype(Dog(1));
+
+	for (auto _ : state) {
+		plain_type copy = prototype;
+		copy->filler[0] = 42;
+		benchmark::DoNotOptimize(copy.get());
+	}
+}
+
+BENCHMARK(BM_copyAndMutate_plain);
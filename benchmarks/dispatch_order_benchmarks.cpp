@@ -0,0 +1,103 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/pv.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The Tag allows creating otherwise identical polymorphic_variant instantiations that use different dispatch orders
+template< int Tag > class Instruction {
+public:
+	virtual ~Instruction() = default;
+
+	virtual int execute(int value) const = 0;
+};
+
+template< int Tag, int I > class Op : public Instruction< Tag > {
+public:
+	int execute(int value) const override { return value * (I + 1) + I; }
+};
+
+template< int Tag >
+using program_variant = pv::polymorphic_variant< Instruction< Tag >, Op< Tag, 0 >, Op< Tag, 1 >, Op< Tag, 2 >,
+												 Op< Tag, 3 >, Op< Tag, 4 >, Op< Tag, 5 >, Op< Tag, 6 >, Op< Tag, 7 > >;
+
+using unordered_variant = program_variant< 0 >;
+using ordered_variant   = program_variant< 1 >;
+
+// The type that makes up the majority of all elements (deliberately not the first type)
+constexpr std::size_t hot_type = 5;
+
+} // namespace
+
+namespace pv {
+// What dispatch_profile< ordered_variant >::write_order generates for the skewed distributions used below
+template<> struct dispatch_order< ordered_variant > { using type = std::index_sequence< hot_type >; };
+} // namespace pv
+
+namespace {
+
+template< typename Variant, std::size_t... I >
+Variant make_op(std::size_t index, std::index_sequence< I... >) {
+	Variant op;
+	((index == I ? static_cast< void >(op = std::variant_alternative_t< I, typename Variant::variant_type >{})
+				 : static_cast< void >(0)),
+	 ...);
+
+	return op;
+}
+
+/**
+ * Creates a program in which hot_percentage percent of the instructions are of the hot type (the remaining ones are
+ * distributed uniformly across all types)
+ */
+template< typename Variant > std::vector< Variant > make_program(std::int64_t hot_percentage) {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution< std::int64_t > percent_dist(0, 99);
+	std::uniform_int_distribution< std::size_t > type_dist(0, 7);
+
+	std::vector< Variant > program;
+	for (std::size_t i = 0; i < 4096; ++i) {
+		const std::size_t type = percent_dist(rng) < hot_percentage ? hot_type : type_dist(rng);
+		program.push_back(make_op< Variant >(type, std::make_index_sequence< 8 >{}));
+	}
+
+	return program;
+}
+
+template< typename Variant > void run_program(benchmark::State &state) {
+	const std::vector< Variant > program = make_program< Variant >(state.range(0));
+
+	for (auto _ : state) {
+		int value = 0;
+		for (const Variant &instruction : program) {
+			value = instruction.visit([value](const auto &op) { return op.execute(value); });
+		}
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(program.size()));
+}
+
+} // namespace
+
+static void BM_skewedDispatch_unordered(benchmark::State &state) {
+	run_program< unordered_variant >(state);
+}
+
+BENCHMARK(BM_skewedDispatch_unordered)->ArgName("hot_percent")->Arg(50)->Arg(90)->Arg(99);
+
+static void BM_skewedDispatch_ordered(benchmark::State &state) {
+	run_program< ordered_variant >(state);
+}
+
+BENCHMARK(BM_skewedDispatch_ordered)->ArgName("hot_percent")->Arg(50)->Arg(90)->Arg(99);
@@ -0,0 +1,217 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.hpp"
+#include "workload_storage.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum event_category : std::uint32_t {
+	input   = 1 << 0,
+	window  = 1 << 1,
+	timer   = 1 << 2,
+	network = 1 << 3,
+};
+
+/**
+ * The state the events are folded into by the pipeline
+ */
+struct pipeline_state {
+	std::uint32_t accepted_categories = input | window | network;
+
+	std::array< std::uint32_t, 256 > key_presses = {};
+	std::int64_t cursor_x                        = 0;
+	std::int64_t cursor_y                        = 0;
+	std::uint32_t width                          = 0;
+	std::uint32_t height                         = 0;
+	std::uint64_t bytes_received                 = 0;
+	std::uint32_t checksum                       = 0;
+};
+
+class Event {
+public:
+	virtual ~Event() = default;
+
+	virtual event_category category() const = 0;
+	// Urgent events are applied immediately, the others are only counted (deferred)
+	virtual bool urgent() const                     = 0;
+	virtual void apply(pipeline_state &state) const = 0;
+};
+
+class KeyPress final : public Event {
+public:
+	std::uint8_t key;
+	bool repeat;
+
+	KeyPress(std::uint8_t k, bool r) : key(k), repeat(r) {}
+
+	event_category category() const override { return input; }
+	bool urgent() const override { return !repeat; }
+	void apply(pipeline_state &state) const override { ++state.key_presses[key]; }
+};
+
+class MouseMove final : public Event {
+public:
+	std::int16_t dx;
+	std::int16_t dy;
+
+	MouseMove(std::int16_t x, std::int16_t y) : dx(x), dy(y) {}
+
+	event_category category() const override { return input; }
+	bool urgent() const override { return dx != 0 || dy != 0; }
+	void apply(pipeline_state &state) const override {
+		state.cursor_x += dx;
+		state.cursor_y += dy;
+	}
+};
+
+class Resize final : public Event {
+public:
+	std::uint32_t width;
+	std::uint32_t height;
+
+	Resize(std::uint32_t w, std::uint32_t h) : width(w), height(h) {}
+
+	event_category category() const override { return window; }
+	bool urgent() const override { return true; }
+	void apply(pipeline_state &state) const override {
+		state.width  = width;
+		state.height = height;
+	}
+};
+
+class TimerTick final : public Event {
+public:
+	std::uint32_t timer_id;
+
+	TimerTick(std::uint32_t id) : timer_id(id) {}
+
+	event_category category() const override { return timer; }
+	bool urgent() const override { return false; }
+	void apply(pipeline_state &) const override {}
+};
+
+class Packet final : public Event {
+public:
+	std::uint32_t size;
+	std::array< std::uint8_t, 16 > header;
+
+	Packet(std::uint32_t s, std::uint8_t seed) : size(s) {
+		for (std::size_t i = 0; i < header.size(); ++i) {
+			header[i] = static_cast< std::uint8_t >(seed + i);
+		}
+	}
+
+	event_category category() const override { return network; }
+	bool urgent() const override { return size > 0; }
+	void apply(pipeline_state &state) const override {
+		state.bytes_received += size;
+		for (std::uint8_t byte : header) {
+			state.checksum = state.checksum * 31 + byte;
+		}
+	}
+};
+
+template< template< typename, typename... > class Policy >
+using event_storage = Policy< Event, KeyPress, MouseMove, Resize, TimerTick, Packet >;
+
+using pv_events          = event_storage< polymorphic_variant_storage >;
+using std_variant_events = event_storage< std_variant_storage >;
+using unique_ptr_events  = event_storage< unique_ptr_storage >;
+
+/**
+ * The raw input from which events are produced (identical for all storage policies). Mouse moves dominate, as they
+ * do in typical UI event streams.
+ */
+struct raw_event {
+	std::uint32_t kind;
+	std::uint32_t a;
+	std::uint32_t b;
+};
+
+std::vector< raw_event > make_raw_events(std::size_t count) {
+	std::mt19937 rng(42);
+	std::discrete_distribution< std::uint32_t > kinds({ 20, 50, 2, 10, 18 });
+
+	std::vector< raw_event > events(count);
+	for (raw_event &event : events) {
+		event = { kinds(rng), static_cast< std::uint32_t >(rng()), static_cast< std::uint32_t >(rng()) };
+	}
+
+	return events;
+}
+
+template< typename Storage > typename Storage::element_type produce(const raw_event &raw) {
+	switch (raw.kind) {
+		case 0:
+			return Storage::template make< KeyPress >(static_cast< std::uint8_t >(raw.a), raw.b % 4 == 0);
+		case 1:
+			return Storage::template make< MouseMove >(static_cast< std::int16_t >(raw.a % 21) - 10,
+													   static_cast< std::int16_t >(raw.b % 21) - 10);
+		case 2:
+			return Storage::template make< Resize >(raw.a % 4096, raw.b % 4096);
+		case 3:
+			return Storage::template make< TimerTick >(raw.a);
+		default:
+			return Storage::template make< Packet >(raw.a % 1500, static_cast< std::uint8_t >(raw.b));
+	}
+}
+
+} // namespace
+
+/**
+ * Produces a batch of events (creating an object for each of them) and feeds it through a pipeline that filters the
+ * events by category, applies the urgent ones and counts the others
+ */
+template< typename Storage > static void BM_eventPipelineWorkload(benchmark::State &state) {
+	const std::vector< raw_event > raw_events = make_raw_events(static_cast< std::size_t >(state.range(0)));
+
+	std::vector< typename Storage::element_type > batch;
+	batch.reserve(raw_events.size());
+	pipeline_state pipeline;
+
+	perf_counters counters;
+	counters.start();
+
+	for (auto _ : state) {
+		batch.clear();
+		for (const raw_event &raw : raw_events) {
+			batch.push_back(produce< Storage >(raw));
+		}
+
+		std::size_t deferred = 0;
+		for (const auto &event : batch) {
+			Storage::invoke(event, [&pipeline, &deferred](const auto &e) {
+				if ((e.category() & pipeline.accepted_categories) == 0) {
+					return;
+				}
+
+				if (e.urgent()) {
+					e.apply(pipeline);
+				} else {
+					++deferred;
+				}
+			});
+		}
+
+		benchmark::DoNotOptimize(deferred);
+		benchmark::DoNotOptimize(pipeline);
+	}
+
+	counters.stop();
+	counters.report(state, state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_eventPipelineWorkload, pv_events)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_eventPipelineWorkload, std_variant_events)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_eventPipelineWorkload, unique_ptr_events)->Range(1 << 8, 1 << 16);
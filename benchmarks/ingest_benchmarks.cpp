@@ -0,0 +1,178 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/algorithm.hpp>
+#include <pv/polymorphic_variant.hpp>
+#include <pv/tagged_vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// A decoded record, as produced by the input stage of an ingest pipeline
+struct Record {
+	std::uint64_t timestamp;
+	double value;
+};
+
+class Sample {
+public:
+	std::uint64_t timestamp;
+
+	Sample(std::uint64_t t) : timestamp(t) {}
+	virtual ~Sample() = default;
+
+	virtual double normalized() const = 0;
+};
+
+class Temperature final : public Sample {
+public:
+	double kelvin;
+
+	Temperature(const Record &record) : Sample(record.timestamp), kelvin(record.value + 273.15) {}
+
+	double normalized() const override { return kelvin / 300; }
+};
+
+class Pressure final : public Sample {
+public:
+	double pascal;
+
+	Pressure(const Record &record) : Sample(record.timestamp), pascal(record.value * 100) {}
+
+	double normalized() const override { return pascal / 101325; }
+};
+
+class Humidity final : public Sample {
+public:
+	double relative;
+	double dew_point = 0;
+
+	Humidity(const Record &record) : Sample(record.timestamp), relative(record.value / 100) {}
+
+	double normalized() const override { return relative; }
+};
+
+using sample_variant = pv::polymorphic_variant< Sample, Temperature, Pressure, Humidity >;
+using sample_vector  = pv::tagged_vector< Sample, Temperature, Pressure, Humidity >;
+
+constexpr std::size_t sample_count = 1'000'000;
+
+// The records arrive in runs of the same type (cycling through the types)
+std::vector< Record > make_records() {
+	std::vector< Record > records(sample_count);
+
+	for (std::size_t i = 0; i < records.size(); ++i) {
+		records[i] = { i, static_cast< double >(i % 100) };
+	}
+
+	return records;
+}
+
+template< typename Container = std::vector< sample_variant >, typename Ingest >
+void run_ingest_benchmark(benchmark::State &state, Ingest ingest) {
+	const std::vector< Record > records = make_records();
+	const std::size_t run_length        = static_cast< std::size_t >(state.range(0));
+
+	// The buffer is reused for every batch (as an ingest loop would do), so that the measurement isn't dominated by
+	// page faults of a freshly allocated buffer
+	Container samples;
+
+	for (auto _ : state) {
+		samples.clear();
+
+		for (std::size_t begin = 0; begin < records.size(); begin += run_length) {
+			const Record *first = records.data() + begin;
+			const Record *last  = records.data() + std::min(begin + run_length, records.size());
+
+			switch ((begin / run_length) % 3) {
+				case 0:
+					ingest(samples, Temperature{ *first }, first, last);
+					break;
+				case 1:
+					ingest(samples, Pressure{ *first }, first, last);
+					break;
+				default:
+					ingest(samples, Humidity{ *first }, first, last);
+					break;
+			}
+		}
+
+		benchmark::DoNotOptimize(samples.size());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(sample_count));
+}
+
+// Pushes every record into the vector on its own (the type is only used to select the alternative)
+void BM_ingest_pushBack(benchmark::State &state) {
+	run_ingest_benchmark(state, [](std::vector< sample_variant > &samples, const auto &type_tag, const Record *first,
+								   const Record *last) {
+		using type = std::decay_t< decltype(type_tag) >;
+
+		for (; first != last; ++first) {
+			samples.push_back(type(*first));
+		}
+	});
+}
+
+// Constructs the objects in place, but without reserving the capacity for the run
+void BM_ingest_emplaceBack(benchmark::State &state) {
+	run_ingest_benchmark(state, [](std::vector< sample_variant > &samples, const auto &type_tag, const Record *first,
+								   const Record *last) {
+		using type = std::decay_t< decltype(type_tag) >;
+
+		for (; first != last; ++first) {
+			samples.emplace_back(std::in_place_type_t< type >{}, *first);
+		}
+	});
+}
+
+void BM_ingest_appendN(benchmark::State &state) {
+	run_ingest_benchmark(state, [](std::vector< sample_variant > &samples, const auto &type_tag, const Record *first,
+								   const Record *last) {
+		pv::append_n< std::decay_t< decltype(type_tag) > >(samples, first, last);
+	});
+}
+
+void BM_ingest_appendNGenerator(benchmark::State &state) {
+	run_ingest_benchmark(state, [](std::vector< sample_variant > &samples, const auto &type_tag, const Record *first,
+								   const Record *last) {
+		pv::append_n< std::decay_t< decltype(type_tag) > >(samples, static_cast< std::size_t >(last - first),
+														   [&first]() -> const Record & { return *first++; });
+	});
+}
+
+void BM_ingest_taggedVector_emplaceBack(benchmark::State &state) {
+	run_ingest_benchmark< sample_vector >(
+		state, [](sample_vector &samples, const auto &type_tag, const Record *first, const Record *last) {
+			using type = std::decay_t< decltype(type_tag) >;
+
+			for (; first != last; ++first) {
+				samples.emplace_back< type >(*first);
+			}
+		});
+}
+
+void BM_ingest_taggedVector_appendN(benchmark::State &state) {
+	run_ingest_benchmark< sample_vector >(
+		state, [](sample_vector &samples, const auto &type_tag, const Record *first, const Record *last) {
+			samples.append_n< std::decay_t< decltype(type_tag) > >(first, last);
+		});
+}
+
+BENCHMARK(BM_ingest_pushBack)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ingest_emplaceBack)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ingest_appendN)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ingest_appendNGenerator)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ingest_taggedVector_emplaceBack)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ingest_taggedVector_appendN)->Arg(16)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+} // namespace
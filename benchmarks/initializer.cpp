@@ -27,3 +27,11 @@ std::unique_ptr< Animal > initRegular() {
 std::unique_ptr< Animal > initRegular(int arg) {
 	return std::make_unique< Dog >(arg);
 }
+
+pv::tagged_ptr< Animal, Dog, Cat > initTaggedPtr() {
+	return pv::tagged_ptr< Animal, Dog, Cat >(Dog{});
+}
+
+pv::tagged_ptr< Animal, Dog, Cat > initTaggedPtr(int arg) {
+	return pv::tagged_ptr< Animal, Dog, Cat >(Dog(arg));
+}
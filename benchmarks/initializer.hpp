@@ -8,6 +8,7 @@
 #include "benchmark_classes.hpp"
 
 #include <pv/polymorphic_variant.hpp>
+#include <pv/tagged_ptr.hpp>
 
 #include <memory>
 #include <variant>
@@ -18,6 +19,8 @@ std::variant< Dog, Cat > initStdVariant();
 std::variant< Dog, Cat > initStdVariant(int arg);
 std::unique_ptr< Animal > initRegular();
 std::unique_ptr< Animal > initRegular(int arg);
+pv::tagged_ptr< Animal, Dog, Cat > initTaggedPtr();
+pv::tagged_ptr< Animal, Dog, Cat > initTaggedPtr(int arg);
 
 template< typename T > struct initializer {};
 
@@ -57,4 +60,16 @@ template<> struct initializer< Animal > {
 	static storage_type hiddenInit(int arg) { return initRegular(arg); }
 };
 
+template<> struct initializer< pv::tagged_ptr< Animal, Dog, Cat > > {
+	using storage_type = pv::tagged_ptr< Animal, Dog, Cat >;
+
+	static storage_type visibleInit() { return storage_type(Cat{}); }
+
+	static storage_type hiddenInit() { return initTaggedPtr(); }
+
+	static storage_type visibleInit(int arg) { return storage_type(Cat(arg)); }
+
+	static storage_type hiddenInit(int arg) { return initTaggedPtr(arg); }
+};
+
 #endif // PV_BENCHMARKS_INITIALIZER_HPP__
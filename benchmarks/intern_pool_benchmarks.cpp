@@ -0,0 +1,196 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/intern_pool.hpp>
+
+#include <array>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class Config {
+public:
+	virtual ~Config() = default;
+
+	virtual int weight() const = 0;
+};
+
+class NamedConfig : public Config {
+public:
+	std::string name;
+	int level = 0;
+
+	NamedConfig(std::string n, int l) : name(std::move(n)), level(l) {}
+
+	int weight() const override { return level; }
+
+	bool operator==(const NamedConfig &other) const { return level == other.level && name == other.name; }
+};
+
+class NumericConfig : public Config {
+public:
+	std::array< double, 8 > parameters = {};
+
+	NumericConfig(double seed) { parameters.fill(seed); }
+
+	int weight() const override { return static_cast< int >(parameters[0]); }
+
+	bool operator==(const NumericConfig &other) const { return parameters == other.parameters; }
+};
+
+} // namespace
+
+namespace std {
+template<> struct hash< NamedConfig > {
+	std::size_t operator()(const NamedConfig &config) const {
+		return std::hash< std::string >{}(config.name) ^ static_cast< std::size_t >(config.level);
+	}
+};
+
+template<> struct hash< NumericConfig > {
+	std::size_t operator()(const NumericConfig &config) const { return std::hash< double >{}(config.parameters[0]); }
+};
+} // namespace std
+
+namespace {
+
+using variant_type = pv::polymorphic_variant< Config, NamedConfig, NumericConfig >;
+using pool_type    = pv::intern_pool< Config, NamedConfig, NumericConfig >;
+
+constexpr int distinct_values = 64;
+
+/**
+ * Creates a stream of values drawn from a small set of distinct values
+ */
+std::vector< variant_type > make_stream(std::size_t size) {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution< int > dist(0, distinct_values - 1);
+
+	std::vector< variant_type > stream;
+	stream.reserve(size);
+	for (std::size_t i = 0; i < size; ++i) {
+		const int value = dist(rng);
+		if (value % 2 == 0) {
+			stream.emplace_back(NamedConfig("configuration_" + std::to_string(value), value));
+		} else {
+			stream.emplace_back(NumericConfig(value));
+		}
+	}
+
+	return stream;
+}
+
+std::size_t heap_bytes(const variant_type &value) {
+	return value.visit([](const auto &concrete) -> std::size_t {
+		if constexpr (std::is_same_v< std::decay_t< decltype(concrete) >, NamedConfig >) {
+			// Short strings are stored inline
+			return concrete.name.capacity() > 15 ? concrete.name.capacity() + 1 : 0;
+		} else {
+			return 0;
+		}
+	});
+}
+
+} // namespace
+
+static void BM_intern_byValue(benchmark::State &state) {
+	const std::vector< variant_type > stream = make_stream(static_cast< std::size_t >(state.range(0)));
+
+	std::size_t bytes = 0;
+	for (auto _ : state) {
+		std::vector< variant_type > stored(stream.begin(), stream.end());
+		benchmark::DoNotOptimize(stored.data());
+
+		state.PauseTiming();
+		bytes = stored.size() * sizeof(variant_type);
+		for (const variant_type &current : stored) {
+			bytes += heap_bytes(current);
+		}
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["bytes_per_element"] = static_cast< double >(bytes) / static_cast< double >(state.range(0));
+}
+
+BENCHMARK(BM_intern_byValue)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_intern_pooled(benchmark::State &state) {
+	const std::vector< variant_type > stream = make_stream(static_cast< std::size_t >(state.range(0)));
+
+	std::size_t bytes = 0;
+	for (auto _ : state) {
+		pool_type pool;
+		std::vector< pool_type::handle > stored;
+		stored.reserve(stream.size());
+
+		for (const variant_type &current : stream) {
+			stored.push_back(pool.intern(current));
+		}
+		benchmark::DoNotOptimize(stored.data());
+
+		state.PauseTiming();
+		bytes = stored.size() * sizeof(pool_type::handle) + pool.size() * sizeof(variant_type);
+		std::vector< bool > counted(pool.size(), false);
+		for (pool_type::handle current : stored) {
+			if (!counted[current.id()]) {
+				bytes += heap_bytes(pool[current]);
+				counted[current.id()] = true;
+			}
+		}
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["bytes_per_element"] = static_cast< double >(bytes) / static_cast< double >(state.range(0));
+}
+
+BENCHMARK(BM_intern_pooled)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_internedEquality_byValue(benchmark::State &state) {
+	const std::vector< variant_type > stream = make_stream(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		std::size_t equal_neighbours = 0;
+		for (std::size_t i = 1; i < stream.size(); ++i) {
+			equal_neighbours += stream[i].index() == stream[i - 1].index()
+								&& stream[i].visit([&](const auto &current) {
+									   using type = std::decay_t< decltype(current) >;
+									   return current == static_cast< const type & >(stream[i - 1].get());
+								   });
+		}
+		benchmark::DoNotOptimize(equal_neighbours);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_internedEquality_byValue)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_internedEquality_pooled(benchmark::State &state) {
+	const std::vector< variant_type > stream = make_stream(static_cast< std::size_t >(state.range(0)));
+
+	pool_type pool;
+	std::vector< pool_type::handle > handles;
+	for (const variant_type &current : stream) {
+		handles.push_back(pool.intern(current));
+	}
+
+	for (auto _ : state) {
+		std::size_t equal_neighbours = 0;
+		for (std::size_t i = 1; i < handles.size(); ++i) {
+			equal_neighbours += handles[i] == handles[i - 1];
+		}
+		benchmark::DoNotOptimize(equal_neighbours);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_internedEquality_pooled)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
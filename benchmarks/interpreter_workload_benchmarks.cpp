@@ -0,0 +1,202 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.hpp"
+#include "workload_storage.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/**
+ * State of a small stack-based virtual machine
+ */
+struct machine {
+	std::array< std::int64_t, 16 > stack    = {};
+	std::size_t stack_size                  = 0;
+	std::array< std::int64_t, 4 > registers = {};
+
+	void push(std::int64_t value) { stack[stack_size++] = value; }
+	std::int64_t pop() { return stack[--stack_size]; }
+};
+
+/**
+ * A bytecode instruction. Executing it returns the index of the next instruction to execute.
+ */
+class Instruction {
+public:
+	virtual ~Instruction() = default;
+
+	virtual std::size_t execute(machine &vm, std::size_t pc) const = 0;
+};
+
+class Push final : public Instruction {
+public:
+	std::int64_t value;
+
+	Push(std::int64_t v) : value(v) {}
+
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		vm.push(value);
+		return pc + 1;
+	}
+};
+
+class Load final : public Instruction {
+public:
+	std::size_t reg;
+
+	Load(std::size_t r) : reg(r) {}
+
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		vm.push(vm.registers[reg]);
+		return pc + 1;
+	}
+};
+
+class Store final : public Instruction {
+public:
+	std::size_t reg;
+
+	Store(std::size_t r) : reg(r) {}
+
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		vm.registers[reg] = vm.pop();
+		return pc + 1;
+	}
+};
+
+class Add final : public Instruction {
+public:
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		const std::int64_t rhs = vm.pop();
+		vm.push(vm.pop() + rhs);
+		return pc + 1;
+	}
+};
+
+class Subtract final : public Instruction {
+public:
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		const std::int64_t rhs = vm.pop();
+		vm.push(vm.pop() - rhs);
+		return pc + 1;
+	}
+};
+
+class Multiply final : public Instruction {
+public:
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		const std::int64_t rhs = vm.pop();
+		vm.push(vm.pop() * rhs);
+		return pc + 1;
+	}
+};
+
+class Modulo final : public Instruction {
+public:
+	std::size_t execute(machine &vm, std::size_t pc) const override {
+		const std::int64_t rhs = vm.pop();
+		vm.push(vm.pop() % rhs);
+		return pc + 1;
+	}
+};
+
+class JumpIfNotZero final : public Instruction {
+public:
+	std::size_t target;
+
+	JumpIfNotZero(std::size_t t) : target(t) {}
+
+	std::size_t execute(machine &vm, std::size_t pc) const override { return vm.pop() != 0 ? target : pc + 1; }
+};
+
+class Halt final : public Instruction {
+public:
+	std::size_t execute(machine &, std::size_t) const override { return halt_pc; }
+
+	static constexpr std::size_t halt_pc = static_cast< std::size_t >(-1);
+};
+
+template< template< typename, typename... > class Policy >
+using instruction_storage =
+	Policy< Instruction, Push, Load, Store, Add, Subtract, Multiply, Modulo, JumpIfNotZero, Halt >;
+
+using pv_instructions          = instruction_storage< polymorphic_variant_storage >;
+using std_variant_instructions = instruction_storage< std_variant_storage >;
+using unique_ptr_instructions  = instruction_storage< unique_ptr_storage >;
+
+/**
+ * Compiles a program computing the sum over (i * i) % 7 + i for i = iterations, ..., 1 (leaving it in register 1)
+ */
+template< typename Storage > std::vector< typename Storage::element_type > compile(std::int64_t iterations) {
+	std::vector< typename Storage::element_type > program;
+
+	program.push_back(Storage::template make< Push >(iterations));
+	program.push_back(Storage::template make< Store >(0));
+	program.push_back(Storage::template make< Push >(0));
+	program.push_back(Storage::template make< Store >(1));
+
+	const std::size_t loop = program.size();
+	program.push_back(Storage::template make< Load >(1));
+	program.push_back(Storage::template make< Load >(0));
+	program.push_back(Storage::template make< Load >(0));
+	program.push_back(Storage::template make< Multiply >());
+	program.push_back(Storage::template make< Push >(7));
+	program.push_back(Storage::template make< Modulo >());
+	program.push_back(Storage::template make< Add >());
+	program.push_back(Storage::template make< Load >(0));
+	program.push_back(Storage::template make< Add >());
+	program.push_back(Storage::template make< Store >(1));
+	program.push_back(Storage::template make< Load >(0));
+	program.push_back(Storage::template make< Push >(1));
+	program.push_back(Storage::template make< Subtract >());
+	program.push_back(Storage::template make< Store >(0));
+	program.push_back(Storage::template make< Load >(0));
+	program.push_back(Storage::template make< JumpIfNotZero >(loop));
+	program.push_back(Storage::template make< Halt >());
+
+	return program;
+}
+
+} // namespace
+
+/**
+ * Runs a bytecode program in which every instruction is a separate object of a closed set of types
+ */
+template< typename Storage > static void BM_interpreterWorkload(benchmark::State &state) {
+	const auto program = compile< Storage >(state.range(0));
+
+	std::int64_t executed = 0;
+
+	perf_counters counters;
+	counters.start();
+
+	for (auto _ : state) {
+		machine vm;
+		std::size_t pc = 0;
+		executed       = 0;
+
+		while (pc != Halt::halt_pc) {
+			pc = Storage::invoke(program[pc],
+								 [&vm, pc](const auto &instruction) { return instruction.execute(vm, pc); });
+			++executed;
+		}
+
+		benchmark::DoNotOptimize(vm.registers[1]);
+	}
+
+	counters.stop();
+	counters.report(state, executed);
+	state.SetItemsProcessed(state.iterations() * executed);
+}
+
+BENCHMARK_TEMPLATE(BM_interpreterWorkload, pv_instructions)->Range(1 << 4, 1 << 12);
+BENCHMARK_TEMPLATE(BM_interpreterWorkload, std_variant_instructions)->Range(1 << 4, 1 << 12);
+BENCHMARK_TEMPLATE(BM_interpreterWorkload, unique_ptr_instructions)->Range(1 << 4, 1 << 12);
@@ -0,0 +1,127 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/message_queue.hpp>
+
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "benchmark_classes.hpp"
+
+namespace {
+
+constexpr std::size_t queue_capacity = 1024;
+constexpr int messages_per_run       = 1 << 16;
+
+/**
+ * The baseline: a mutex-guarded std::queue of heap-allocated messages
+ */
+class mutex_queue {
+public:
+	template< typename T > bool try_emplace(int arg) {
+		auto message = std::make_unique< T >(arg);
+
+		std::lock_guard< std::mutex > guard(m_mutex);
+		if (m_queue.size() >= queue_capacity) {
+			return false;
+		}
+
+		m_queue.push(std::move(message));
+
+		return true;
+	}
+
+	template< typename Visitor > bool try_consume(Visitor &&visitor) {
+		std::unique_ptr< Animal > message;
+		{
+			std::lock_guard< std::mutex > guard(m_mutex);
+			if (m_queue.empty()) {
+				return false;
+			}
+
+			message = std::move(m_queue.front());
+			m_queue.pop();
+		}
+
+		visitor(*message);
+
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::queue< std::unique_ptr< Animal > > m_queue;
+};
+
+template< typename Queue > std::unique_ptr< Queue > make_queue() {
+	if constexpr (std::is_same_v< Queue, mutex_queue >) {
+		return std::make_unique< Queue >();
+	} else {
+		return std::make_unique< Queue >(queue_capacity);
+	}
+}
+
+template< typename Queue, int producer_count > void transfer_messages(benchmark::State &state) {
+	constexpr int messages_per_producer = messages_per_run / producer_count;
+
+	for (auto _ : state) {
+		std::unique_ptr< Queue > queue = make_queue< Queue >();
+
+		std::vector< std::thread > producers;
+		for (int p = 0; p < producer_count; ++p) {
+			producers.emplace_back([&queue]() {
+				for (int i = 0; i < messages_per_producer; ++i) {
+					auto push = [&queue, i]() {
+						return i % 2 == 0 ? queue->template try_emplace< Dog >(i)
+										  : queue->template try_emplace< Cat >(i);
+					};
+
+					while (!push()) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		long long sum = 0;
+		int received  = 0;
+		while (received < messages_per_producer * producer_count) {
+			if (queue->try_consume([&sum](const auto &message) { sum += message.get_member(); })) {
+				received++;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+
+		for (std::thread &current : producers) {
+			current.join();
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * messages_per_run);
+}
+
+} // namespace
+
+template< typename Queue > static void BM_messageQueue_singleProducer(benchmark::State &state) {
+	transfer_messages< Queue, 1 >(state);
+}
+
+BENCHMARK(BM_messageQueue_singleProducer< pv::spsc_queue< Animal, Dog, Cat > >)->UseRealTime();
+BENCHMARK(BM_messageQueue_singleProducer< pv::mpsc_queue< Animal, Dog, Cat > >)->UseRealTime();
+BENCHMARK(BM_messageQueue_singleProducer< mutex_queue >)->UseRealTime();
+
+template< typename Queue > static void BM_messageQueue_multiProducer(benchmark::State &state) {
+	transfer_messages< Queue, 4 >(state);
+}
+
+BENCHMARK(BM_messageQueue_multiProducer< pv::mpsc_queue< Animal, Dog, Cat > >)->UseRealTime();
+BENCHMARK(BM_messageQueue_multiProducer< mutex_queue >)->UseRealTime();
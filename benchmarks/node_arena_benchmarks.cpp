@@ -0,0 +1,356 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/node_arena.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// The three implementations of an expression tree below are all built by the same recursive procedure from the same
+// random sequence, so that they represent identical trees
+
+enum class node_kind { literal, add, multiply, negate };
+
+/**
+ * Invokes builder.leaf(value), builder.unary(kind, child) and builder.binary(kind, lhs, rhs) in post-order
+ */
+template< typename Builder > auto build_tree(Builder &builder, std::mt19937 &rng, int depth) {
+	if (depth == 0) {
+		return builder.leaf(1 + static_cast< double >(rng() % 100) / 1000);
+	}
+
+	switch (rng() % 3) {
+		case 0: {
+			auto lhs = build_tree(builder, rng, depth - 1);
+			return builder.binary(node_kind::add, std::move(lhs), build_tree(builder, rng, depth - 1));
+		}
+		case 1: {
+			auto lhs = build_tree(builder, rng, depth - 1);
+			return builder.binary(node_kind::multiply, std::move(lhs), build_tree(builder, rng, depth - 1));
+		}
+		default:
+			return builder.unary(node_kind::negate, build_tree(builder, rng, depth - 1));
+	}
+}
+
+constexpr std::mt19937::result_type tree_seed = 42;
+
+
+// Variant nodes in a pv::node_arena
+
+class ArenaLiteral;
+class ArenaAdd;
+class ArenaMultiply;
+class ArenaNegate;
+class ArenaExpression;
+
+using expression_arena = pv::node_arena< ArenaExpression, ArenaLiteral, ArenaAdd, ArenaMultiply, ArenaNegate >;
+using arena_handle     = pv::node_handle< ArenaExpression >;
+
+class ArenaExpression {
+public:
+	virtual ~ArenaExpression() = default;
+
+	virtual double evaluate(const expression_arena &arena) const = 0;
+};
+
+class ArenaLiteral : public ArenaExpression {
+public:
+	double value;
+
+	ArenaLiteral(double v) : value(v) {}
+
+	double evaluate(const expression_arena &) const override { return value; }
+};
+
+class ArenaAdd : public ArenaExpression {
+public:
+	arena_handle lhs;
+	arena_handle rhs;
+
+	ArenaAdd(arena_handle l, arena_handle r) : lhs(l), rhs(r) {}
+
+	double evaluate(const expression_arena &arena) const override {
+		return arena.get(lhs).evaluate(arena) + arena.get(rhs).evaluate(arena);
+	}
+};
+
+class ArenaMultiply : public ArenaExpression {
+public:
+	arena_handle lhs;
+	arena_handle rhs;
+
+	ArenaMultiply(arena_handle l, arena_handle r) : lhs(l), rhs(r) {}
+
+	double evaluate(const expression_arena &arena) const override {
+		return arena.get(lhs).evaluate(arena) * arena.get(rhs).evaluate(arena);
+	}
+};
+
+class ArenaNegate : public ArenaExpression {
+public:
+	arena_handle operand;
+
+	ArenaNegate(arena_handle o) : operand(o) {}
+
+	double evaluate(const expression_arena &arena) const override { return -arena.get(operand).evaluate(arena); }
+};
+
+struct arena_builder {
+	expression_arena &arena;
+
+	arena_handle leaf(double value) { return arena.emplace< ArenaLiteral >(value); }
+
+	arena_handle unary(node_kind, arena_handle operand) { return arena.emplace< ArenaNegate >(operand); }
+
+	arena_handle binary(node_kind kind, arena_handle lhs, arena_handle rhs) {
+		if (kind == node_kind::add) {
+			return arena.emplace< ArenaAdd >(lhs, rhs);
+		}
+
+		return arena.emplace< ArenaMultiply >(lhs, rhs);
+	}
+};
+
+
+// Classic heap-allocated nodes owning their children via std::unique_ptr
+
+class HeapExpression {
+public:
+	virtual ~HeapExpression() = default;
+
+	virtual double evaluate() const = 0;
+};
+
+using heap_pointer = std::unique_ptr< HeapExpression >;
+
+class HeapLiteral : public HeapExpression {
+public:
+	double value;
+
+	HeapLiteral(double v) : value(v) {}
+
+	double evaluate() const override { return value; }
+};
+
+class HeapAdd : public HeapExpression {
+public:
+	heap_pointer lhs;
+	heap_pointer rhs;
+
+	HeapAdd(heap_pointer l, heap_pointer r) : lhs(std::move(l)), rhs(std::move(r)) {}
+
+	double evaluate() const override { return lhs->evaluate() + rhs->evaluate(); }
+};
+
+class HeapMultiply : public HeapExpression {
+public:
+	heap_pointer lhs;
+	heap_pointer rhs;
+
+	HeapMultiply(heap_pointer l, heap_pointer r) : lhs(std::move(l)), rhs(std::move(r)) {}
+
+	double evaluate() const override { return lhs->evaluate() * rhs->evaluate(); }
+};
+
+class HeapNegate : public HeapExpression {
+public:
+	heap_pointer operand;
+
+	HeapNegate(heap_pointer o) : operand(std::move(o)) {}
+
+	double evaluate() const override { return -operand->evaluate(); }
+};
+
+struct heap_builder {
+	std::size_t nodes = 0;
+
+	heap_pointer leaf(double value) {
+		++nodes;
+		return std::make_unique< HeapLiteral >(value);
+	}
+
+	heap_pointer unary(node_kind, heap_pointer operand) {
+		++nodes;
+		return std::make_unique< HeapNegate >(std::move(operand));
+	}
+
+	heap_pointer binary(node_kind kind, heap_pointer lhs, heap_pointer rhs) {
+		++nodes;
+		if (kind == node_kind::add) {
+			return std::make_unique< HeapAdd >(std::move(lhs), std::move(rhs));
+		}
+
+		return std::make_unique< HeapMultiply >(std::move(lhs), std::move(rhs));
+	}
+};
+
+
+// Non-polymorphic nodes in a flat std::vector of std::variant objects, referring to each other via indices
+
+struct FlatLiteral {
+	double value;
+};
+struct FlatAdd {
+	std::uint32_t lhs;
+	std::uint32_t rhs;
+};
+struct FlatMultiply {
+	std::uint32_t lhs;
+	std::uint32_t rhs;
+};
+struct FlatNegate {
+	std::uint32_t operand;
+};
+
+using flat_node = std::variant< FlatLiteral, FlatAdd, FlatMultiply, FlatNegate >;
+
+double evaluate_flat(const std::vector< flat_node > &nodes, std::uint32_t index) {
+	return std::visit(
+		[&nodes](const auto &node) -> double {
+			using node_type = std::decay_t< decltype(node) >;
+
+			if constexpr (std::is_same_v< node_type, FlatLiteral >) {
+				return node.value;
+			} else if constexpr (std::is_same_v< node_type, FlatAdd >) {
+				return evaluate_flat(nodes, node.lhs) + evaluate_flat(nodes, node.rhs);
+			} else if constexpr (std::is_same_v< node_type, FlatMultiply >) {
+				return evaluate_flat(nodes, node.lhs) * evaluate_flat(nodes, node.rhs);
+			} else {
+				return -evaluate_flat(nodes, node.operand);
+			}
+		},
+		nodes[index]);
+}
+
+struct flat_builder {
+	std::vector< flat_node > &nodes;
+
+	std::uint32_t add(flat_node node) {
+		nodes.push_back(node);
+		return static_cast< std::uint32_t >(nodes.size() - 1);
+	}
+
+	std::uint32_t leaf(double value) { return add(FlatLiteral{ value }); }
+
+	std::uint32_t unary(node_kind, std::uint32_t operand) { return add(FlatNegate{ operand }); }
+
+	std::uint32_t binary(node_kind kind, std::uint32_t lhs, std::uint32_t rhs) {
+		if (kind == node_kind::add) {
+			return add(FlatAdd{ lhs, rhs });
+		}
+
+		return add(FlatMultiply{ lhs, rhs });
+	}
+};
+
+} // namespace
+
+// Building (and destroying) trees
+
+static void BM_treeBuild_nodeArena(benchmark::State &state) {
+	std::size_t nodes = 0;
+
+	for (auto _ : state) {
+		std::mt19937 rng(tree_seed);
+		expression_arena arena;
+		arena_builder builder{ arena };
+
+		benchmark::DoNotOptimize(build_tree(builder, rng, static_cast< int >(state.range(0))));
+		nodes = arena.size();
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(nodes));
+}
+
+BENCHMARK(BM_treeBuild_nodeArena)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
+
+static void BM_treeBuild_uniquePtr(benchmark::State &state) {
+	std::size_t nodes = 0;
+
+	for (auto _ : state) {
+		std::mt19937 rng(tree_seed);
+		heap_builder builder;
+
+		heap_pointer root = build_tree(builder, rng, static_cast< int >(state.range(0)));
+		benchmark::DoNotOptimize(root.get());
+		nodes = builder.nodes;
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(nodes));
+}
+
+BENCHMARK(BM_treeBuild_uniquePtr)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
+
+static void BM_treeBuild_flatVariant(benchmark::State &state) {
+	std::size_t nodes = 0;
+
+	for (auto _ : state) {
+		std::mt19937 rng(tree_seed);
+		std::vector< flat_node > flat;
+		flat_builder builder{ flat };
+
+		benchmark::DoNotOptimize(build_tree(builder, rng, static_cast< int >(state.range(0))));
+		nodes = flat.size();
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(nodes));
+}
+
+BENCHMARK(BM_treeBuild_flatVariant)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
+
+// Evaluating existing trees
+
+static void BM_treeEvaluate_nodeArena(benchmark::State &state) {
+	std::mt19937 rng(tree_seed);
+	expression_arena arena;
+	arena_builder builder{ arena };
+	const arena_handle root = build_tree(builder, rng, static_cast< int >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(arena.get(root).evaluate(arena));
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(arena.size()));
+}
+
+BENCHMARK(BM_treeEvaluate_nodeArena)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
+
+static void BM_treeEvaluate_uniquePtr(benchmark::State &state) {
+	std::mt19937 rng(tree_seed);
+	heap_builder builder;
+	const heap_pointer root = build_tree(builder, rng, static_cast< int >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(root->evaluate());
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(builder.nodes));
+}
+
+BENCHMARK(BM_treeEvaluate_uniquePtr)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
+
+static void BM_treeEvaluate_flatVariant(benchmark::State &state) {
+	std::mt19937 rng(tree_seed);
+	std::vector< flat_node > flat;
+	flat_builder builder{ flat };
+	const std::uint32_t root = build_tree(builder, rng, static_cast< int >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(evaluate_flat(flat, root));
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(flat.size()));
+}
+
+BENCHMARK(BM_treeEvaluate_flatVariant)->Arg(10)->Arg(16)->Arg(20)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,95 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/optional_polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+
+class Component {
+public:
+	virtual ~Component() = default;
+
+	virtual int cost() const = 0;
+};
+
+class Light final : public Component {
+public:
+	int intensity;
+
+	Light(int i) : intensity(i) {}
+
+	int cost() const override { return intensity; }
+};
+
+class Collider final : public Component {
+public:
+	int shape;
+
+	Collider(int s) : shape(s) {}
+
+	int cost() const override { return 2 * shape; }
+};
+
+using component_variant = pv::polymorphic_variant< Component, Light, Collider >;
+
+// Every tenth entry of the sparse tables holds a component
+
+constexpr std::size_t occupied_per_mille = 100;
+
+template< typename Entry > std::vector< Entry > make_sparse_table(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< Entry > table(count);
+
+	for (Entry &entry : table) {
+		if (rng() % 1000 < occupied_per_mille) {
+			if (rng() % 2 == 0) {
+				entry = Light(static_cast< int >(rng() % 10));
+			} else {
+				entry = Collider(static_cast< int >(rng() % 10));
+			}
+		}
+	}
+
+	return table;
+}
+
+const Component &component(const std::optional< component_variant > &entry) {
+	return entry->get();
+}
+
+const Component &component(const pv::optional_polymorphic_variant< Component, Light, Collider > &entry) {
+	return entry.get();
+}
+
+template< typename Entry > void BM_sparseTable_sum(benchmark::State &state) {
+	const std::vector< Entry > table = make_sparse_table< Entry >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		int total = 0;
+		for (const Entry &entry : table) {
+			if (entry) {
+				total += component(entry).cost();
+			}
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["bytes/elem"] = static_cast< double >(sizeof(Entry));
+}
+
+BENCHMARK(BM_sparseTable_sum< std::optional< component_variant > >)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_sparseTable_sum< pv::optional_polymorphic_variant< Component, Light, Collider > >)
+	->RangeMultiplier(16)
+	->Range(1 << 10, 1 << 22);
+
+} // namespace
@@ -0,0 +1,131 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include "perf_counters.hpp"
+
+#if defined(PV_BENCHMARK_PERF_COUNTERS) && defined(__linux__)
+#	define PV_HAVE_PERF_EVENTS
+#endif
+
+#ifdef PV_HAVE_PERF_EVENTS
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+
+#	include <cstring>
+#endif
+
+namespace {
+constexpr std::array< const char *, 3 > counter_names = { "instructions/elem", "branch-misses/elem",
+														  "cache-misses/elem" };
+
+#ifdef PV_HAVE_PERF_EVENTS
+constexpr std::array< std::uint64_t, 3 > counter_configs = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+															 PERF_COUNT_HW_CACHE_MISSES };
+
+int open_counter(std::uint64_t config, int group_fd) {
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size           = sizeof(attr);
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.config         = config;
+	attr.exclude_kernel = true;
+	attr.exclude_hv     = true;
+	attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	// Only the group leader starts disabled - its siblings are enabled and disabled together with it
+	attr.disabled = group_fd < 0;
+
+	return static_cast< int >(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+} // namespace
+
+perf_counters::perf_counters() {
+	m_fds.fill(-1);
+	m_values.fill(0);
+
+#ifdef PV_HAVE_PERF_EVENTS
+	for (std::size_t i = 0; i < event_count; ++i) {
+		m_fds[i] = open_counter(counter_configs[i], m_group_fd);
+
+		if (m_fds[i] < 0) {
+			// Either all counters are available or we don't report any of them
+			for (int fd : m_fds) {
+				if (fd >= 0) {
+					close(fd);
+				}
+			}
+			m_fds.fill(-1);
+			m_group_fd = -1;
+			return;
+		}
+
+		if (i == 0) {
+			m_group_fd = m_fds[i];
+		}
+	}
+#endif
+}
+
+perf_counters::~perf_counters() {
+#ifdef PV_HAVE_PERF_EVENTS
+	for (int fd : m_fds) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+#endif
+}
+
+void perf_counters::start() {
+#ifdef PV_HAVE_PERF_EVENTS
+	m_measured = false;
+
+	if (available()) {
+		ioctl(m_group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(m_group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+#endif
+}
+
+void perf_counters::stop() {
+#ifdef PV_HAVE_PERF_EVENTS
+	if (!available()) {
+		return;
+	}
+
+	ioctl(m_group_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	// Layout for PERF_FORMAT_GROUP: nr, time_enabled, time_running, values[nr]
+	std::array< std::uint64_t, 3 + event_count > buffer{};
+	if (read(m_group_fd, buffer.data(), sizeof(buffer)) != static_cast< ssize_t >(sizeof(buffer))) {
+		return;
+	}
+
+	if (buffer[2] == 0) {
+		// The counters were never scheduled onto the PMU, so we don't know anything about the events
+		return;
+	}
+
+	// Compensate for multiplexing, in case the PMU had to share the counters with someone else
+	const double scale = static_cast< double >(buffer[1]) / static_cast< double >(buffer[2]);
+	for (std::size_t i = 0; i < event_count; ++i) {
+		m_values[i] = static_cast< double >(buffer[3 + i]) * scale;
+	}
+	m_measured = true;
+#endif
+}
+
+void perf_counters::report(benchmark::State &state, std::int64_t elements_per_iteration) const {
+	if (!m_measured || state.iterations() == 0 || elements_per_iteration <= 0) {
+		return;
+	}
+
+	const double divisor = static_cast< double >(state.iterations()) * static_cast< double >(elements_per_iteration);
+
+	for (std::size_t i = 0; i < event_count; ++i) {
+		state.counters[counter_names[i]] = benchmark::Counter(m_values[i] / divisor);
+	}
+}
@@ -0,0 +1,48 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_BENCHMARKS_PERF_COUNTERS_HPP__
+#define PV_BENCHMARKS_PERF_COUNTERS_HPP__
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Small wrapper around Linux' perf_event_open that counts retired instructions, branch misses and cache misses for
+ * the current thread. On other platforms, if support was disabled at configure time or if the kernel refuses to hand
+ * out the counters (e.g. due to perf_event_paranoid or when running inside a container), the counters are simply not
+ * available and report() turns into a no-op. The same happens if the last measurement didn't produce any values
+ * (e.g. because the counters were never scheduled onto the PMU).
+ */
+class perf_counters {
+public:
+	perf_counters();
+	~perf_counters();
+
+	perf_counters(const perf_counters &) = delete;
+	perf_counters &operator=(const perf_counters &) = delete;
+
+	bool available() const { return m_group_fd >= 0; }
+
+	void start();
+	void stop();
+
+	/**
+	 * Adds the counted events to the given benchmark state, normalized to a single element (where one iteration of
+	 * the benchmark processes elements_per_iteration elements)
+	 */
+	void report(benchmark::State &state, std::int64_t elements_per_iteration) const;
+
+private:
+	static constexpr std::size_t event_count = 3;
+
+	int m_group_fd = -1;
+	std::array< int, event_count > m_fds;
+	std::array< double, event_count > m_values;
+	bool m_measured = false;
+};
+
+#endif // PV_BENCHMARKS_PERF_COUNTERS_HPP__
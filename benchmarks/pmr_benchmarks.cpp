@@ -0,0 +1,112 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/pmr.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Record {
+public:
+	virtual ~Record() = default;
+
+	virtual std::size_t weight() const = 0;
+};
+
+class NamedRecord : public Record {
+public:
+	using allocator_type = std::pmr::polymorphic_allocator< char >;
+
+	std::pmr::string name;
+
+	NamedRecord(std::size_t id, const allocator_type &alloc = {})
+		: name("named_record_with_a_long_name_" + std::to_string(id), alloc) {}
+	NamedRecord(const NamedRecord &other, const allocator_type &alloc) : name(other.name, alloc) {}
+	NamedRecord(NamedRecord &&other, const allocator_type &alloc) : name(std::move(other.name), alloc) {}
+	NamedRecord(const NamedRecord &) = default;
+	NamedRecord(NamedRecord &&)      = default;
+	NamedRecord &operator=(const NamedRecord &) = default;
+	NamedRecord &operator=(NamedRecord &&) = default;
+
+	std::size_t weight() const override { return name.size(); }
+};
+
+class SampledRecord : public Record {
+public:
+	using allocator_type = std::pmr::polymorphic_allocator< int >;
+
+	std::pmr::vector< int > samples;
+
+	SampledRecord(std::size_t id, const allocator_type &alloc = {})
+		: samples(8 + id % 8, static_cast< int >(id), alloc) {}
+	SampledRecord(const SampledRecord &other, const allocator_type &alloc) : samples(other.samples, alloc) {}
+	SampledRecord(SampledRecord &&other, const allocator_type &alloc) : samples(std::move(other.samples), alloc) {}
+	SampledRecord(const SampledRecord &) = default;
+	SampledRecord(SampledRecord &&)      = default;
+	SampledRecord &operator=(const SampledRecord &) = default;
+	SampledRecord &operator=(SampledRecord &&) = default;
+
+	std::size_t weight() const override { return samples.size(); }
+};
+
+using record_vector = pv::pmr::vector< Record, NamedRecord, SampledRecord >;
+
+/**
+ * Fills a container of variants (each alternative owning heap memory) and traverses it afterwards
+ */
+std::size_t build_and_sum(record_vector &records, std::size_t count) {
+	for (std::size_t i = 0; i < count; ++i) {
+		if (i % 2 == 0) {
+			records.emplace_back(std::in_place_type_t< NamedRecord >{}, i);
+		} else {
+			records.emplace_back(std::in_place_type_t< SampledRecord >{}, i);
+		}
+	}
+
+	std::size_t sum = 0;
+	for (const auto &current : records) {
+		sum += current->weight();
+	}
+
+	return sum;
+}
+
+} // namespace
+
+static void BM_pmr_defaultHeap(benchmark::State &state) {
+	const auto count = static_cast< std::size_t >(state.range(0));
+
+	for (auto _ : state) {
+		record_vector records(std::pmr::new_delete_resource());
+		benchmark::DoNotOptimize(build_and_sum(records, count));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_pmr_defaultHeap)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+static void BM_pmr_monotonicBuffer(benchmark::State &state) {
+	const auto count = static_cast< std::size_t >(state.range(0));
+	// Big enough for all allocations, so that the resource never has to fall back to the heap
+	std::vector< std::byte > buffer(count * 512);
+
+	for (auto _ : state) {
+		std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+		record_vector records(&arena);
+		benchmark::DoNotOptimize(build_and_sum(records, count));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_pmr_monotonicBuffer)->RangeMultiplier(8)->Range(64, 1 << 15);
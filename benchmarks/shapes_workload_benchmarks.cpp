@@ -0,0 +1,252 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.hpp"
+#include "workload_storage.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Point {
+	float x = 0;
+	float y = 0;
+};
+
+struct BoundingBox {
+	Point min;
+	Point max;
+
+	bool contains(Point p) const { return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y; }
+};
+
+class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual float area() const               = 0;
+	virtual BoundingBox bounds() const       = 0;
+	virtual bool contains(Point point) const = 0;
+};
+
+class Circle final : public Shape {
+public:
+	Point center;
+	float radius;
+
+	Circle(Point c, float r) : center(c), radius(r) {}
+
+	float area() const override { return 3.14159265f * radius * radius; }
+
+	BoundingBox bounds() const override {
+		return { { center.x - radius, center.y - radius }, { center.x + radius, center.y + radius } };
+	}
+
+	bool contains(Point point) const override {
+		const float dx = point.x - center.x;
+		const float dy = point.y - center.y;
+		return dx * dx + dy * dy <= radius * radius;
+	}
+};
+
+class Rectangle final : public Shape {
+public:
+	Point corner;
+	float width;
+	float height;
+
+	Rectangle(Point c, float w, float h) : corner(c), width(w), height(h) {}
+
+	float area() const override { return width * height; }
+
+	BoundingBox bounds() const override { return { corner, { corner.x + width, corner.y + height } }; }
+
+	bool contains(Point point) const override { return bounds().contains(point); }
+};
+
+class Triangle final : public Shape {
+public:
+	std::array< Point, 3 > vertices;
+
+	Triangle(Point a, Point b, Point c) : vertices{ a, b, c } {}
+
+	float area() const override { return std::abs(signed_area(vertices[0], vertices[1], vertices[2])) / 2; }
+
+	BoundingBox bounds() const override {
+		BoundingBox box = { vertices[0], vertices[0] };
+		for (const Point &vertex : vertices) {
+			box.min = { std::fmin(box.min.x, vertex.x), std::fmin(box.min.y, vertex.y) };
+			box.max = { std::fmax(box.max.x, vertex.x), std::fmax(box.max.y, vertex.y) };
+		}
+		return box;
+	}
+
+	bool contains(Point point) const override {
+		const float d1 = signed_area(point, vertices[0], vertices[1]);
+		const float d2 = signed_area(point, vertices[1], vertices[2]);
+		const float d3 = signed_area(point, vertices[2], vertices[0]);
+
+		const bool has_negative = d1 < 0 || d2 < 0 || d3 < 0;
+		const bool has_positive = d1 > 0 || d2 > 0 || d3 > 0;
+		return !(has_negative && has_positive);
+	}
+
+private:
+	static float signed_area(Point a, Point b, Point c) {
+		return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+	}
+};
+
+class Capsule final : public Shape {
+public:
+	Point start;
+	Point end;
+	float radius;
+
+	Capsule(Point s, Point e, float r) : start(s), end(e), radius(r) {}
+
+	float area() const override {
+		const float length = std::hypot(end.x - start.x, end.y - start.y);
+		return 2 * radius * length + 3.14159265f * radius * radius;
+	}
+
+	BoundingBox bounds() const override {
+		return { { std::fmin(start.x, end.x) - radius, std::fmin(start.y, end.y) - radius },
+				 { std::fmax(start.x, end.x) + radius, std::fmax(start.y, end.y) + radius } };
+	}
+
+	bool contains(Point point) const override {
+		// Distance from the point to the capsule's core segment
+		const float sx = end.x - start.x;
+		const float sy = end.y - start.y;
+		const float px = point.x - start.x;
+		const float py = point.y - start.y;
+		const float t  = std::fmin(1.f, std::fmax(0.f, (px * sx + py * sy) / (sx * sx + sy * sy)));
+		const float dx = px - t * sx;
+		const float dy = py - t * sy;
+		return dx * dx + dy * dy <= radius * radius;
+	}
+};
+
+using pv_shapes          = polymorphic_variant_storage< Shape, Circle, Rectangle, Triangle, Capsule >;
+using std_variant_shapes = std_variant_storage< Shape, Circle, Rectangle, Triangle, Capsule >;
+using unique_ptr_shapes  = unique_ptr_storage< Shape, Circle, Rectangle, Triangle, Capsule >;
+
+constexpr float world_size = 1000;
+
+/**
+ * A scene of randomly placed shapes of random types (identical for all storage policies)
+ */
+template< typename Storage > std::vector< typename Storage::element_type > make_scene(std::size_t count) {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution< float > position(0, world_size);
+	std::uniform_real_distribution< float > extent(1, 20);
+
+	std::vector< typename Storage::element_type > scene;
+	scene.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		const Point origin = { position(rng), position(rng) };
+
+		switch (rng() % 4) {
+			case 0:
+				scene.push_back(Storage::template make< Circle >(origin, extent(rng)));
+				break;
+			case 1:
+				scene.push_back(Storage::template make< Rectangle >(origin, extent(rng), extent(rng)));
+				break;
+			case 2:
+				scene.push_back(Storage::template make< Triangle >(
+					origin, Point{ origin.x + extent(rng), origin.y }, Point{ origin.x, origin.y + extent(rng) }));
+				break;
+			default:
+				scene.push_back(Storage::template make< Capsule >(
+					origin, Point{ origin.x + extent(rng), origin.y + extent(rng) }, extent(rng) / 4));
+				break;
+		}
+	}
+
+	return scene;
+}
+
+std::vector< Point > make_probes(std::size_t count) {
+	std::mt19937 rng(7);
+	std::uniform_real_distribution< float > position(0, world_size);
+
+	std::vector< Point > probes(count);
+	for (Point &probe : probes) {
+		probe = { position(rng), position(rng) };
+	}
+
+	return probes;
+}
+
+} // namespace
+
+/**
+ * Sums up the areas of all shapes in the scene
+ */
+template< typename Storage > static void BM_shapesWorkload_area(benchmark::State &state) {
+	const auto scene = make_scene< Storage >(static_cast< std::size_t >(state.range(0)));
+
+	perf_counters counters;
+	counters.start();
+
+	for (auto _ : state) {
+		float total = 0;
+		for (const auto &shape : scene) {
+			total += Storage::invoke(shape, [](const auto &s) { return s.area(); });
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	counters.stop();
+	counters.report(state, state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_shapesWorkload_area, pv_shapes)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_shapesWorkload_area, std_variant_shapes)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_shapesWorkload_area, unique_ptr_shapes)->Range(1 << 8, 1 << 16);
+
+/**
+ * Counts the shapes hit by each of a set of probe points (a broad-phase bounding box test followed by an exact test)
+ */
+template< typename Storage > static void BM_shapesWorkload_collision(benchmark::State &state) {
+	const auto scene                  = make_scene< Storage >(static_cast< std::size_t >(state.range(0)));
+	const std::vector< Point > probes = make_probes(64);
+
+	perf_counters counters;
+	counters.start();
+
+	for (auto _ : state) {
+		std::size_t hits = 0;
+		for (const Point &probe : probes) {
+			for (const auto &shape : scene) {
+				hits += Storage::invoke(shape, [probe](const auto &s) {
+					return s.bounds().contains(probe) && s.contains(probe);
+				});
+			}
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	const auto tests = static_cast< std::int64_t >(probes.size()) * state.range(0);
+	counters.stop();
+	counters.report(state, tests);
+	state.SetItemsProcessed(state.iterations() * tests);
+}
+
+BENCHMARK_TEMPLATE(BM_shapesWorkload_collision, pv_shapes)->Range(1 << 8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_shapesWorkload_collision, std_variant_shapes)->Range(1 << 8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_shapesWorkload_collision, unique_ptr_shapes)->Range(1 << 8, 1 << 12);
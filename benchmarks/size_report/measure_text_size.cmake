@@ -0,0 +1,41 @@
+# Use of this source code is governed by a BSD-style license that can
+# be found in the LICENSE file at the root of the source tree or at
+# <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+# Prints the size of the .text section per polymorphic_variant instantiation for every given mode.
+#
+# Usage:
+#   cmake -DSIZE_TOOL=<path> -DINSTANTIATIONS=<n> -DMODES=<mode>,<mode>,...
+#         -D<mode>_SINGLE=<binary with 1 instantiation> -D<mode>_MULTIPLE=<binary with n instantiations>
+#         -P measure_text_size.cmake
+
+function(text_size FILE RESULT_VAR)
+	execute_process(
+		COMMAND "${SIZE_TOOL}" -A "${FILE}"
+		OUTPUT_VARIABLE OUTPUT
+		RESULT_VARIABLE RESULT
+	)
+	if (NOT RESULT EQUAL 0)
+		message(FATAL_ERROR "Failed to determine section sizes of \"${FILE}\"")
+	endif()
+
+	if (NOT OUTPUT MATCHES "\n\\.text[ \t]+([0-9]+)")
+		message(FATAL_ERROR "\"${FILE}\" doesn't contain a .text section")
+	endif()
+
+	set(${RESULT_VAR} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "," ";" MODES "${MODES}")
+math(EXPR ADDITIONAL_INSTANTIATIONS "${INSTANTIATIONS} - 1")
+
+message("Size of .text per polymorphic_variant instantiation (with 4 alternatives):")
+
+foreach(MODE IN LISTS MODES)
+	text_size("${${MODE}_SINGLE}" SINGLE_SIZE)
+	text_size("${${MODE}_MULTIPLE}" MULTIPLE_SIZE)
+
+	math(EXPR PER_INSTANTIATION "(${MULTIPLE_SIZE} - ${SINGLE_SIZE}) / ${ADDITIONAL_INSTANTIATIONS}")
+
+	message("  ${MODE}: ${PER_INSTANTIATION} bytes (total .text with ${INSTANTIATIONS} instantiations: ${MULTIPLE_SIZE} bytes)")
+endforeach()
@@ -0,0 +1,118 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+// Instantiates polymorphic_variant PV_SIZE_REPORT_INSTANTIATIONS times (with distinct types) and uses every
+// instantiation in the same way. Comparing the code size of builds with different instantiation counts yields the code
+// size caused by a single instantiation.
+
+#include <pv/polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <utility>
+
+#ifndef PV_SIZE_REPORT_INSTANTIATIONS
+#	define PV_SIZE_REPORT_INSTANTIATIONS 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define SIZE_REPORT_NOINLINE __attribute__((noinline))
+#else
+#	define SIZE_REPORT_NOINLINE
+#endif
+
+// The amount of separate functions accessing the stored object of every instantiation
+constexpr std::size_t access_sites = 8;
+
+template< std::size_t I > class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual int area() const = 0;
+};
+
+// Some of the types inherit from this class first, so that the Shape subobject is located at different offsets in
+// different types (as is common with multiple inheritance). This prevents the compiler from folding the dispatch on the
+// stored type into a constant offset.
+class Labelled {
+public:
+	virtual ~Labelled() = default;
+
+	const char *label = "";
+};
+
+template< std::size_t I > class Square : public Shape< I > {
+public:
+	int side = 2;
+
+	int area() const override { return side * side; }
+};
+
+template< std::size_t I > class Rectangle : public Labelled, public Shape< I > {
+public:
+	int width  = 2;
+	int height = 3;
+
+	int area() const override { return width * height; }
+};
+
+template< std::size_t I > class Triangle : public Shape< I > {
+public:
+	int base   = 4;
+	int height = 3;
+
+	int area() const override { return base * height / 2; }
+};
+
+template< std::size_t I > class Circle : public Labelled, public Shape< I > {
+public:
+	int radius = 1;
+
+	int area() const override { return 3 * radius * radius; }
+};
+
+template< std::size_t I >
+using shape_variant = pv::polymorphic_variant< Shape< I >, Square< I >, Rectangle< I >, Triangle< I >, Circle< I > >;
+
+/**
+ * Stands in for a function somewhere in a larger program that accesses a variant via its base-class interface
+ */
+template< std::size_t I, std::size_t Site > SIZE_REPORT_NOINLINE int access(const shape_variant< I > &shape) {
+	return shape->area() + static_cast< int >(Site);
+}
+
+template< std::size_t I, std::size_t... Sites >
+int access_all(const shape_variant< I > &shape, std::index_sequence< Sites... >) {
+	return (access< I, Sites >(shape) + ...);
+}
+
+template< std::size_t I > int exercise(int selector) {
+	shape_variant< I > shape;
+
+	switch (selector % 4) {
+		case 1:
+			shape = Rectangle< I >{};
+			break;
+		case 2:
+			shape.template emplace< Triangle< I > >();
+			break;
+		case 3:
+			shape = shape_variant< I >(Circle< I >{});
+			break;
+	}
+
+	shape_variant< I > copy = shape;
+	copy.swap(shape);
+
+	const shape_variant< I > &const_ref = copy;
+
+	return shape->area() + const_ref.get().area() + access_all(const_ref, std::make_index_sequence< access_sites >{});
+}
+
+template< std::size_t... Instances > int exercise_all(int selector, std::index_sequence< Instances... >) {
+	return (exercise< Instances >(selector) + ...);
+}
+
+int main(int argc, char **) {
+	return exercise_all(argc, std::make_index_sequence< PV_SIZE_REPORT_INSTANTIATIONS >{}) == 0 ? 0 : 1;
+}
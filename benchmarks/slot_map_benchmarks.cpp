@@ -0,0 +1,182 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/algorithm.hpp>
+#include <pv/slot_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+class Entity {
+public:
+	virtual ~Entity() = default;
+
+	virtual double speed() const = 0;
+};
+
+class Vehicle final : public Entity {
+public:
+	double velocity;
+	double mass;
+
+	Vehicle(double v, double m) : velocity(v), mass(m) {}
+
+	double speed() const override { return velocity; }
+};
+
+class Pedestrian final : public Entity {
+public:
+	double pace;
+
+	Pedestrian(double p) : pace(p) {}
+
+	double speed() const override { return pace; }
+};
+
+using entity_variant = pv::polymorphic_variant< Entity, Vehicle, Pedestrian >;
+
+// Both implementations expose the same interface, so that the benchmarks below are identical for both of them
+
+class slot_map_entities {
+public:
+	using id = pv::slot_handle< Entity >;
+
+	id add(std::size_t i) {
+		if (i % 4 == 0) {
+			return m_map.emplace< Vehicle >(static_cast< double >(i), 1000.0);
+		}
+
+		return m_map.emplace< Pedestrian >(static_cast< double >(i % 7));
+	}
+
+	void remove(id entity) { m_map.erase(entity); }
+
+	const Entity *find(id entity) const {
+		const entity_variant *variant = m_map.find(entity);
+		return variant ? &variant->get() : nullptr;
+	}
+
+	template< typename Function > void for_each(Function function) const { pv::for_each(m_map, function); }
+
+private:
+	pv::slot_map< Entity, Vehicle, Pedestrian > m_map;
+};
+
+class unordered_map_entities {
+public:
+	using id = std::uint64_t;
+
+	id add(std::size_t i) {
+		const id entity = m_next_id++;
+		if (i % 4 == 0) {
+			m_map.emplace(entity, entity_variant(Vehicle(static_cast< double >(i), 1000.0)));
+		} else {
+			m_map.emplace(entity, entity_variant(Pedestrian(static_cast< double >(i % 7))));
+		}
+
+		return entity;
+	}
+
+	void remove(id entity) { m_map.erase(entity); }
+
+	const Entity *find(id entity) const {
+		auto it = m_map.find(entity);
+		return it != m_map.end() ? &it->second.get() : nullptr;
+	}
+
+	template< typename Function > void for_each(Function function) const {
+		for (const auto &current : m_map) {
+			pv::visit(function, current.second);
+		}
+	}
+
+private:
+	std::unordered_map< id, entity_variant > m_map;
+	id m_next_id = 0;
+};
+
+/**
+ * Populates the given entities and erases every third one again (in random order), so that the storage has the holes
+ * that a long-running entity system accumulates
+ *
+ * @returns The IDs of the remaining entities (in random order)
+ */
+template< typename Entities > std::vector< typename Entities::id > populate(Entities &entities, std::size_t count) {
+	std::vector< typename Entities::id > ids;
+	for (std::size_t i = 0; i < count; ++i) {
+		ids.push_back(entities.add(i));
+	}
+
+	std::mt19937 rng(42);
+	std::shuffle(ids.begin(), ids.end(), rng);
+
+	const std::size_t erased = ids.size() / 3;
+	for (std::size_t i = 0; i < erased; ++i) {
+		entities.remove(ids[i]);
+	}
+	ids.erase(ids.begin(), ids.begin() + static_cast< std::ptrdiff_t >(erased));
+
+	return ids;
+}
+
+template< typename Entities > void BM_entities_insertErase(benchmark::State &state) {
+	const std::size_t count = static_cast< std::size_t >(state.range(0));
+
+	for (auto _ : state) {
+		Entities entities;
+		benchmark::DoNotOptimize(populate(entities, count));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template< typename Entities > void BM_entities_lookup(benchmark::State &state) {
+	Entities entities;
+	const auto ids = populate(entities, static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		double total = 0;
+		for (const auto &entity : ids) {
+			total += entities.find(entity)->speed();
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(ids.size()));
+}
+
+template< typename Entities > void BM_entities_iterate(benchmark::State &state) {
+	Entities entities;
+	const auto ids = populate(entities, static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		double total = 0;
+		entities.for_each([&total](const auto &entity) { total += entity.speed(); });
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(ids.size()));
+}
+
+constexpr int entities_begin = 1 << 10;
+constexpr int entities_end   = 1 << 18;
+
+BENCHMARK(BM_entities_insertErase< slot_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+BENCHMARK(BM_entities_insertErase< unordered_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+BENCHMARK(BM_entities_lookup< slot_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+BENCHMARK(BM_entities_lookup< unordered_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+BENCHMARK(BM_entities_iterate< slot_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+BENCHMARK(BM_entities_iterate< unordered_map_entities >)->RangeMultiplier(16)->Range(entities_begin, entities_end);
+
+} // namespace
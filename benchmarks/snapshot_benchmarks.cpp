@@ -0,0 +1,184 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/snapshot.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef PV_SNAPSHOT_SUPPORTED
+
+namespace {
+
+class Particle {
+public:
+	virtual ~Particle() = default;
+
+	virtual double energy() const = 0;
+};
+
+class Electron : public Particle {
+public:
+	double velocity = 0;
+
+	Electron() = default;
+	Electron(double v) : velocity(v) {}
+
+	double energy() const override { return velocity * velocity; }
+};
+
+class Nucleus : public Particle {
+public:
+	std::int32_t protons  = 0;
+	std::int32_t neutrons = 0;
+	float velocity        = 0;
+
+	Nucleus() = default;
+	Nucleus(std::int32_t p, std::int32_t n, float v) : protons(p), neutrons(n), velocity(v) {}
+
+	double energy() const override { return (protons + neutrons) * static_cast< double >(velocity * velocity); }
+};
+
+} // namespace
+
+template<> struct pv::snapshot_relocatable< Electron > : std::true_type {};
+template<> struct pv::snapshot_relocatable< Nucleus > : std::true_type {};
+
+namespace {
+
+using particle_variant = pv::polymorphic_variant< Particle, Electron, Nucleus >;
+using particle_snapshot = pv::mapped_snapshot< Particle, Electron, Nucleus >;
+
+std::vector< particle_variant > make_particles(std::size_t count) {
+	std::vector< particle_variant > particles;
+	particles.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (i % 3 == 0) {
+			particles.emplace_back(Nucleus(static_cast< std::int32_t >(i % 92), static_cast< std::int32_t >(i % 140),
+										   static_cast< float >(i % 7)));
+		} else {
+			particles.emplace_back(Electron(static_cast< double >(i % 13)));
+		}
+	}
+
+	return particles;
+}
+
+template< typename T > void write_value(std::ofstream &stream, const T &value) {
+	stream.write(reinterpret_cast< const char * >(&value), sizeof(value));
+}
+
+template< typename T > T read_value(std::ifstream &stream) {
+	T value;
+	stream.read(reinterpret_cast< char * >(&value), sizeof(value));
+	return value;
+}
+
+/**
+ * Writes the particles as a conventional serialized stream (type tag followed by the fields of every element)
+ */
+void write_stream(const std::string &path, const std::vector< particle_variant > &particles) {
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	write_value< std::uint64_t >(stream, particles.size());
+
+	for (const particle_variant &particle : particles) {
+		write_value< std::uint8_t >(stream, static_cast< std::uint8_t >(particle.index()));
+
+		particle.visit([&stream](const auto &value) {
+			if constexpr (std::is_same_v< std::decay_t< decltype(value) >, Electron >) {
+				write_value(stream, value.velocity);
+			} else {
+				write_value(stream, value.protons);
+				write_value(stream, value.neutrons);
+				write_value(stream, value.velocity);
+			}
+		});
+	}
+}
+
+std::vector< particle_variant > read_stream(const std::string &path) {
+	std::ifstream stream(path, std::ios::binary);
+	const auto count = static_cast< std::size_t >(read_value< std::uint64_t >(stream));
+
+	std::vector< particle_variant > particles;
+	particles.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (read_value< std::uint8_t >(stream) == 0) {
+			particles.emplace_back(Electron(read_value< double >(stream)));
+		} else {
+			const auto protons  = read_value< std::int32_t >(stream);
+			const auto neutrons = read_value< std::int32_t >(stream);
+			particles.emplace_back(Nucleus(protons, neutrons, read_value< float >(stream)));
+		}
+	}
+
+	return particles;
+}
+
+template< typename Container > double total_energy(const Container &particles) {
+	double total = 0;
+	for (const particle_variant &particle : particles) {
+		total += particle->energy();
+	}
+
+	return total;
+}
+
+std::string benchmark_file(const std::string &kind, std::size_t count) {
+	const std::string name = "pv_" + kind + "_benchmark_" + std::to_string(count) + ".bin";
+
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+/**
+ * Startup cost of rebuilding all elements from a serialized stream, followed by a first pass over the elements
+ */
+static void BM_startup_deserializeStream(benchmark::State &state) {
+	const auto count       = static_cast< std::size_t >(state.range(0));
+	const std::string path = benchmark_file("stream", count);
+	write_stream(path, make_particles(count));
+
+	for (auto _ : state) {
+		const std::vector< particle_variant > particles = read_stream(path);
+		benchmark::DoNotOptimize(total_energy(particles));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_startup_deserializeStream)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Startup cost of mapping a snapshot (restoring the vtable pointers in place), followed by a first pass over the
+ * elements
+ */
+static void BM_startup_mapSnapshot(benchmark::State &state) {
+	const auto count       = static_cast< std::size_t >(state.range(0));
+	const std::string path = benchmark_file("snapshot", count);
+	pv::write_snapshot(path, make_particles(count));
+
+	for (auto _ : state) {
+		const particle_snapshot particles(path);
+		benchmark::DoNotOptimize(total_energy(particles));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_startup_mapSnapshot)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMicrosecond);
+
+#endif // PV_SNAPSHOT_SUPPORTED
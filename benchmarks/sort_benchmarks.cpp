@@ -0,0 +1,104 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/algorithm.hpp>
+#include <pv/polymorphic_variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "benchmark_classes.hpp"
+
+// Makes polymorphic_variant< Animal, ... > comparable via its operator< (a virtual call per comparison)
+bool operator<(const Animal &lhs, const Animal &rhs) {
+	return lhs.get_member() < rhs.get_member();
+}
+
+namespace {
+
+using animal_variant = pv::polymorphic_variant< Animal, Dog, Cat >;
+
+// Compares two objects of the same concrete type without a virtual call
+const auto compare_members = [](const auto &lhs, const auto &rhs) {
+	return lhs.member < rhs.member;
+};
+
+std::vector< animal_variant > make_animals(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< animal_variant > animals;
+	animals.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		const int member = static_cast< int >(rng() % count);
+
+		if (rng() % 2 == 0) {
+			animals.emplace_back(Dog(member));
+		} else {
+			animals.emplace_back(Cat(member));
+		}
+	}
+
+	return animals;
+}
+
+template< typename Sort > void run_sort_benchmark(benchmark::State &state, Sort sort) {
+	const std::vector< animal_variant > prototype = make_animals(static_cast< std::size_t >(state.range(0)));
+	std::vector< animal_variant > animals;
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		animals = prototype;
+		state.ResumeTiming();
+
+		sort(animals);
+
+		benchmark::DoNotOptimize(animals.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Sorting via polymorphic_variant::operator< (which orders by value only, interleaving the types)
+void BM_sort_operatorLess(benchmark::State &state) {
+	run_sort_benchmark(state,
+					   [](std::vector< animal_variant > &animals) { std::sort(animals.begin(), animals.end()); });
+}
+
+// Type-major order via std::sort (a dispatch on the type of one of the operands per comparison)
+void BM_sort_typeMajorLess(benchmark::State &state) {
+	run_sort_benchmark(state, [](std::vector< animal_variant > &animals) {
+		std::sort(animals.begin(), animals.end(), pv::type_major_less< decltype(compare_members) >{ compare_members });
+	});
+}
+
+void BM_sort_partitionByType(benchmark::State &state) {
+	run_sort_benchmark(state, [](std::vector< animal_variant > &animals) {
+		benchmark::DoNotOptimize(pv::partition_by_type(animals));
+	});
+}
+
+void BM_sort_sortByType(benchmark::State &state) {
+	run_sort_benchmark(state,
+					   [](std::vector< animal_variant > &animals) { pv::sort_by_type(animals, compare_members); });
+}
+
+// Only computes the sorting permutation (the elements aren't moved)
+void BM_sort_sortPermutationByType(benchmark::State &state) {
+	run_sort_benchmark(state, [](std::vector< animal_variant > &animals) {
+		benchmark::DoNotOptimize(pv::sort_permutation_by_type(animals, compare_members).data());
+	});
+}
+
+BENCHMARK(BM_sort_operatorLess)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+BENCHMARK(BM_sort_typeMajorLess)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+BENCHMARK(BM_sort_partitionByType)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+BENCHMARK(BM_sort_sortByType)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+BENCHMARK(BM_sort_sortPermutationByType)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+} // namespace
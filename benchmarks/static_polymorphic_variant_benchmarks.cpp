@@ -0,0 +1,108 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/polymorphic_variant.hpp>
+#include <pv/static_polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The same two shapes, once with a virtual base class and once without any virtual functions
+
+class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual float area() const = 0;
+};
+
+class VirtualCircle final : public Shape {
+public:
+	float radius;
+
+	VirtualCircle(float r) : radius(r) {}
+
+	float area() const override { return 3.14159f * radius * radius; }
+};
+
+class VirtualRectangle final : public Shape {
+public:
+	float width;
+	float height;
+
+	VirtualRectangle(float w, float h) : width(w), height(h) {}
+
+	float area() const override { return width * height; }
+};
+
+struct Circle {
+	float radius;
+
+	Circle(float r) : radius(r) {}
+
+	float area() const { return 3.14159f * radius * radius; }
+};
+
+struct Rectangle {
+	float width;
+	float height;
+
+	Rectangle(float w, float h) : width(w), height(h) {}
+
+	float area() const { return width * height; }
+};
+
+template< typename Self > struct ShapeInterface : pv::static_interface< Self > {
+	PV_INTERFACE_FUNCTION(area)
+};
+
+using virtual_shape = pv::polymorphic_variant< Shape, VirtualCircle, VirtualRectangle >;
+using static_shape  = pv::static_polymorphic_variant< ShapeInterface, Circle, Rectangle >;
+
+template< typename Variant, typename CircleType, typename RectangleType >
+std::vector< Variant > make_shapes(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< Variant > shapes;
+	shapes.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		const float size = static_cast< float >(rng() % 100) / 10;
+		if (rng() % 2 == 0) {
+			shapes.emplace_back(CircleType(size));
+		} else {
+			shapes.emplace_back(RectangleType(size, size + 1));
+		}
+	}
+
+	return shapes;
+}
+
+template< typename Variant, typename CircleType, typename RectangleType >
+void BM_totalArea(benchmark::State &state) {
+	const std::vector< Variant > shapes =
+		make_shapes< Variant, CircleType, RectangleType >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		float total = 0;
+		for (const Variant &shape : shapes) {
+			total += shape->area();
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["bytes/elem"] = static_cast< double >(sizeof(Variant));
+}
+
+BENCHMARK(BM_totalArea< virtual_shape, VirtualCircle, VirtualRectangle >)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_totalArea< static_shape, Circle, Rectangle >)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+} // namespace
@@ -0,0 +1,146 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include "allocation_counters.hpp"
+
+#include <pv/algorithm.hpp>
+#include <pv/static_vector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Force {
+public:
+	virtual ~Force() = default;
+
+	virtual double apply(double mass) const = 0;
+};
+
+class Gravity final : public Force {
+public:
+	double g;
+
+	Gravity(double value) : g(value) {}
+
+	double apply(double mass) const override { return mass * g; }
+};
+
+class Drag final : public Force {
+public:
+	double coefficient;
+	double velocity;
+
+	Drag(double c, double v) : coefficient(c), velocity(v) {}
+
+	double apply(double) const override { return -coefficient * velocity * velocity; }
+};
+
+// Same as Drag, but not declared to be trivially relocatable
+class OpaqueDrag final : public Force {
+public:
+	double coefficient;
+	double velocity;
+
+	OpaqueDrag(double c, double v) : coefficient(c), velocity(v) {}
+
+	double apply(double) const override { return -coefficient * velocity * velocity; }
+};
+
+} // namespace
+
+template<> struct pv::trivially_relocatable< Gravity > : std::true_type {};
+template<> struct pv::trivially_relocatable< Drag > : std::true_type {};
+
+namespace {
+
+constexpr std::size_t max_forces = 32;
+
+using force_variant = pv::polymorphic_variant< Force, Gravity, Drag >;
+
+template< typename Container > void fill(Container &forces, std::size_t count) {
+	for (std::size_t i = 0; i < count; ++i) {
+		if (i % 3 == 0) {
+			forces.template emplace_back< Gravity >(9.81);
+		} else {
+			forces.template emplace_back< Drag >(0.5, static_cast< double >(i));
+		}
+	}
+}
+
+struct std_vector_forces {
+	std::vector< force_variant > forces;
+
+	std_vector_forces(std::size_t count) { forces.reserve(count); }
+
+	template< typename T, typename... Args > void emplace_back(Args &&... args) {
+		forces.emplace_back(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+	}
+};
+
+struct static_vector_forces {
+	pv::static_vector< Force, max_forces, Gravity, Drag > forces;
+
+	static_vector_forces(std::size_t) {}
+
+	template< typename T, typename... Args > void emplace_back(Args &&... args) {
+		forces.template emplace_back< T >(std::forward< Args >(args)...);
+	}
+};
+
+// A short-lived collection of a few elements (e.g. the forces acting on a single body in a simulation step) that is
+// built, evaluated and destroyed again
+template< typename Collection > void BM_smallCollection(benchmark::State &state) {
+	const std::size_t count = static_cast< std::size_t >(state.range(0));
+
+	allocation_counters allocations;
+	allocations.start();
+
+	for (auto _ : state) {
+		Collection collection(count);
+		fill(collection, count);
+
+		double total = 0;
+		pv::for_each(collection.forces, [&total](const auto &force) { total += force.apply(2.0); });
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	allocations.stop();
+	allocations.report(state);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_smallCollection< std_vector_forces >)->RangeMultiplier(2)->Range(4, max_forces);
+BENCHMARK(BM_smallCollection< static_vector_forces >)->RangeMultiplier(2)->Range(4, max_forces);
+
+// Moving a full static_vector either relocates all elements via a single memcpy or moves them one by one
+template< typename Relocated > void BM_staticVector_move(benchmark::State &state) {
+	using vector = pv::static_vector< Force, max_forces, Gravity, Relocated >;
+
+	vector source;
+	for (std::size_t i = 0; i < max_forces; ++i) {
+		source.template emplace_back< Relocated >(0.5, static_cast< double >(i));
+	}
+
+	for (auto _ : state) {
+		vector target(std::move(source));
+		benchmark::DoNotOptimize(target.data());
+		source = std::move(target);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(2 * max_forces));
+}
+
+BENCHMARK(BM_staticVector_move< Drag >);
+BENCHMARK(BM_staticVector_move< OpaqueDrag >);
+
+} // namespace
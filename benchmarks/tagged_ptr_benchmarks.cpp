@@ -0,0 +1,84 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/tagged_ptr.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark_classes.hpp"
+
+namespace {
+
+using animal_ptr = pv::tagged_ptr< Animal, Dog, Cat >;
+
+template< typename Pointer > std::vector< Pointer > make_animals(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< Pointer > animals;
+	animals.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (rng() % 2 == 0) {
+			animals.push_back(Pointer(new Dog(static_cast< int >(i))));
+		} else {
+			animals.push_back(Pointer(new Cat(static_cast< int >(i))));
+		}
+	}
+
+	return animals;
+}
+
+template<> std::vector< animal_ptr > make_animals< animal_ptr >(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< animal_ptr > animals;
+	animals.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (rng() % 2 == 0) {
+			animals.emplace_back(std::in_place_type_t< Dog >{}, static_cast< int >(i));
+		} else {
+			animals.emplace_back(std::in_place_type_t< Cat >{}, static_cast< int >(i));
+		}
+	}
+
+	return animals;
+}
+
+// Counts the cats among heap-allocated animals. With a unique_ptr, this requires dereferencing every pointer (for
+// dynamic_cast), whereas a tagged_ptr knows the type of the pointed-to object without touching it.
+void BM_taggedPtr_countType_uniquePtr(benchmark::State &state) {
+	const std::vector< std::unique_ptr< Animal > > animals =
+		make_animals< std::unique_ptr< Animal > >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(std::count_if(animals.begin(), animals.end(), [](const auto &animal) {
+			return dynamic_cast< const Cat * >(animal.get()) != nullptr;
+		}));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_taggedPtr_countType_taggedPtr(benchmark::State &state) {
+	const std::vector< animal_ptr > animals = make_animals< animal_ptr >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(std::count_if(animals.begin(), animals.end(), [](const animal_ptr &animal) {
+			return animal.holds_alternative< Cat >();
+		}));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_taggedPtr_countType_uniquePtr)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK(BM_taggedPtr_countType_taggedPtr)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+
+} // namespace
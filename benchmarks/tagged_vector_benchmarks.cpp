@@ -0,0 +1,97 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/tagged_vector.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_classes.hpp"
+
+namespace {
+
+using variant_type   = pv::polymorphic_variant< Animal, Dog, Cat >;
+using tagged_animals = pv::tagged_vector< Animal, Dog, Cat >;
+
+template< typename Container > Container make_animals(std::size_t size) {
+	std::mt19937 rng(42);
+	std::bernoulli_distribution is_cat(0.25);
+
+	Container animals;
+	animals.reserve(size);
+	for (std::size_t i = 0; i < size; ++i) {
+		if (is_cat(rng)) {
+			animals.template emplace_back< Cat >(static_cast< int >(i));
+		} else {
+			animals.template emplace_back< Dog >(static_cast< int >(i));
+		}
+	}
+
+	return animals;
+}
+
+struct plain_vector : std::vector< variant_type > {
+	template< typename T > void emplace_back(int arg) { std::vector< variant_type >::emplace_back(T(arg)); }
+};
+
+} // namespace
+
+static void BM_countType_tagIndex(benchmark::State &state) {
+	const auto animals = make_animals< tagged_animals >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(animals.count_if_type< Cat >());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_countType_tagIndex)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_countType_dynamicCast(benchmark::State &state) {
+	const auto animals = make_animals< plain_vector >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(std::count_if(animals.begin(), animals.end(), [](const variant_type &animal) {
+			return dynamic_cast< const Cat * >(&animal.get()) != nullptr;
+		}));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_countType_dynamicCast)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_positionsOfType_tagIndex(benchmark::State &state) {
+	const auto animals = make_animals< tagged_animals >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(animals.positions_of_type< Cat >());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_positionsOfType_tagIndex)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_positionsOfType_dynamicCast(benchmark::State &state) {
+	const auto animals = make_animals< plain_vector >(static_cast< std::size_t >(state.range(0)));
+
+	for (auto _ : state) {
+		std::vector< std::size_t > positions;
+		for (std::size_t i = 0; i < animals.size(); ++i) {
+			if (dynamic_cast< const Cat * >(&animals[i].get())) {
+				positions.push_back(i);
+			}
+		}
+		benchmark::DoNotOptimize(positions);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_positionsOfType_dynamicCast)->RangeMultiplier(8)->Range(64, 1 << 18);
@@ -0,0 +1,159 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/polymorphic_variant.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+class Message {
+public:
+	virtual ~Message() = default;
+
+	virtual int priority() const = 0;
+};
+
+class Request : public Message {
+public:
+	int id;
+
+	Request(int i) : id(i) {}
+
+	int priority() const override { return 1; }
+};
+
+// Derives from Request, so that dynamic_cast< Request * > has to walk the hierarchy for it
+class UrgentRequest final : public Request {
+public:
+	UrgentRequest(int i) : Request(i) {}
+
+	int priority() const override { return 2; }
+};
+
+class Response final : public Message {
+public:
+	int status;
+
+	Response(int s) : status(s) {}
+
+	int priority() const override { return 0; }
+};
+
+class Heartbeat final : public Message {
+public:
+	int priority() const override { return 0; }
+};
+
+using message_variant = pv::polymorphic_variant< Message, Request, UrgentRequest, Response, Heartbeat >;
+
+std::vector< message_variant > make_messages(std::size_t count) {
+	std::mt19937 rng(42);
+	std::vector< message_variant > messages;
+	messages.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		switch (rng() % 4) {
+			case 0:
+				messages.emplace_back(Request(static_cast< int >(i)));
+				break;
+			case 1:
+				messages.emplace_back(UrgentRequest(static_cast< int >(i)));
+				break;
+			case 2:
+				messages.emplace_back(Response(200));
+				break;
+			default:
+				messages.emplace_back(Heartbeat());
+				break;
+		}
+	}
+
+	return messages;
+}
+
+constexpr std::size_t message_count = 1 << 14;
+
+// Sums the status of all responses by downcasting via dynamic_cast
+void BM_typedAccess_dynamicCast(benchmark::State &state) {
+	const std::vector< message_variant > messages = make_messages(message_count);
+
+	for (auto _ : state) {
+		int total = 0;
+		for (const message_variant &message : messages) {
+			if (const Response *response = dynamic_cast< const Response * >(&message.get())) {
+				total += response->status;
+			}
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(message_count));
+}
+BENCHMARK(BM_typedAccess_dynamicCast);
+
+// Sums the status of all responses by accessing them via get_if (which only compares the type index)
+void BM_typedAccess_getIf(benchmark::State &state) {
+	const std::vector< message_variant > messages = make_messages(message_count);
+
+	for (auto _ : state) {
+		int total = 0;
+		for (const message_variant &message : messages) {
+			if (const Response *response = pv::get_if< Response >(&message)) {
+				total += response->status;
+			}
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(message_count));
+}
+BENCHMARK(BM_typedAccess_getIf);
+
+// Counts the messages that are a Request (including derived types), which requires dynamic_cast to walk the hierarchy
+void BM_typedAccess_dynamicCastToIntermediate(benchmark::State &state) {
+	const std::vector< message_variant > messages = make_messages(message_count);
+
+	for (auto _ : state) {
+		std::size_t requests = 0;
+		for (const message_variant &message : messages) {
+			if (dynamic_cast< const Request * >(&message.get())) {
+				++requests;
+			}
+		}
+
+		benchmark::DoNotOptimize(requests);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(message_count));
+}
+BENCHMARK(BM_typedAccess_dynamicCastToIntermediate);
+
+// Same as above, but checks the type index via holds_alternative
+void BM_typedAccess_holdsAlternative(benchmark::State &state) {
+	const std::vector< message_variant > messages = make_messages(message_count);
+
+	for (auto _ : state) {
+		std::size_t requests = 0;
+		for (const message_variant &message : messages) {
+			if (message.holds_alternative< Request >() || message.holds_alternative< UrgentRequest >()) {
+				++requests;
+			}
+		}
+
+		benchmark::DoNotOptimize(requests);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(message_count));
+}
+BENCHMARK(BM_typedAccess_holdsAlternative);
+
+} // namespace
@@ -0,0 +1,105 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <benchmark/benchmark.h>
+
+#include <pv/pv.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+template< std::size_t I > struct Operation {
+	int factor = static_cast< int >(I) + 1;
+
+	int apply(int value) const { return value * factor + static_cast< int >(I); }
+};
+
+template< typename Sequence > struct operation_variant;
+template< std::size_t... I > struct operation_variant< std::index_sequence< I... > > {
+	using type = std::variant< Operation< I >... >;
+};
+
+template< std::size_t Alternatives >
+using operation_variant_t = typename operation_variant< std::make_index_sequence< Alternatives > >::type;
+
+template< std::size_t Alternatives, std::size_t... I >
+operation_variant_t< Alternatives > make_operation(std::size_t index, std::index_sequence< I... >) {
+	operation_variant_t< Alternatives > operation;
+	((index == I ? static_cast< void >(operation.template emplace< I >()) : static_cast< void >(0)), ...);
+
+	return operation;
+}
+
+/**
+ * Creates a sequence of operations whose types are either shuffled randomly (so that the dispatch is dominated by
+ * branch mispredictions) or grouped by type (so that the branch predictor can predict the dispatch and the cost of the
+ * dispatch code itself becomes visible)
+ */
+template< std::size_t Alternatives >
+std::vector< operation_variant_t< Alternatives > > make_operations(bool grouped) {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution< std::size_t > dist(0, Alternatives - 1);
+
+	std::vector< std::size_t > indices(4096);
+	for (std::size_t &index : indices) {
+		index = dist(rng);
+	}
+	if (grouped) {
+		std::sort(indices.begin(), indices.end());
+	}
+
+	std::vector< operation_variant_t< Alternatives > > operations;
+	for (std::size_t index : indices) {
+		operations.push_back(make_operation< Alternatives >(index, std::make_index_sequence< Alternatives >{}));
+	}
+
+	return operations;
+}
+
+} // namespace
+
+template< std::size_t Alternatives > static void BM_visit_std(benchmark::State &state) {
+	const auto operations = make_operations< Alternatives >(state.range(0) != 0);
+
+	for (auto _ : state) {
+		int value = 0;
+		for (const auto &operation : operations) {
+			value = std::visit([value](const auto &op) { return op.apply(value); }, operation);
+		}
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(operations.size()));
+}
+
+BENCHMARK(BM_visit_std< 2 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_std< 8 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_std< 32 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_std< 64 >)->ArgName("grouped")->Arg(0)->Arg(1);
+
+template< std::size_t Alternatives > static void BM_visit_switch(benchmark::State &state) {
+	const auto operations = make_operations< Alternatives >(state.range(0) != 0);
+
+	for (auto _ : state) {
+		int value = 0;
+		for (const auto &operation : operations) {
+			value = pv::visit([value](const auto &op) { return op.apply(value); }, operation);
+		}
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations() * static_cast< std::int64_t >(operations.size()));
+}
+
+BENCHMARK(BM_visit_switch< 2 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_switch< 8 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_switch< 32 >)->ArgName("grouped")->Arg(0)->Arg(1);
+BENCHMARK(BM_visit_switch< 64 >)->ArgName("grouped")->Arg(0)->Arg(1);
@@ -0,0 +1,63 @@
+//  Use of this source code is governed by a BSD-style license that can
+//  be found in the LICENSE file at the root of the source tree or at
+//  <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_BENCHMARKS_WORKLOAD_STORAGE_HPP__
+#define PV_BENCHMARKS_WORKLOAD_STORAGE_HPP__
+
+#include <pv/pv.hpp>
+
+#include <memory>
+#include <utility>
+#include <variant>
+
+// The workload benchmarks implement every workload once in terms of a Storage policy, which determines how the objects
+// of a closed set of types (all derived from Base) are stored and how their member functions are invoked. All policies
+// operate on the very same (final) classes.
+
+/**
+ * Stores objects in a polymorphic_variant and calls their member functions virtually via the base class
+ */
+template< typename Base, typename... Types > struct polymorphic_variant_storage {
+	using element_type = pv::polymorphic_variant< Base, Types... >;
+
+	template< typename T, typename... Args > static element_type make(Args &&... args) {
+		return element_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+	}
+
+	template< typename Function > static decltype(auto) invoke(const element_type &element, Function &&function) {
+		return std::forward< Function >(function)(element.get());
+	}
+};
+
+/**
+ * Stores objects in a std::variant and calls their member functions on the concrete type via std::visit
+ */
+template< typename Base, typename... Types > struct std_variant_storage {
+	using element_type = std::variant< Types... >;
+
+	template< typename T, typename... Args > static element_type make(Args &&... args) {
+		return element_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+	}
+
+	template< typename Function > static decltype(auto) invoke(const element_type &element, Function &&function) {
+		return std::visit(std::forward< Function >(function), element);
+	}
+};
+
+/**
+ * Stores objects on the heap and calls their member functions virtually via the base class
+ */
+template< typename Base, typename... Types > struct unique_ptr_storage {
+	using element_type = std::unique_ptr< Base >;
+
+	template< typename T, typename... Args > static element_type make(Args &&... args) {
+		return std::make_unique< T >(std::forward< Args >(args)...);
+	}
+
+	template< typename Function > static decltype(auto) invoke(const element_type &element, Function &&function) {
+		return std::forward< Function >(function)(*element);
+	}
+};
+
+#endif // PV_BENCHMARKS_WORKLOAD_STORAGE_HPP__
@@ -0,0 +1,341 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_ALGORITHM_HPP_
+#define PV_ALGORITHM_HPP_
+
+#include "pv/pv.hpp"
+#include "pv/static_polymorphic_variant.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Algorithms over ranges of polymorphic_variant (as well as static_polymorphic_variant or std::variant) objects.
+// Instead of accessing the elements via the base class, the given function is invoked with every element as its
+// concrete type (see pv::visit), so that calls made from within the function can be devirtualized.
+
+namespace pv::details {
+
+/**
+ * Invokes the given function with every element of the given range
+ *
+ * @returns The function
+ */
+template< typename Range, typename Function > Function for_each(Range &&range, Function function) {
+	for (auto &&element : range) {
+		details::visit(function, element);
+	}
+
+	return function;
+}
+
+/**
+ * @returns An iterator to the first element of the given range for which the given predicate returns true (or the
+ * range's end iterator, if there is no such element)
+ */
+template< typename Range, typename Predicate > auto find_if(Range &&range, Predicate predicate) {
+	auto it        = std::begin(range);
+	const auto end = std::end(range);
+
+	for (; it != end; ++it) {
+		if (details::visit(predicate, *it)) {
+			break;
+		}
+	}
+
+	return it;
+}
+
+/**
+ * @returns The amount of elements in the given range for which the given predicate returns true
+ */
+template< typename Range, typename Predicate > std::size_t count_if(Range &&range, Predicate predicate) {
+	std::size_t count = 0;
+	for (auto &&element : range) {
+		if (details::visit(predicate, element)) {
+			++count;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * The std::variant underlying the given variant type (polymorphic_variant, static_polymorphic_variant or std::variant
+ * itself)
+ */
+template< typename Variant, typename = void > struct underlying_variant { using type = Variant; };
+template< typename Variant > struct underlying_variant< Variant, std::void_t< typename Variant::variant_type > > {
+	using type = typename Variant::variant_type;
+};
+template< typename Variant > using underlying_variant_t = typename underlying_variant< Variant >::type;
+
+template< typename Variant >
+constexpr std::size_t alternative_count_v = std::variant_size_v< underlying_variant_t< Variant > >;
+
+template< typename Range >
+using range_element_t = std::remove_cv_t< std::remove_reference_t< decltype(*std::begin(std::declval< Range & >())) > >;
+
+/**
+ * The group offsets of N alternatives are stored in an array of N + 2 elements: the elements holding the alternative
+ * with index I are located at [offsets[I], offsets[I + 1]) and the valueless ones at [offsets[N], offsets[N + 1]).
+ */
+template< typename Variant > using type_group_offsets = std::array< std::size_t, alternative_count_v< Variant > + 2 >;
+
+/**
+ * @returns The group of the given variant in a type-major order (the index of the stored type, with valueless
+ * variants forming the last group)
+ */
+template< typename Variant > constexpr std::size_t type_group(const Variant &variant) noexcept {
+	return std::min(variant.index(), alternative_count_v< Variant >);
+}
+
+/**
+ * @returns The object stored in the given variant, which must hold the alternative with the given index (no checks are
+ * performed)
+ */
+template< std::size_t Index, typename Variant > const auto &get_alternative(const Variant &variant) noexcept {
+	if constexpr (std::is_same_v< Variant, underlying_variant_t< Variant > >) {
+		return *std::get_if< Index >(&variant);
+	} else {
+		return *variant.template get_if< std::variant_alternative_t< Index, underlying_variant_t< Variant > > >();
+	}
+}
+
+/**
+ * Invokes the given function with std::integral_constant< std::size_t, I > for every I in the given sequence
+ */
+template< std::size_t... Indices, typename Function >
+void for_each_alternative(std::index_sequence< Indices... >, Function &&function) {
+	(function(std::integral_constant< std::size_t, Indices >{}), ...);
+}
+
+/**
+ * @returns The offsets of the type groups (see type_group_offsets) if the given elements were ordered type-major
+ */
+template< typename Variant, typename Iterator >
+type_group_offsets< Variant > count_type_groups(Iterator first, std::size_t size) {
+	type_group_offsets< Variant > offsets = {};
+
+	for (std::size_t i = 0; i < size; ++i) {
+		++offsets[type_group(first[static_cast< std::ptrdiff_t >(i)]) + 1];
+	}
+
+	for (std::size_t group = 1; group < offsets.size(); ++group) {
+		offsets[group] += offsets[group - 1];
+	}
+
+	return offsets;
+}
+
+/**
+ * Three-way comparison ordering variants type-major: first by the index of their stored type (valueless variants
+ * last) and then, for variants storing the same type, by comparing the stored objects as their concrete type via the
+ * given comparison. Unlike operator<, this doesn't require a virtual call (or a dispatch on both operands) per
+ * comparison.
+ *
+ * @returns A negative value, if lhs is ordered before rhs, a positive value if it is ordered after it and zero if they
+ * are equivalent
+ */
+template< typename Variant, typename Compare = std::less<> >
+int type_major_compare(const Variant &lhs, const Variant &rhs, Compare compare = {}) {
+	constexpr std::size_t count = alternative_count_v< Variant >;
+
+	const std::size_t lhs_group = type_group(lhs);
+	const std::size_t rhs_group = type_group(rhs);
+
+	if (lhs_group != rhs_group) {
+		return lhs_group < rhs_group ? -1 : 1;
+	}
+	if (lhs_group == count) {
+		return 0;
+	}
+
+	return switch_index< count >(lhs_group, [&](auto index) {
+		const auto &lhs_object = get_alternative< decltype(index)::value >(lhs);
+		const auto &rhs_object = get_alternative< decltype(index)::value >(rhs);
+
+		if (compare(lhs_object, rhs_object)) {
+			return -1;
+		}
+
+		return compare(rhs_object, lhs_object) ? 1 : 0;
+	});
+}
+
+/**
+ * Function object implementing a strict weak ordering based on type_major_compare (e.g. for std::sort or std::map)
+ */
+template< typename Compare = std::less<> > struct type_major_less {
+	Compare compare = {};
+
+	template< typename Variant > bool operator()(const Variant &lhs, const Variant &rhs) const {
+		return type_major_compare(lhs, rhs, compare) < 0;
+	}
+};
+
+/**
+ * Reorders the elements of the given random-access range such that they are grouped by the index of their stored
+ * type in ascending order (valueless elements last). This requires counting the types and a single bucketing pass
+ * that swaps every element at most once into its group. The relative order of the elements within a group is not
+ * preserved.
+ *
+ * @returns The offsets of the groups (see type_group_offsets)
+ */
+template< typename Range > auto partition_by_type(Range &&range) {
+	using variant_type = range_element_t< Range >;
+
+	const auto first       = std::begin(range);
+	const std::size_t size = static_cast< std::size_t >(std::distance(first, std::end(range)));
+
+	const type_group_offsets< variant_type > offsets = count_type_groups< variant_type >(first, size);
+
+	// Position of the next element to be placed in every group
+	type_group_offsets< variant_type > next = offsets;
+
+	for (std::size_t group = 0; group + 1 < offsets.size(); ++group) {
+		while (next[group] < offsets[group + 1]) {
+			auto &element            = first[static_cast< std::ptrdiff_t >(next[group])];
+			const std::size_t target = type_group(element);
+
+			if (target != group) {
+				element.swap(first[static_cast< std::ptrdiff_t >(next[target])]);
+			}
+
+			++next[target];
+		}
+	}
+
+	return offsets;
+}
+
+/**
+ * Sorts the elements of the given random-access range type-major (see type_major_compare): the elements are first
+ * grouped by their stored type (see partition_by_type) and every group is then sorted by comparing the stored objects
+ * as their concrete type via the given comparison, without any dispatch on the stored type.
+ */
+template< typename Range, typename Compare = std::less<> > void sort_by_type(Range &&range, Compare compare = {}) {
+	using variant_type = range_element_t< Range >;
+
+	const auto first                                 = std::begin(range);
+	const type_group_offsets< variant_type > offsets = partition_by_type(range);
+
+	for_each_alternative(std::make_index_sequence< alternative_count_v< variant_type > >{}, [&](auto index) {
+		constexpr std::size_t group = decltype(index)::value;
+
+		std::sort(first + static_cast< std::ptrdiff_t >(offsets[group]),
+				  first + static_cast< std::ptrdiff_t >(offsets[group + 1]),
+				  [&compare](const variant_type &lhs, const variant_type &rhs) {
+					  return compare(get_alternative< group >(lhs), get_alternative< group >(rhs));
+				  });
+	});
+}
+
+/**
+ * Computes the permutation that sorts the elements of the given random-access range type-major (see sort_by_type)
+ * without moving any of them. The relative order of equivalent elements is unspecified.
+ *
+ * @returns The indices of the elements in sorted order
+ */
+template< typename Range, typename Compare = std::less<> >
+std::vector< std::size_t > sort_permutation_by_type(const Range &range, Compare compare = {}) {
+	using variant_type = range_element_t< const Range >;
+
+	const auto first       = std::begin(range);
+	const std::size_t size = static_cast< std::size_t >(std::distance(first, std::end(range)));
+
+	const type_group_offsets< variant_type > offsets = count_type_groups< variant_type >(first, size);
+	type_group_offsets< variant_type > next          = offsets;
+
+	std::vector< std::size_t > permutation(size);
+	for (std::size_t i = 0; i < size; ++i) {
+		permutation[next[type_group(first[static_cast< std::ptrdiff_t >(i)])]++] = i;
+	}
+
+	for_each_alternative(std::make_index_sequence< alternative_count_v< variant_type > >{}, [&](auto index) {
+		constexpr std::size_t group = decltype(index)::value;
+
+		std::sort(permutation.begin() + static_cast< std::ptrdiff_t >(offsets[group]),
+				  permutation.begin() + static_cast< std::ptrdiff_t >(offsets[group + 1]),
+				  [&compare, &first](std::size_t lhs, std::size_t rhs) {
+					  return compare(get_alternative< group >(first[static_cast< std::ptrdiff_t >(lhs)]),
+									 get_alternative< group >(first[static_cast< std::ptrdiff_t >(rhs)]));
+				  });
+	});
+
+	return permutation;
+}
+
+/**
+ * Makes sure that the given vector can hold the given amount of additional elements without reallocating. Other than
+ * calling reserve with the exact size, this keeps the geometric growth of the vector, so that appending many short runs
+ * doesn't reallocate for every run.
+ */
+template< typename Vector > void reserve_additional(Vector &vector, std::size_t count) {
+	const std::size_t required = vector.size() + count;
+
+	if (required > vector.capacity()) {
+		vector.reserve(std::max(required, 2 * vector.capacity()));
+	}
+}
+
+/**
+ * Appends an object of type T constructed from each element of [first, last) to the given vector. For forward
+ * iterators, the required capacity is reserved once up front. The objects are constructed in place, instead of
+ * constructing a temporary polymorphic_variant that is then moved into the vector.
+ */
+template< typename T, typename Base, typename... Types, typename Alloc, typename InputIt >
+void append_n(std::vector< polymorphic_variant< Base, Types... >, Alloc > &vector, InputIt first, InputIt last) {
+	using category = typename std::iterator_traits< InputIt >::iterator_category;
+
+	if constexpr (std::is_base_of_v< std::forward_iterator_tag, category >) {
+		reserve_additional(vector, static_cast< std::size_t >(std::distance(first, last)));
+	}
+
+	for (; first != last; ++first) {
+		vector.emplace_back(std::in_place_type_t< T >{}, *first);
+	}
+}
+
+/**
+ * Appends the given amount of objects of type T to the given vector, each of which is constructed from the result of
+ * calling the given generator. The required capacity is reserved once up front and the objects are constructed in
+ * place.
+ */
+template< typename T, typename Base, typename... Types, typename Alloc, typename Generator >
+void append_n(std::vector< polymorphic_variant< Base, Types... >, Alloc > &vector, std::size_t count,
+			  Generator generator) {
+	reserve_additional(vector, count);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		vector.emplace_back(std::in_place_type_t< T >{}, generator());
+	}
+}
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::append_n;
+	using details::count_if;
+	using details::find_if;
+	using details::for_each;
+	using details::partition_by_type;
+	using details::sort_by_type;
+	using details::sort_permutation_by_type;
+	using details::type_major_compare;
+	using details::type_major_less;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_ALGORITHM_HPP_
@@ -0,0 +1,275 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_BATCH_SCHEDULER_HPP_
+#define PV_BATCH_SCHEDULER_HPP_
+
+#include "pv/details/variadic_parameter_helper.hpp"
+#include "pv/pv.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pv::details {
+
+/**
+ * A scheduler for tasks that are represented as polymorphic_variant< Base, Types... >, where every task is executed by
+ * calling its run() function.
+ *
+ * Instead of executing tasks one after the other (which requires a virtual call per task and constantly switches
+ * between the code of the different task types), submitted tasks are sorted into one queue per task type and the
+ * worker threads always execute a batch of tasks of the same type. Within a batch, run() is invoked on the concrete
+ * type (via a qualified call), so that it is bound at compile time and can be inlined.
+ *
+ * Every worker has a preferred queue but steals work from the other queues once its own queue runs dry. Tasks of the
+ * same type are executed in the order in which they have been submitted, but no order is guaranteed between tasks of
+ * different types.
+ */
+template< typename Base, typename... Types > class batch_scheduler {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	/**
+	 * @param worker_count The amount of worker threads to use (at least one worker thread is always created)
+	 * @param max_batch_size The maximum amount of tasks that a worker takes out of a queue in one go
+	 */
+	explicit batch_scheduler(std::size_t worker_count = std::thread::hardware_concurrency(),
+							 std::size_t max_batch_size = 64)
+		: m_max_batch_size(std::max< std::size_t >(max_batch_size, 1)) {
+		worker_count = std::max< std::size_t >(worker_count, 1);
+
+		m_workers.reserve(worker_count);
+		try {
+			for (std::size_t i = 0; i < worker_count; ++i) {
+				m_workers.emplace_back([this, i]() { work(i); });
+			}
+		} catch (...) {
+			// Destroying joinable threads would terminate the program, so shut down the workers started so far
+			{
+				std::lock_guard< std::mutex > guard(m_state_mutex);
+				m_stop = true;
+			}
+			m_work_available.notify_all();
+
+			for (std::thread &worker : m_workers) {
+				worker.join();
+			}
+			throw;
+		}
+	}
+
+	batch_scheduler(const batch_scheduler &) = delete;
+	batch_scheduler &operator=(const batch_scheduler &) = delete;
+
+	/**
+	 * Waits for all submitted tasks to be executed before shutting down the worker threads
+	 */
+	~batch_scheduler() {
+		wait_for_completion();
+
+		{
+			std::lock_guard< std::mutex > guard(m_state_mutex);
+			m_stop = true;
+		}
+		m_work_available.notify_all();
+
+		for (std::thread &worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	/**
+	 * Submits a copy of the given task
+	 */
+	void submit(const value_type &task) {
+		task.visit([this](const auto &concrete) { enqueue< std::decay_t< decltype(concrete) > >(concrete); });
+	}
+
+	/**
+	 * Submits the given task
+	 */
+	void submit(value_type &&task) {
+		std::move(task).visit(
+			[this](auto &&concrete) { enqueue< std::decay_t< decltype(concrete) > >(std::move(concrete)); });
+	}
+
+	/**
+	 * Submits a task of type T that is constructed from the given arguments
+	 */
+	template< typename T, typename... Args > void emplace(Args &&... args) {
+		static_assert(index_of_type_v< T, Types... > < sizeof...(Types), "T must be one of Types");
+
+		enqueue< T >(std::forward< Args >(args)...);
+	}
+
+	/**
+	 * Blocks until all submitted tasks have been executed. If any of the tasks threw an exception, the first of these
+	 * exceptions is rethrown.
+	 */
+	void wait() {
+		wait_for_completion();
+
+		std::exception_ptr error;
+		{
+			std::lock_guard< std::mutex > guard(m_state_mutex);
+			std::swap(error, m_error);
+		}
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	std::size_t worker_count() const noexcept { return m_workers.size(); }
+
+private:
+	static constexpr std::size_t type_count = sizeof...(Types);
+
+	template< typename T > struct alignas(64) task_queue {
+		std::mutex mutex;
+		std::deque< T > tasks;
+	};
+
+	template< typename T, typename... Args > void enqueue(Args &&... args) {
+		constexpr std::size_t index = index_of_type_v< T, Types... >;
+
+		{
+			auto &queue = std::get< index >(m_queues);
+			std::lock_guard< std::mutex > guard(queue.mutex);
+
+			queue.tasks.emplace_back(std::forward< Args >(args)...);
+
+			// The counters have to be incremented before the queue's lock is released, or else a worker might finish
+			// the task before it has been accounted for
+			m_unfinished.fetch_add(1, std::memory_order_relaxed);
+			m_queued.fetch_add(1, std::memory_order_release);
+		}
+
+		{
+			// Locking the mutex ensures that workers can't miss the notification between checking for work and
+			// starting to wait
+			std::lock_guard< std::mutex > guard(m_state_mutex);
+		}
+		m_work_available.notify_one();
+	}
+
+	/**
+	 * Takes a batch of tasks out of the queue for the type at the given index and executes them
+	 *
+	 * @returns Whether any task has been executed
+	 */
+	template< std::size_t Index > bool run_batch() {
+		using task_type = std::tuple_element_t< Index, std::tuple< Types... > >;
+
+		auto &queue = std::get< Index >(m_queues);
+
+		std::vector< task_type > batch;
+		{
+			std::lock_guard< std::mutex > guard(queue.mutex);
+			if (queue.tasks.empty()) {
+				return false;
+			}
+
+			const std::size_t count = std::min(queue.tasks.size(), m_max_batch_size);
+			const auto end          = queue.tasks.begin() + static_cast< std::ptrdiff_t >(count);
+
+			batch.reserve(count);
+			batch.insert(batch.end(), std::make_move_iterator(queue.tasks.begin()), std::make_move_iterator(end));
+			queue.tasks.erase(queue.tasks.begin(), end);
+		}
+
+		m_queued.fetch_sub(batch.size(), std::memory_order_relaxed);
+
+		for (task_type &task : batch) {
+			try {
+				// The qualified call binds run() statically, even if it is a virtual function
+				task.task_type::run();
+			} catch (...) {
+				std::lock_guard< std::mutex > guard(m_state_mutex);
+				if (!m_error) {
+					m_error = std::current_exception();
+				}
+			}
+		}
+
+		if (m_unfinished.fetch_sub(batch.size(), std::memory_order_acq_rel) == batch.size()) {
+			std::lock_guard< std::mutex > guard(m_state_mutex);
+			m_all_done.notify_all();
+		}
+
+		return true;
+	}
+
+	template< std::size_t... Is > static constexpr auto make_batch_runners(std::index_sequence< Is... >) {
+		return std::array< bool (batch_scheduler::*)(), type_count >{ &batch_scheduler::run_batch< Is >... };
+	}
+
+	void work(std::size_t worker_index) {
+		constexpr auto runners = make_batch_runners(std::make_index_sequence< type_count >{});
+
+		// Spread the workers' preferred queues over all task types
+		const std::size_t home = worker_index % type_count;
+
+		while (true) {
+			bool did_work = false;
+			for (std::size_t i = 0; i < type_count && !did_work; ++i) {
+				did_work = (this->*runners[(home + i) % type_count])();
+			}
+
+			if (did_work) {
+				continue;
+			}
+
+			std::unique_lock< std::mutex > lock(m_state_mutex);
+			m_work_available.wait(lock,
+								  [this]() { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+
+			if (m_stop && m_queued.load(std::memory_order_acquire) == 0) {
+				return;
+			}
+		}
+	}
+
+	void wait_for_completion() {
+		std::unique_lock< std::mutex > lock(m_state_mutex);
+		m_all_done.wait(lock, [this]() { return m_unfinished.load(std::memory_order_acquire) == 0; });
+	}
+
+	const std::size_t m_max_batch_size;
+	std::tuple< task_queue< Types >... > m_queues;
+	// The amount of tasks that are waiting in a queue
+	std::atomic< std::size_t > m_queued = 0;
+	// The amount of tasks that have been submitted but haven't finished executing yet
+	std::atomic< std::size_t > m_unfinished = 0;
+	std::mutex m_state_mutex;
+	std::condition_variable m_work_available;
+	std::condition_variable m_all_done;
+	std::exception_ptr m_error;
+	bool m_stop = false;
+	std::vector< std::thread > m_workers;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::batch_scheduler;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_BATCH_SCHEDULER_HPP_
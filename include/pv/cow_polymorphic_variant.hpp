@@ -0,0 +1,230 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_COW_POLYMORPHIC_VARIANT_HPP_
+#define PV_COW_POLYMORPHIC_VARIANT_HPP_
+
+#include "pv/pv.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace pv::details {
+
+/**
+ * A copy-on-write wrapper around a polymorphic_variant. Copies of a cow_polymorphic_variant share a single,
+ * reference-counted instance of the wrapped polymorphic_variant, which makes copying cheap regardless of the size of
+ * the stored types. The shared instance is cloned when it is accessed through a non-const function while being shared.
+ *
+ * Read-only access via the const overloads of get() and operator-> (or via cget()) is a plain pointer dereference.
+ * Note that calling get() or operator-> on a non-const object counts as mutable access (and thus might clone the
+ * stored object), even if only const member functions are invoked on the result.
+ *
+ * The reference count is atomic (as for std::shared_ptr), so different copies can be used from different threads.
+ */
+template< typename Base, typename... Types > class cow_polymorphic_variant {
+public:
+	using variant_type = polymorphic_variant< Base, Types... >;
+	using base_type    = typename variant_type::base_type;
+
+private:
+	template< typename T >
+	static constexpr bool
+		is_wrapped_type = (std::is_same_v< std::remove_cv_t< std::remove_reference_t< T > >, Types > || ...);
+
+	template< typename T > using enable_if_wrapped_type = std::enable_if_t< is_wrapped_type< T > >;
+
+public:
+	cow_polymorphic_variant() : cow_polymorphic_variant(create()) {}
+
+	cow_polymorphic_variant(const cow_polymorphic_variant &other) noexcept
+		: m_block(other.m_block), m_base(other.m_base) {
+		m_block->references.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Moves the shared object out of the given instance. Afterwards, other may only be assigned to or destroyed.
+	 */
+	cow_polymorphic_variant(cow_polymorphic_variant &&other) noexcept
+		: m_block(std::exchange(other.m_block, nullptr)), m_base(std::exchange(other.m_base, nullptr)) {}
+
+	explicit cow_polymorphic_variant(const variant_type &value) : cow_polymorphic_variant(create(value)) {}
+
+	explicit cow_polymorphic_variant(variant_type &&value) : cow_polymorphic_variant(create(std::move(value))) {}
+
+	template< typename T, typename = enable_if_wrapped_type< T > >
+	cow_polymorphic_variant(T &&t) : cow_polymorphic_variant(create(std::forward< T >(t))) {}
+
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	explicit cow_polymorphic_variant(std::in_place_type_t< T > tag, Args &&... args)
+		: cow_polymorphic_variant(create(tag, std::forward< Args >(args)...)) {}
+
+	~cow_polymorphic_variant() { release(); }
+
+	cow_polymorphic_variant &operator=(const cow_polymorphic_variant &other) noexcept {
+		if (m_block != other.m_block) {
+			other.m_block->references.fetch_add(1, std::memory_order_relaxed);
+			release();
+
+			m_block = other.m_block;
+			m_base  = other.m_base;
+		}
+
+		return *this;
+	}
+
+	cow_polymorphic_variant &operator=(cow_polymorphic_variant &&other) noexcept {
+		if (this != &other) {
+			release();
+
+			m_block = std::exchange(other.m_block, nullptr);
+			m_base  = std::exchange(other.m_base, nullptr);
+		}
+
+		return *this;
+	}
+
+	template< typename T, typename = enable_if_wrapped_type< T > > cow_polymorphic_variant &operator=(T &&t) {
+		if (unique()) {
+			m_block->value = std::forward< T >(t);
+			m_base         = &m_block->value.get();
+		} else {
+			*this = cow_polymorphic_variant(create(std::forward< T >(t)));
+		}
+
+		return *this;
+	}
+
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > > T &emplace(Args &&... args) {
+		if (unique()) {
+			T &ref = m_block->value.template emplace< T >(std::forward< Args >(args)...);
+			m_base = &m_block->value.get();
+
+			return ref;
+		}
+
+		*this = cow_polymorphic_variant(create(std::in_place_type_t< T >{}, std::forward< Args >(args)...));
+
+		return static_cast< T & >(*m_base);
+	}
+
+	/**
+	 * Gets the stored value as a base-class reference for reading
+	 */
+	const Base &get() const noexcept {
+		assert(m_base);
+		return *m_base;
+	}
+
+	/**
+	 * Gets the stored value as a base-class reference for reading (even if this object is non-const)
+	 */
+	const Base &cget() const noexcept { return get(); }
+
+	/**
+	 * Gets the stored value as a mutable base-class reference. If the stored object is currently shared with other
+	 * instances, it is cloned first.
+	 */
+	Base &get() {
+		detach();
+		return *m_base;
+	}
+
+	const Base *operator->() const noexcept { return &get(); }
+
+	Base *operator->() { return &get(); }
+
+	operator const base_type &() const noexcept { return get(); }
+
+	/**
+	 * Gets the wrapped polymorphic_variant (for reading)
+	 */
+	const variant_type &variant() const noexcept {
+		assert(m_block);
+		return m_block->value;
+	}
+
+	std::size_t index() const noexcept { return variant().index(); }
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its (const) concrete type
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) const {
+		return variant().visit(std::forward< Visitor >(visitor));
+	}
+
+	/**
+	 * @returns The amount of instances sharing the stored object
+	 */
+	std::size_t use_count() const noexcept {
+		return m_block ? m_block->references.load(std::memory_order_acquire) : 0;
+	}
+
+	/**
+	 * @returns Whether this instance is the only one referring to the stored object
+	 */
+	bool unique() const noexcept { return use_count() == 1; }
+
+	/**
+	 * Ensures that this instance does not share its stored object with any other instance (cloning the object, if
+	 * necessary)
+	 */
+	void detach() {
+		assert(m_block);
+
+		if (!unique()) {
+			*this = cow_polymorphic_variant(create(m_block->value));
+		}
+	}
+
+	void swap(cow_polymorphic_variant &other) noexcept {
+		std::swap(m_block, other.m_block);
+		std::swap(m_base, other.m_base);
+	}
+
+private:
+	struct control_block {
+		std::atomic< std::size_t > references;
+		variant_type value;
+
+		template< typename... Args >
+		explicit control_block(Args &&... args) : references(1), value(std::forward< Args >(args)...) {}
+	};
+
+	explicit cow_polymorphic_variant(control_block *block) noexcept : m_block(block), m_base(&block->value.get()) {}
+
+	template< typename... Args > static control_block *create(Args &&... args) {
+		return new control_block(std::forward< Args >(args)...);
+	}
+
+	void release() noexcept {
+		if (m_block && m_block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete m_block;
+		}
+	}
+
+	control_block *m_block = nullptr;
+	// Cached pointer to the stored object (inside m_block) so that reading doesn't require any offset computations
+	Base *m_base = nullptr;
+};
+
+template< typename Base, typename... Types >
+void swap(cow_polymorphic_variant< Base, Types... > &lhs, cow_polymorphic_variant< Base, Types... > &rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::cow_polymorphic_variant;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_COW_POLYMORPHIC_VARIANT_HPP_
@@ -0,0 +1,17 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_CONCEPTS_HPP__
+#define PV_DETAILS_CONCEPTS_HPP__
+
+/**
+ * PV_USE_CONCEPTS is defined if the compiler supports C++20 concepts (and PV_DISABLE_CONCEPTS isn't defined). In that
+ * case, the operator overloads of polymorphic_variant are constrained via requires-clauses instead of via the
+ * SFINAE-based traits in has_operator.hpp, which is slightly cheaper to compile under C++20.
+ */
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L && !defined(PV_DISABLE_CONCEPTS)
+#	define PV_USE_CONCEPTS
+#endif
+
+#endif // PV_DETAILS_CONCEPTS_HPP__
@@ -5,10 +5,14 @@
 #ifndef PV_OPERATORSIMPL_HPP_
 #define PV_OPERATORSIMPL_HPP_
 
-#include "pv/details/has_operator.hpp"
+#include "pv/details/concepts.hpp"
+#ifndef PV_USE_CONCEPTS
+#	include "pv/details/has_operator.hpp"
+#endif
 #include "pv/details/polymorphic_variant_impl.hpp"
 
 #include <type_traits>
+#include <utility>
 
 namespace pv {
 
@@ -25,10 +29,14 @@ namespace {
 	template< typename Base, typename... Types >
 	constexpr bool is_polymorphic_variant_v< polymorphic_variant< Base, Types... > > = true;
 
+#ifdef PV_USE_CONCEPTS
+	template< typename T > concept polymorphic_variant_type = is_polymorphic_variant_v< T >;
+#else
 	template< typename T >
 	using enable_if_polymorphic_variant_t = std::enable_if_t< is_polymorphic_variant_v< T >, void >;
 	template< typename T >
 	using enable_if_not_polymorphic_variant_t = std::enable_if_t< !is_polymorphic_variant_v< T >, void >;
+#endif
 } // namespace
 
 ///////////////////////////////////////////////////////////////
@@ -73,6 +81,132 @@ namespace {
 	PV_PROCESS_OPERATOR(!, negation)    \
 	PV_PROCESS_OPERATOR(~, bitwise_negation)
 
+#ifdef PV_USE_CONCEPTS
+
+// Binary operators
+
+#define PV_PROCESS_OPERATOR(the_op, name)                                                                   \
+	template< polymorphic_variant_type Variant >                                                            \
+		requires requires(const typename Variant::base_type &lhs, const typename Variant::base_type &rhs) { \
+			lhs the_op rhs;                                                                                 \
+		}                                                                                                   \
+	decltype(auto) operator the_op(const Variant &lhs, const Variant &rhs) {                                \
+		return lhs.get() the_op rhs.get();                                                                  \
+	}                                                                                                       \
+	template< polymorphic_variant_type Variant, typename T >                                                \
+		requires(!polymorphic_variant_type< T >)                                                            \
+				&& requires(const typename Variant::base_type &lhs, const T &rhs) { lhs the_op rhs; }       \
+	decltype(auto) operator the_op(const Variant &lhs, const T &rhs) {                                      \
+		return lhs.get() the_op rhs;                                                                        \
+	}                                                                                                       \
+	template< polymorphic_variant_type Variant, typename T >                                                \
+		requires(!polymorphic_variant_type< T >)                                                            \
+				&& requires(const T &lhs, const typename Variant::base_type &rhs) { lhs the_op rhs; }       \
+	decltype(auto) operator the_op(const T &lhs, const Variant &rhs) {                                      \
+		return lhs the_op rhs.get();                                                                        \
+	}
+
+PV_BINARY_OPS
+
+#undef PV_PROCESS_OPERATOR
+
+// Binary mutating operators (plus the corresponding binary operators inferred from them, if requested via
+// infer_operator_overloads and if the base class doesn't provide the binary operator itself)
+
+#define PV_PROCESS_OPERATOR(the_op, name, base_op, base_name)                                                \
+	template< polymorphic_variant_type Variant >                                                             \
+		requires requires(typename Variant::base_type &lhs, const typename Variant::base_type &rhs) {        \
+			lhs the_op rhs;                                                                                  \
+		}                                                                                                    \
+	decltype(auto) operator the_op(Variant &lhs, const Variant &rhs) {                                       \
+		return lhs.get() the_op rhs.get();                                                                   \
+	}                                                                                                        \
+	template< polymorphic_variant_type Variant >                                                             \
+		requires infer_operator_overloads_v< typename Variant::base_type >                                   \
+				 && requires(typename Variant::base_type &lhs, const typename Variant::base_type &rhs) {     \
+						lhs the_op rhs;                                                                      \
+					}                                                                                        \
+				 && (!requires(const typename Variant::base_type &lhs, const typename Variant::base_type &rhs) { \
+						lhs base_op rhs;                                                                     \
+					})                                                                                       \
+	decltype(auto) operator base_op(Variant lhs, const Variant &rhs) {                                       \
+		lhs the_op rhs.get();                                                                                \
+		return lhs;                                                                                          \
+	}                                                                                                        \
+	template< polymorphic_variant_type Variant, typename T >                                                 \
+		requires(!polymorphic_variant_type< T >)                                                             \
+				&& requires(typename Variant::base_type &lhs, const T &rhs) { lhs the_op rhs; }              \
+	decltype(auto) operator the_op(Variant &lhs, const T &rhs) {                                             \
+		return lhs.get() the_op rhs;                                                                         \
+	}                                                                                                        \
+	template< polymorphic_variant_type Variant, typename T >                                                 \
+		requires(!polymorphic_variant_type< T >) && infer_operator_overloads_v< typename Variant::base_type > \
+				&& requires(typename Variant::base_type &lhs, const T &rhs) { lhs the_op rhs; }              \
+				&& (!requires(const typename Variant::base_type &lhs, const T &rhs) { lhs base_op rhs; })    \
+	decltype(auto) operator base_op(Variant lhs, const T &rhs) {                                             \
+		lhs the_op rhs;                                                                                      \
+		return lhs;                                                                                          \
+	}                                                                                                        \
+	template< polymorphic_variant_type Variant, typename T >                                                 \
+		requires(!polymorphic_variant_type< T >)                                                             \
+				&& requires(T &lhs, const typename Variant::base_type &rhs) { lhs the_op rhs; }              \
+	decltype(auto) operator the_op(T &lhs, const Variant &rhs) {                                             \
+		return lhs the_op rhs.get();                                                                         \
+	}                                                                                                        \
+	template< polymorphic_variant_type Variant, typename T >                                                 \
+		requires(!polymorphic_variant_type< T >) && infer_operator_overloads_v< typename Variant::base_type > \
+				&& requires(T &lhs, const typename Variant::base_type &rhs) { lhs the_op rhs; }              \
+				&& (!requires(const T &lhs, const typename Variant::base_type &rhs) { lhs base_op rhs; })    \
+	decltype(auto) operator base_op(T lhs, const Variant &rhs) {                                             \
+		lhs the_op rhs.get();                                                                                \
+		return lhs;                                                                                          \
+	}
+
+PV_BINARY_MUTATING_OPS
+
+#undef PV_PROCESS_OPERATOR
+
+// Unary operators
+
+#define PV_PROCESS_OPERATOR(the_op, name)                                                  \
+	template< polymorphic_variant_type Variant >                                           \
+		requires requires(const typename Variant::base_type &operand) { the_op operand; } \
+	decltype(auto) operator the_op(const Variant &variant) {                               \
+		return the_op variant.get();                                                       \
+	}
+
+PV_UNARY_OPS
+
+#undef PV_PROCESS_OPERATOR
+
+// Special operators
+
+template< polymorphic_variant_type Variant >
+	requires requires(typename Variant::base_type &operand) { ++operand; }
+decltype(auto) operator++(Variant &variant) {
+	return ++variant.get();
+}
+
+template< polymorphic_variant_type Variant >
+	requires requires(typename Variant::base_type &operand) { --operand; }
+decltype(auto) operator--(Variant &variant) {
+	return --variant.get();
+}
+
+template< polymorphic_variant_type Variant >
+	requires requires(typename Variant::base_type &operand) { operand++; }
+decltype(auto) operator++(Variant &variant, int) {
+	return variant.get()++;
+}
+
+template< polymorphic_variant_type Variant >
+	requires requires(typename Variant::base_type &operand) { operand--; }
+decltype(auto) operator--(Variant &variant, int) {
+	return variant.get()--;
+}
+
+#else
+
 // Binary operators
 
 #define PV_PROCESS_OPERATOR(the_op, name)                                                             \
@@ -129,7 +263,7 @@ PV_BINARY_OPS
 		typename = std::enable_if_t<                                                                                                                                                                                            \
 			infer_operator_overloads_v<                                                                                                                                                                                         \
 				typename Variant::                                                                                                                                                                                              \
-					base_type > && has_##name##_v< typename Variant::base_type &, const T & > && !has_##base_name##_v< const typename Variant::base_type, const T & > > >                                                       \
+					base_type > && has_##name##_v< typename Variant::base_type &, const T & > && !has_##base_name##_v< const typename Variant::base_type &, const T & > > >                                                     \
 	decltype(auto) operator base_op(Variant lhs, const T &rhs) {                                                                                                                                                                \
 		lhs the_op rhs;                                                                                                                                                                                                         \
 		return lhs;                                                                                                                                                                                                             \
@@ -146,7 +280,7 @@ PV_BINARY_OPS
 		typename = std::enable_if_t<                                                                                                                                                                                            \
 			infer_operator_overloads_v<                                                                                                                                                                                         \
 				typename Variant::                                                                                                                                                                                              \
-					base_type > && has_##name##_v< T &, const typename Variant::base_type & > && !has_##name##_v< const T &, const typename Variant::base_type & > > >                                                          \
+					base_type > && has_##name##_v< T &, const typename Variant::base_type & > && !has_##base_name##_v< const T &, const typename Variant::base_type & > > >                                                     \
 	decltype(auto) operator base_op(T lhs, const Variant &rhs) {                                                                                                                                                                \
 		lhs the_op rhs.get();                                                                                                                                                                                                   \
 		return lhs;                                                                                                                                                                                                             \
@@ -169,9 +303,6 @@ PV_BINARY_MUTATING_OPS
 PV_UNARY_OPS
 
 #undef PV_PROCESS_OPERATOR
-#undef PV_BINARY_OPS
-#undef PV_BINARY_MUTATING_OPS
-#undef PV_UNARY_OPS
 
 // Special operators
 
@@ -199,6 +330,12 @@ decltype(auto) operator--(Variant &variant, int) {
 	return variant.get()--;
 }
 
+#endif
+
+#undef PV_BINARY_OPS
+#undef PV_BINARY_MUTATING_OPS
+#undef PV_UNARY_OPS
+
 // subscript operator is implemented as member function (as is required)
 
 } // namespace pv::details
@@ -0,0 +1,99 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_ORDERED_VISIT_HPP__
+#define PV_DETAILS_ORDERED_VISIT_HPP__
+
+#include "pv/details/switch_visit.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define PV_LIKELY(x) __builtin_expect(!!(x), 1)
+#else
+#	define PV_LIKELY(x) (x)
+#endif
+
+namespace pv {
+
+/**
+ * Can be specialized for a polymorphic_variant instantiation in order to make visiting objects of that type test for
+ * the stored type in the given order (a std::index_sequence of indices into the variant's types, most frequent type
+ * first) before falling back to the regular dispatch for all types not listed. The first type is marked as likely.
+ * Specializations are typically generated from a runtime profile (see pv::dispatch_profile).
+ */
+template< typename Variant > struct dispatch_order { using type = std::index_sequence<>; };
+
+template< typename Variant > using dispatch_order_t = typename dispatch_order< Variant >::type;
+
+} // namespace pv
+
+namespace pv::details {
+
+template< typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > ordered_visit_chain(std::index_sequence<>, Visitor &&visitor,
+																 Variant &&variant) {
+	return storage_switch_visit(std::forward< Visitor >(visitor), std::forward< Variant >(variant));
+}
+
+template< std::size_t Current, std::size_t... Rest, typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > ordered_visit_chain(std::index_sequence< Current, Rest... >,
+																 Visitor &&visitor, Variant &&variant) {
+	if (variant.index() == Current) {
+		return std::invoke(std::forward< Visitor >(visitor), std::get< Current >(std::forward< Variant >(variant)));
+	}
+
+	return ordered_visit_chain(std::index_sequence< Rest... >{}, std::forward< Visitor >(visitor),
+							   std::forward< Variant >(variant));
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given std::variant, testing for the types in the given
+ * order first (expecting the first one to be the most likely) and dispatching via switch_visit otherwise
+ */
+template< typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > ordered_visit(std::index_sequence<>, Visitor &&visitor,
+														   Variant &&variant) {
+	return storage_switch_visit(std::forward< Visitor >(visitor), std::forward< Variant >(variant));
+}
+
+template< std::size_t Hot, std::size_t... Rest, typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > ordered_visit(std::index_sequence< Hot, Rest... >, Visitor &&visitor,
+														   Variant &&variant) {
+	static_assert(Hot < std::variant_size_v< std::remove_reference_t< Variant > >, "Invalid index in dispatch order");
+
+	if (PV_LIKELY(variant.index() == Hot)) {
+		return std::invoke(std::forward< Visitor >(visitor), std::get< Hot >(std::forward< Variant >(variant)));
+	}
+
+	return ordered_visit_chain(std::index_sequence< Rest... >{}, std::forward< Visitor >(visitor),
+							   std::forward< Variant >(variant));
+}
+
+/**
+ * Per-type hit counters of the dispatches performed for objects of type Variant (only maintained if
+ * PV_PROFILE_DISPATCH is defined)
+ */
+template< typename Variant, std::size_t Alternatives > struct dispatch_counters {
+	static inline std::array< std::atomic< std::uint64_t >, Alternatives > hits = {};
+
+	static void record(std::size_t index) noexcept {
+		if (index < Alternatives) {
+			hits[index].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+} // namespace pv::details
+
+#undef PV_LIKELY
+
+#endif // PV_DETAILS_ORDERED_VISIT_HPP__
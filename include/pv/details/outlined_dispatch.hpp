@@ -0,0 +1,40 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_OUTLINED_DISPATCH_HPP__
+#define PV_DETAILS_OUTLINED_DISPATCH_HPP__
+
+#include "pv/details/switch_visit.hpp"
+
+#include <variant>
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define PV_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#	define PV_NOINLINE __declspec(noinline)
+#else
+#	define PV_NOINLINE
+#endif
+
+namespace pv::details {
+
+/**
+ * Resolves the address of the object stored in a variant as a pointer to Target (which has to be a const-qualified
+ * base class of all of Types or const void) via a single out-of-line function per instantiation. All call sites share
+ * this function instead of each inlining its own dispatch code (as a direct use of switch_visit does), which trades a
+ * function call for a smaller code footprint. The error path for valueless variants is moved out of the way as well.
+ */
+template< typename Target, typename... Types > struct outlined_dispatch {
+	using variant_type = std::variant< Types... >;
+
+	PV_NOINLINE static Target *get(const variant_type &variant) {
+		return storage_switch_visit([](const auto &value) -> Target * { return &value; }, variant);
+	}
+};
+
+} // namespace pv::details
+
+#undef PV_NOINLINE
+
+#endif // PV_DETAILS_OUTLINED_DISPATCH_HPP__
@@ -5,15 +5,27 @@
 #ifndef PV_POLYMORPHICVARIANT_IMPL_HPP_
 #define PV_POLYMORPHICVARIANT_IMPL_HPP_
 
-#include "pv/details/has_operator.hpp"
+#include "pv/details/concepts.hpp"
+#ifndef PV_USE_CONCEPTS
+#	include "pv/details/has_operator.hpp"
+#endif
+#include "pv/details/ordered_visit.hpp"
+#include "pv/details/switch_visit.hpp"
+#include "pv/details/uses_allocator.hpp"
 
 #ifndef PV_USE_VISIT_ACCESS
 #	include "pv/details/storage_offset.hpp"
-#	include "pv/details/variadic_parameter_helper.hpp"
+#endif
+#include "pv/details/variadic_parameter_helper.hpp"
+#if defined(PV_USE_VISIT_ACCESS) && defined(PV_OUTLINED_DISPATCH)
+#	include "pv/details/outlined_dispatch.hpp"
 #endif
 
 #include <cassert>
 #include <initializer_list>
+#include <memory>
+#include <optional>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -47,6 +59,11 @@ private:
 
 	template< typename T > using enable_if_wrapped_type = std::enable_if_t< is_wrapped_type< T > >;
 
+	// Enables conversions from a polymorphic_variant with the same Base, whose types are a subset of Types
+	template< typename... Others >
+	using enable_if_widening = std::enable_if_t< !std::is_same_v< std::variant< Others... >, variant_type >
+												 && type_list< Others... >::template is_subset_of< Types... > >;
+
 public:
 	// Ensure that Types contains at least one type
 	static_assert(sizeof...(Types) > 0, "Must provide at least one explicit sub-type");
@@ -100,6 +117,99 @@ public:
 	{
 	}
 
+	// Constructor adopting the object stored in the given variant (which must not be valueless). The stored object is
+	// moved (not copied) into this polymorphic_variant. Throws std::bad_variant_access for a valueless variant, if
+	// polymorphic_variant assumes its variant to never be valueless (see never_valueless).
+	constexpr explicit polymorphic_variant(variant_type &&variant)
+		: m_variant(adopt(std::move(variant)))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< void, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Converting constructor from a polymorphic_variant whose types are a subset of Types. The stored object is copied
+	// directly into this object's storage.
+	template< typename... Others, typename = enable_if_widening< Others... > >
+	constexpr polymorphic_variant(const polymorphic_variant< Base, Others... > &other)
+		: m_variant(other.visit([](const auto &value) {
+			  return variant_type(std::in_place_type_t< std::decay_t< decltype(value) > >{}, value);
+		  }))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< void, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Converting constructor from a polymorphic_variant whose types are a subset of Types. The stored object is moved
+	// directly into this object's storage.
+	template< typename... Others, typename = enable_if_widening< Others... > >
+	constexpr polymorphic_variant(polymorphic_variant< Base, Others... > &&other)
+		: m_variant(std::move(other).visit([](auto &&value) {
+			  return variant_type(std::in_place_type_t< std::decay_t< decltype(value) > >{}, std::move(value));
+		  }))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< void, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Allocator-extended constructors: the stored object is created via uses-allocator construction, i.e. the allocator
+	// is passed on to it, if it uses an allocator (see std::uses_allocator). This is what allocator-aware containers
+	// (e.g. std::pmr::vector) use in order to propagate their allocator to their elements.
+
+	// Constructor default-constructing the first of Types
+	template< typename Alloc >
+	polymorphic_variant(std::allocator_arg_t, const Alloc &alloc)
+		: polymorphic_variant(std::allocator_arg, alloc,
+							  std::in_place_type_t< typename first_variadic_parameter< Types... >::type >{}) {}
+
+	// Constructor taking one of Types
+	template< typename Alloc, typename T, typename = enable_if_wrapped_type< T > >
+	polymorphic_variant(std::allocator_arg_t, const Alloc &alloc, T &&t)
+		: polymorphic_variant(std::allocator_arg, alloc, std::in_place_type_t< std::decay_t< T > >{},
+							  std::forward< T >(t)) {}
+
+	// Constructor creating one of Types in-place from given arguments
+	template< typename Alloc, typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	polymorphic_variant(std::allocator_arg_t, const Alloc &alloc, std::in_place_type_t< T >, Args &&... args)
+		: m_variant(make_variant_using_allocator< T >(alloc, std::forward< Args >(args)...))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< T, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Copy constructor
+	template< typename Alloc >
+	polymorphic_variant(std::allocator_arg_t, const Alloc &alloc, const self_type &other)
+		: m_variant(other.visit([&alloc](const auto &value) {
+			  return make_variant_using_allocator< std::decay_t< decltype(value) > >(alloc, value);
+		  }))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< void, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Move constructor
+	template< typename Alloc >
+	polymorphic_variant(std::allocator_arg_t, const Alloc &alloc, self_type &&other)
+		: m_variant(std::move(other).visit([&alloc](auto &&value) {
+			  return make_variant_using_allocator< std::decay_t< decltype(value) > >(alloc, std::move(value));
+		  }))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< void, Types... >::get(m_variant))
+#endif
+	{
+	}
+
 	~polymorphic_variant() = default;
 
 	// Custom functions
@@ -109,8 +219,10 @@ public:
 	 */
 	constexpr Base &get() noexcept {
 		assert(!m_variant.valueless_by_exception());
-#ifdef PV_USE_VISIT_ACCESS
-		return std::visit([](auto &&obj) -> base_type & { return obj; }, m_variant);
+#if defined(PV_USE_VISIT_ACCESS) && defined(PV_OUTLINED_DISPATCH)
+		return *const_cast< base_type * >(outlined_dispatch< const base_type, Types... >::get(m_variant));
+#elif defined(PV_USE_VISIT_ACCESS)
+		return storage_switch_visit([](auto &&obj) -> base_type & { return obj; }, m_variant);
 #else
 		assert(m_base_offset < sizeof(self_type));
 		return *reinterpret_cast< base_type * >(reinterpret_cast< unsigned char * >(this) + m_base_offset);
@@ -122,8 +234,10 @@ public:
 	 */
 	constexpr const Base &get() const noexcept {
 		assert(!m_variant.valueless_by_exception());
-#ifdef PV_USE_VISIT_ACCESS
-		return std::visit([](auto &&obj) -> const base_type & { return obj; }, m_variant);
+#if defined(PV_USE_VISIT_ACCESS) && defined(PV_OUTLINED_DISPATCH)
+		return *outlined_dispatch< const base_type, Types... >::get(m_variant);
+#elif defined(PV_USE_VISIT_ACCESS)
+		return storage_switch_visit([](auto &&obj) -> const base_type & { return obj; }, m_variant);
 #else
 		assert(m_base_offset < sizeof(self_type));
 		return *reinterpret_cast< const base_type * >(reinterpret_cast< const unsigned char * >(this) + m_base_offset);
@@ -140,6 +254,60 @@ public:
 	 */
 	constexpr const Base *operator->() const noexcept { return &get(); }
 
+	/**
+	 * Gets the zero-based index of the currently stored type within Types
+	 */
+	constexpr std::size_t index() const noexcept { return m_variant.index(); }
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type (instead of as a base-class
+	 * reference). This allows the compiler to devirtualize calls made from within the visitor.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) & {
+		return dispatch(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type (instead of as a base-class
+	 * reference). This allows the compiler to devirtualize calls made from within the visitor.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) const & {
+		return dispatch(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type (instead of as a base-class
+	 * reference). This allows the compiler to devirtualize calls made from within the visitor.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) && {
+		return dispatch(std::forward< Visitor >(visitor), std::move(m_variant));
+	}
+
+	/**
+	 * @returns Whether the currently stored object is of type T (a comparison of the type index - no RTTI involved)
+	 */
+	template< typename T > constexpr bool holds_alternative() const noexcept {
+		return std::holds_alternative< T >(m_variant);
+	}
+
+	/**
+	 * @returns A pointer to the currently stored object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > constexpr std::add_pointer_t< T > get_if() noexcept { return std::get_if< T >(&m_variant); }
+
+	/**
+	 * @returns A pointer to the currently stored object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > constexpr std::add_pointer_t< const T > get_if() const noexcept {
+		return std::get_if< T >(&m_variant);
+	}
+
+	/**
+	 * Moves the stored object into a std::variant (e.g. for handing it to code that operates on plain variants).
+	 * Afterwards, this object holds a moved-from object of the same type.
+	 */
+	constexpr variant_type release() && { return std::move(m_variant); }
+
 
 	// TODO: disable depending on copyability/movability of Base
 	// Delegating functions for that part of the variant interface that also directly makes sense for
@@ -159,8 +327,25 @@ public:
 	}
 
 
+	// Assigns the object stored in a polymorphic_variant whose types are a subset of Types
+	template< typename... Others, typename = enable_if_widening< Others... > >
+	polymorphic_variant &operator=(const polymorphic_variant< Base, Others... > &rhs) {
+		rhs.visit([this](const auto &value) { emplace< std::decay_t< decltype(value) > >(value); });
+
+		return *this;
+	}
+
+	// Assigns the object stored in a polymorphic_variant whose types are a subset of Types
+	template< typename... Others, typename = enable_if_widening< Others... > >
+	polymorphic_variant &operator=(polymorphic_variant< Base, Others... > &&rhs) {
+		std::move(rhs).visit([this](auto &&value) { emplace< std::decay_t< decltype(value) > >(std::move(value)); });
+
+		return *this;
+	}
+
+
 	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > > T &emplace(Args &&... args) {
-		T &ref = m_variant.template emplace< T >(args...);
+		T &ref = emplace_alternative< T >(std::forward< Args >(args)...);
 
 #ifndef PV_USE_VISIT_ACCESS
 		storage_offset< void, Types... >::update(m_base_offset, m_variant);
@@ -171,7 +356,26 @@ public:
 
 	template< typename T, typename U, typename... Args, typename = enable_if_wrapped_type< T > >
 	T &emplace(std::initializer_list< U > il, Args &&... args) {
-		T &ref = m_variant.template emplace< T >(std::forward< std::initializer_list< U > >(il), args...);
+		T &ref = emplace_alternative< T >(il, std::forward< Args >(args)...);
+
+#ifndef PV_USE_VISIT_ACCESS
+		storage_offset< void, Types... >::update(m_base_offset, m_variant);
+#endif
+
+		return ref;
+	}
+
+	/**
+	 * Replaces the stored object with an object of type T constructed from the given arguments via uses-allocator
+	 * construction with the given allocator
+	 */
+	template< typename T, typename Alloc, typename... Args, typename = enable_if_wrapped_type< T > >
+	T &emplace(std::allocator_arg_t, const Alloc &alloc, Args &&... args) {
+		T &ref = std::apply(
+			[this](auto &&... ctor_args) -> T & {
+				return emplace_alternative< T >(std::forward< decltype(ctor_args) >(ctor_args)...);
+			},
+			uses_allocator_construction_args< T >(alloc, std::forward< Args >(args)...));
 
 #ifndef PV_USE_VISIT_ACCESS
 		storage_offset< void, Types... >::update(m_base_offset, m_variant);
@@ -180,6 +384,24 @@ public:
 		return ref;
 	}
 
+	/**
+	 * Assigns the given object. If an object of the same type is currently stored, it is assigned to (and thus keeps
+	 * using its current allocator). Otherwise, the new object is created via uses-allocator construction with the given
+	 * allocator.
+	 */
+	template< typename Alloc, typename T, typename = enable_if_wrapped_type< T > >
+	polymorphic_variant &assign(std::allocator_arg_t, const Alloc &alloc, T &&t) {
+		using type = std::decay_t< T >;
+
+		if (type *current = std::get_if< type >(&m_variant)) {
+			*current = std::forward< T >(t);
+		} else {
+			emplace< type >(std::allocator_arg, alloc, std::forward< T >(t));
+		}
+
+		return *this;
+	}
+
 	void swap(polymorphic_variant &rhs) {
 		m_variant.swap(rhs.m_variant);
 #ifndef PV_USE_VISIT_ACCESS
@@ -191,6 +413,19 @@ public:
 
 	operator const base_type &() const { return get(); }
 
+#ifdef PV_USE_CONCEPTS
+	template< typename Index >
+		requires requires { std::declval< base_type >()[std::declval< Index >()]; }
+	auto operator[](Index &&idx) {
+		return get()[std::forward< Index >(idx)];
+	}
+
+	template< typename Index >
+		requires requires { std::declval< std::add_const_t< base_type > >()[std::declval< Index >()]; }
+	auto operator[](Index &&idx) const {
+		return get()[std::forward< Index >(idx)];
+	}
+#else
 	template< typename Index, typename = enable_if_has_subscript_t< base_type, Index > > auto operator[](Index &&idx) {
 		return get()[std::forward< Index >(idx)];
 	}
@@ -199,8 +434,56 @@ public:
 	auto operator[](Index &&idx) const {
 		return get()[std::forward< Index >(idx)];
 	}
+#endif
 
 private:
+	template< typename Visitor, typename Variant >
+	static constexpr decltype(auto) dispatch(Visitor &&visitor, Variant &&variant) {
+#ifdef PV_PROFILE_DISPATCH
+		dispatch_counters< self_type, sizeof...(Types) >::record(variant.index());
+#endif
+
+		return ordered_visit(dispatch_order_t< self_type >{}, std::forward< Visitor >(visitor),
+							 std::forward< Variant >(variant));
+	}
+
+	/**
+	 * Replaces the stored object with a T constructed from the given arguments. If the variant must never become
+	 * valueless (see never_valueless) and the construction might throw, the object is constructed into a temporary
+	 * first, so that an exception leaves the currently stored object untouched.
+	 */
+	template< typename T, typename... Args > T &emplace_alternative(Args &&... args) {
+		if constexpr (never_valueless_v< variant_type > && !std::is_nothrow_constructible_v< T, Args... >) {
+			T temporary(std::forward< Args >(args)...);
+			return m_variant.template emplace< T >(std::move(temporary));
+		} else {
+			return m_variant.template emplace< T >(std::forward< Args >(args)...);
+		}
+	}
+
+	/**
+	 * @returns The given variant, after making sure that it isn't valueless, if the valueless state is assumed to
+	 * never occur (see never_valueless)
+	 */
+	static constexpr variant_type &&adopt(variant_type &&variant) {
+		if constexpr (never_valueless_v< variant_type >) {
+			if (variant.valueless_by_exception()) {
+				throw std::bad_variant_access();
+			}
+		}
+
+		return std::move(variant);
+	}
+
+	template< typename T, typename Alloc, typename... Args >
+	static variant_type make_variant_using_allocator(const Alloc &alloc, Args &&... args) {
+		return std::apply(
+			[](auto &&... ctor_args) {
+				return variant_type(std::in_place_type_t< T >{}, std::forward< decltype(ctor_args) >(ctor_args)...);
+			},
+			uses_allocator_construction_args< T >(alloc, std::forward< Args >(args)...));
+	}
+
 	variant_type m_variant;
 #ifndef PV_USE_VISIT_ACCESS
 	std::size_t m_base_offset =
@@ -208,6 +491,176 @@ private:
 #endif
 };
 
+/**
+ * Invokes the given visitor with the object stored in the given polymorphic_variant as its concrete type
+ */
+template< typename Visitor, typename Base, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, polymorphic_variant< Base, Types... > &variant) {
+	return variant.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given polymorphic_variant as its concrete type
+ */
+template< typename Visitor, typename Base, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, const polymorphic_variant< Base, Types... > &variant) {
+	return variant.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given polymorphic_variant as its concrete type
+ */
+template< typename Visitor, typename Base, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, polymorphic_variant< Base, Types... > &&variant) {
+	return std::move(variant).visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * @returns Whether the object stored in the given polymorphic_variant is of type T
+ */
+template< typename T, typename Base, typename... Types >
+constexpr bool holds_alternative(const polymorphic_variant< Base, Types... > &variant) noexcept {
+	return variant.template holds_alternative< T >();
+}
+
+/**
+ * @returns A pointer to the object stored in the given polymorphic_variant, if it is of type T or nullptr otherwise
+ * (including if the given pointer is nullptr)
+ */
+template< typename T, typename Base, typename... Types >
+constexpr std::add_pointer_t< T > get_if(polymorphic_variant< Base, Types... > *variant) noexcept {
+	return variant ? variant->template get_if< T >() : nullptr;
+}
+
+/**
+ * @returns A pointer to the object stored in the given polymorphic_variant, if it is of type T or nullptr otherwise
+ * (including if the given pointer is nullptr)
+ */
+template< typename T, typename Base, typename... Types >
+constexpr std::add_pointer_t< const T > get_if(const polymorphic_variant< Base, Types... > *variant) noexcept {
+	return variant ? variant->template get_if< T >() : nullptr;
+}
+
+/**
+ * @returns The object stored in the given polymorphic_variant as a T
+ * @throws std::bad_variant_access, if the stored object is not of type T
+ */
+template< typename T, typename Base, typename... Types >
+constexpr T &get(polymorphic_variant< Base, Types... > &variant) {
+	if (T *value = variant.template get_if< T >()) {
+		return *value;
+	}
+
+	throw std::bad_variant_access();
+}
+
+/**
+ * @returns The object stored in the given polymorphic_variant as a T
+ * @throws std::bad_variant_access, if the stored object is not of type T
+ */
+template< typename T, typename Base, typename... Types >
+constexpr const T &get(const polymorphic_variant< Base, Types... > &variant) {
+	if (const T *value = variant.template get_if< T >()) {
+		return *value;
+	}
+
+	throw std::bad_variant_access();
+}
+
+/**
+ * @returns The object stored in the given polymorphic_variant as a T
+ * @throws std::bad_variant_access, if the stored object is not of type T
+ */
+template< typename T, typename Base, typename... Types >
+constexpr T &&get(polymorphic_variant< Base, Types... > &&variant) {
+	if (T *value = variant.template get_if< T >()) {
+		return std::move(*value);
+	}
+
+	throw std::bad_variant_access();
+}
+
+/**
+ * Converts the given polymorphic_variant into Target (a polymorphic_variant with the same Base but a different set of
+ * types), copying the stored object directly into the result's storage.
+ *
+ * @returns The converted object or std::nullopt, if Target can't hold the type of the stored object
+ */
+template< typename Target, typename Base, typename... Types >
+std::optional< Target > narrow(const polymorphic_variant< Base, Types... > &variant) {
+	static_assert(std::is_same_v< typename Target::base_type, std::decay_t< Base > >, "Target must have the same Base");
+
+	return variant.visit([](const auto &value) -> std::optional< Target > {
+		using type = std::decay_t< decltype(value) >;
+
+		if constexpr (std::is_constructible_v< Target, std::in_place_type_t< type >, const type & >) {
+			return std::optional< Target >(std::in_place, std::in_place_type_t< type >{}, value);
+		} else {
+			return std::nullopt;
+		}
+	});
+}
+
+/**
+ * Converts the given polymorphic_variant into Target (a polymorphic_variant with the same Base but a different set of
+ * types), moving the stored object directly into the result's storage. If the conversion fails, the given object is
+ * left untouched.
+ *
+ * @returns The converted object or std::nullopt, if Target can't hold the type of the stored object
+ */
+template< typename Target, typename Base, typename... Types >
+std::optional< Target > narrow(polymorphic_variant< Base, Types... > &&variant) {
+	static_assert(std::is_same_v< typename Target::base_type, std::decay_t< Base > >, "Target must have the same Base");
+
+	return std::move(variant).visit([](auto &&value) -> std::optional< Target > {
+		using type = std::decay_t< decltype(value) >;
+
+		if constexpr (std::is_constructible_v< Target, std::in_place_type_t< type >, type && >) {
+			return std::optional< Target >(std::in_place, std::in_place_type_t< type >{}, std::move(value));
+		} else {
+			return std::nullopt;
+		}
+	});
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given std::variant (a drop-in replacement for std::visit with
+ * a single variant that compiles to a switch statement instead of a table of function pointers)
+ */
+template< typename Visitor, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, std::variant< Types... > &variant) {
+	return switch_visit(std::forward< Visitor >(visitor), variant);
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given std::variant (a drop-in replacement for std::visit with
+ * a single variant that compiles to a switch statement instead of a table of function pointers)
+ */
+template< typename Visitor, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, const std::variant< Types... > &variant) {
+	return switch_visit(std::forward< Visitor >(visitor), variant);
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given std::variant (a drop-in replacement for std::visit with
+ * a single variant that compiles to a switch statement instead of a table of function pointers)
+ */
+template< typename Visitor, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, std::variant< Types... > &&variant) {
+	return switch_visit(std::forward< Visitor >(visitor), std::move(variant));
+}
+
 } // namespace pv::details
 
+namespace std {
+
+/**
+ * A polymorphic_variant uses an allocator, if any of the types it can hold does
+ */
+template< typename Base, typename... Types, typename Alloc >
+struct uses_allocator< pv::details::polymorphic_variant< Base, Types... >, Alloc >
+	: bool_constant< (uses_allocator_v< Types, Alloc > || ...) > {};
+
+} // namespace std
+
 #endif // PV_POLYMORPHICVARIANT_IMPL_HPP_
@@ -5,6 +5,12 @@
 #ifndef PV_DETAILS_STORAGE_PTR_HPP__
 #define PV_DETAILS_STORAGE_PTR_HPP__
 
+#ifdef PV_OUTLINED_DISPATCH
+#	include "pv/details/outlined_dispatch.hpp"
+#else
+#	include "pv/details/switch_visit.hpp"
+#endif
+
 #include <cassert>
 #include <type_traits>
 #include <variant>
@@ -26,8 +32,14 @@ template< typename ActiveType = void, typename... Types > struct storage_offset
 			offset = reinterpret_cast< const unsigned char * >(&std::get< ActiveType >(variant))
 					 - reinterpret_cast< const unsigned char * >(&variant);
 		} else {
-			offset = std::visit([](auto &&value) { return reinterpret_cast< const unsigned char * >(&value); }, variant)
+#ifdef PV_OUTLINED_DISPATCH
+			offset = static_cast< const unsigned char * >(outlined_dispatch< const void, Types... >::get(variant))
 					 - reinterpret_cast< const unsigned char * >(&variant);
+#else
+			offset = storage_switch_visit(
+						 [](auto &&value) { return reinterpret_cast< const unsigned char * >(&value); }, variant)
+					 - reinterpret_cast< const unsigned char * >(&variant);
+#endif
 		}
 
 		assert(offset >= 0);
@@ -0,0 +1,225 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_SWITCH_VISIT_HPP__
+#define PV_DETAILS_SWITCH_VISIT_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define PV_NOINLINE __attribute__((noinline))
+#	define PV_COLD __attribute__((cold))
+#elif defined(_MSC_VER)
+#	define PV_NOINLINE __declspec(noinline)
+#	define PV_COLD
+#else
+#	define PV_NOINLINE
+#	define PV_COLD
+#endif
+
+namespace pv::details {
+
+/**
+ * Out-of-line error path for accessing a variant that is valueless by exception
+ */
+[[noreturn]] PV_COLD PV_NOINLINE inline void throw_valueless_access() {
+	throw std::bad_variant_access();
+}
+
+[[noreturn]] inline void unreachable() {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_unreachable();
+#elif defined(_MSC_VER)
+	__assume(false);
+#else
+	std::abort();
+#endif
+}
+
+/**
+ * The result of invoking Visitor with the first alternative of Variant
+ */
+template< typename Visitor, typename Variant >
+using visit_result_t = std::invoke_result_t< Visitor, decltype(std::get< 0 >(std::declval< Variant >())) >;
+
+/**
+ * Whether invoking Visitor with any of the given argument types yields the same type
+ */
+template< typename Visitor, typename First, typename... Rest >
+constexpr bool same_invoke_result_v =
+	(std::is_same_v< std::invoke_result_t< Visitor, First >, std::invoke_result_t< Visitor, Rest > > && ...);
+
+template< typename Visitor, typename Variant, std::size_t First, typename Indices > struct consistent_visit_result;
+
+template< typename Visitor, typename Variant, std::size_t First, std::size_t... Indices >
+struct consistent_visit_result< Visitor, Variant, First, std::index_sequence< Indices... > >
+	: std::bool_constant<
+		  same_invoke_result_v< Visitor, decltype(std::get< First + Indices >(std::declval< Variant >()))... > > {};
+
+/**
+ * Whether invoking Visitor with any of the alternatives of Variant (starting at index First) yields the same type, as
+ * is required by std::visit
+ */
+template< typename Visitor, typename Variant, std::size_t First = 0 >
+constexpr bool consistent_visit_result_v = consistent_visit_result<
+	Visitor, Variant, First,
+	std::make_index_sequence< std::variant_size_v< std::remove_reference_t< Variant > > - First > >::value;
+
+// The amount of alternatives handled by a single switch statement
+constexpr std::size_t switch_visit_cases = 64;
+
+#define PV_SWITCH_VISIT_CASE(n)                                                                           \
+	case (n):                                                                                             \
+		if constexpr (Offset + (n) < alternatives) {                                                      \
+			return std::invoke(std::forward< Visitor >(visitor),                                          \
+							   std::get< Offset + (n) >(std::forward< Variant >(variant)));               \
+		} else {                                                                                          \
+			unreachable();                                                                                \
+		}
+#define PV_SWITCH_INDEX_CASE(n)                                                                           \
+	case (n):                                                                                             \
+		if constexpr (Offset + (n) < Count) {                                                             \
+			return std::invoke(std::forward< Visitor >(visitor),                                          \
+							   std::integral_constant< std::size_t, Offset + (n) >{});                    \
+		} else {                                                                                          \
+			unreachable();                                                                                \
+		}
+#define PV_SWITCH_CASES_4(CASE, n) \
+	CASE(n)                        \
+	CASE(n + 1)                    \
+	CASE(n + 2)                    \
+	CASE(n + 3)
+#define PV_SWITCH_CASES_16(CASE, n) \
+	PV_SWITCH_CASES_4(CASE, n)      \
+	PV_SWITCH_CASES_4(CASE, n + 4)  \
+	PV_SWITCH_CASES_4(CASE, n + 8)  \
+	PV_SWITCH_CASES_4(CASE, n + 12)
+
+template< std::size_t Offset, typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > switch_visit_from(Visitor &&visitor, Variant &&variant) {
+	constexpr std::size_t alternatives = std::variant_size_v< std::remove_reference_t< Variant > >;
+	static_assert(Offset != 0 || consistent_visit_result_v< Visitor, Variant >,
+				  "The visitor has to return the same type for all alternatives");
+
+	switch (variant.index() - Offset) {
+		PV_SWITCH_CASES_16(PV_SWITCH_VISIT_CASE, 0)
+		PV_SWITCH_CASES_16(PV_SWITCH_VISIT_CASE, 16)
+		PV_SWITCH_CASES_16(PV_SWITCH_VISIT_CASE, 32)
+		PV_SWITCH_CASES_16(PV_SWITCH_VISIT_CASE, 48)
+		default:
+			if constexpr (Offset + switch_visit_cases < alternatives) {
+				// Too many alternatives for a single switch -> continue with the next block of alternatives
+				return switch_visit_from< Offset + switch_visit_cases >(std::forward< Visitor >(visitor),
+																		 std::forward< Variant >(variant));
+			} else {
+				unreachable();
+			}
+	}
+}
+
+/**
+ * The result of invoking Visitor with the index 0 (as a std::integral_constant)
+ */
+template< typename Visitor >
+using switch_index_result_t = std::invoke_result_t< Visitor, std::integral_constant< std::size_t, 0 > >;
+
+template< typename Visitor, std::size_t... Indices >
+constexpr bool consistent_index_result(std::index_sequence< Indices... >) {
+	return same_invoke_result_v< Visitor, std::integral_constant< std::size_t, Indices >... >;
+}
+
+/**
+ * Invokes the given visitor with the given index (which must be smaller than Count) as a
+ * std::integral_constant< std::size_t, Index >. This is the equivalent of switch_visit for type indices that are
+ * stored outside of a std::variant.
+ */
+template< std::size_t Count, std::size_t Offset = 0, typename Visitor >
+constexpr switch_index_result_t< Visitor > switch_index(std::size_t index, Visitor &&visitor) {
+	static_assert(Offset != 0 || consistent_index_result< Visitor >(std::make_index_sequence< Count >{}),
+				  "The visitor has to return the same type for all indices");
+
+	switch (index - Offset) {
+		PV_SWITCH_CASES_16(PV_SWITCH_INDEX_CASE, 0)
+		PV_SWITCH_CASES_16(PV_SWITCH_INDEX_CASE, 16)
+		PV_SWITCH_CASES_16(PV_SWITCH_INDEX_CASE, 32)
+		PV_SWITCH_CASES_16(PV_SWITCH_INDEX_CASE, 48)
+		default:
+			if constexpr (Offset + switch_visit_cases < Count) {
+				return switch_index< Count, Offset + switch_visit_cases >(index, std::forward< Visitor >(visitor));
+			} else {
+				unreachable();
+			}
+	}
+}
+
+#undef PV_SWITCH_CASES_16
+#undef PV_SWITCH_CASES_4
+#undef PV_SWITCH_INDEX_CASE
+#undef PV_SWITCH_VISIT_CASE
+
+/**
+ * Invokes the given visitor with the object stored in the given std::variant. In contrast to std::visit (which
+ * common standard library implementations implement via a table of function pointers), this expands to a switch
+ * statement over the variant's index, which compilers can inline and optimize much more aggressively.
+ *
+ * Just like for std::visit, the visitor has to return the same type for all alternatives.
+ */
+template< typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > switch_visit(Visitor &&visitor, Variant &&variant) {
+	if (variant.valueless_by_exception()) {
+		throw_valueless_access();
+	}
+
+	return switch_visit_from< 0 >(std::forward< Visitor >(visitor), std::forward< Variant >(variant));
+}
+
+namespace {
+#ifdef PV_NEVER_VALUELESS
+	static constexpr bool never_valueless_mode = true;
+#else
+	static constexpr bool never_valueless_mode = false;
+#endif
+} // namespace
+
+/**
+ * Whether the given variant type can never become valueless by exception when used as the storage of a
+ * polymorphic_variant. This is the case if PV_NEVER_VALUELESS is defined and all alternatives are nothrow
+ * move-constructible, as polymorphic_variant then constructs objects whose construction might throw into a temporary
+ * first (and only moves them into the variant once their construction has succeeded).
+ */
+template< typename Variant > struct never_valueless : std::false_type {};
+
+template< typename... Types >
+struct never_valueless< std::variant< Types... > >
+	: std::bool_constant< never_valueless_mode && (std::is_nothrow_move_constructible_v< Types > && ...) > {};
+
+template< typename Variant > constexpr bool never_valueless_v = never_valueless< Variant >::value;
+
+/**
+ * Same as switch_visit, but for the variant stored inside of a polymorphic_variant: if that variant can't become
+ * valueless (see never_valueless), the check for the valueless state (including its error path) is omitted.
+ */
+template< typename Visitor, typename Variant >
+constexpr visit_result_t< Visitor, Variant > storage_switch_visit(Visitor &&visitor, Variant &&variant) {
+	if constexpr (never_valueless_v< std::remove_cv_t< std::remove_reference_t< Variant > > >) {
+		assert(!variant.valueless_by_exception());
+
+		return switch_visit_from< 0 >(std::forward< Visitor >(visitor), std::forward< Variant >(variant));
+	} else {
+		return switch_visit(std::forward< Visitor >(visitor), std::forward< Variant >(variant));
+	}
+}
+
+} // namespace pv::details
+
+#undef PV_COLD
+#undef PV_NOINLINE
+
+#endif // PV_DETAILS_SWITCH_VISIT_HPP__
@@ -0,0 +1,238 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_TAG_SCAN_HPP__
+#define PV_DETAILS_TAG_SCAN_HPP__
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if !defined(PV_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#	define PV_TAG_SCAN_SSE2
+#	if defined(__GNUC__) || defined(__clang__)
+// AVX2 code is compiled via target attributes and only used if the CPU supports it
+#		define PV_TAG_SCAN_AVX2
+#	endif
+#	include <immintrin.h>
+#endif
+
+namespace pv::details::tag_scan {
+
+/**
+ * The set of functions used for scanning a byte array for a given tag value
+ */
+struct kernels {
+	std::size_t (*count)(const std::uint8_t *data, std::size_t size, std::uint8_t tag);
+	std::size_t (*find_first)(const std::uint8_t *data, std::size_t size, std::uint8_t tag);
+	void (*positions)(const std::uint8_t *data, std::size_t size, std::uint8_t tag, std::vector< std::size_t > &out);
+	const char *name;
+};
+
+inline unsigned int popcount(std::uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast< unsigned int >(__builtin_popcount(mask));
+#else
+	return static_cast< unsigned int >(std::bitset< 32 >(mask).count());
+#endif
+}
+
+/**
+ * Index of the least-significant set bit. The given mask must not be zero.
+ */
+inline unsigned int lowest_set_bit(std::uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast< unsigned int >(__builtin_ctz(mask));
+#else
+	unsigned int index = 0;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+inline void append_positions(std::uint32_t mask, std::size_t offset, std::vector< std::size_t > &out) {
+	while (mask != 0) {
+		out.push_back(offset + lowest_set_bit(mask));
+		// Clear lowest set bit
+		mask &= mask - 1;
+	}
+}
+
+// Scalar implementation
+
+inline std::size_t scalar_count(const std::uint8_t *data, std::size_t size, std::uint8_t tag) {
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < size; ++i) {
+		count += data[i] == tag;
+	}
+
+	return count;
+}
+
+inline std::size_t scalar_find_first(const std::uint8_t *data, std::size_t size, std::uint8_t tag) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] == tag) {
+			return i;
+		}
+	}
+
+	return size;
+}
+
+inline void scalar_positions(const std::uint8_t *data, std::size_t size, std::uint8_t tag,
+							 std::vector< std::size_t > &out) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] == tag) {
+			out.push_back(i);
+		}
+	}
+}
+
+#ifdef PV_TAG_SCAN_SSE2
+// SSE2 implementation (always available on x86-64)
+
+inline std::uint32_t sse2_match_mask(const std::uint8_t *data, __m128i needle) {
+	const __m128i chunk = _mm_loadu_si128(reinterpret_cast< const __m128i * >(data));
+
+	return static_cast< std::uint32_t >(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+}
+
+inline std::size_t sse2_count(const std::uint8_t *data, std::size_t size, std::uint8_t tag) {
+	const __m128i needle = _mm_set1_epi8(static_cast< char >(tag));
+
+	std::size_t count = 0;
+	std::size_t i     = 0;
+	for (; i + 16 <= size; i += 16) {
+		count += popcount(sse2_match_mask(data + i, needle));
+	}
+
+	return count + scalar_count(data + i, size - i, tag);
+}
+
+inline std::size_t sse2_find_first(const std::uint8_t *data, std::size_t size, std::uint8_t tag) {
+	const __m128i needle = _mm_set1_epi8(static_cast< char >(tag));
+
+	std::size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		const std::uint32_t mask = sse2_match_mask(data + i, needle);
+		if (mask != 0) {
+			return i + lowest_set_bit(mask);
+		}
+	}
+
+	return i + scalar_find_first(data + i, size - i, tag);
+}
+
+inline void sse2_positions(const std::uint8_t *data, std::size_t size, std::uint8_t tag,
+						   std::vector< std::size_t > &out) {
+	const __m128i needle = _mm_set1_epi8(static_cast< char >(tag));
+
+	std::size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		append_positions(sse2_match_mask(data + i, needle), i, out);
+	}
+
+	for (; i < size; ++i) {
+		if (data[i] == tag) {
+			out.push_back(i);
+		}
+	}
+}
+#endif
+
+#ifdef PV_TAG_SCAN_AVX2
+// AVX2 implementation
+
+__attribute__((target("avx2"))) inline std::uint32_t avx2_match_mask(const std::uint8_t *data, __m256i needle) {
+	const __m256i chunk = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(data));
+
+	return static_cast< std::uint32_t >(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+}
+
+__attribute__((target("avx2,popcnt"))) inline std::size_t avx2_count(const std::uint8_t *data, std::size_t size,
+																	   std::uint8_t tag) {
+	const __m256i needle = _mm256_set1_epi8(static_cast< char >(tag));
+
+	std::size_t count = 0;
+	std::size_t i     = 0;
+	for (; i + 32 <= size; i += 32) {
+		count += static_cast< std::size_t >(__builtin_popcount(avx2_match_mask(data + i, needle)));
+	}
+
+	return count + scalar_count(data + i, size - i, tag);
+}
+
+__attribute__((target("avx2"))) inline std::size_t avx2_find_first(const std::uint8_t *data, std::size_t size,
+																	 std::uint8_t tag) {
+	const __m256i needle = _mm256_set1_epi8(static_cast< char >(tag));
+
+	std::size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		const std::uint32_t mask = avx2_match_mask(data + i, needle);
+		if (mask != 0) {
+			return i + lowest_set_bit(mask);
+		}
+	}
+
+	return i + scalar_find_first(data + i, size - i, tag);
+}
+
+__attribute__((target("avx2"))) inline void avx2_positions(const std::uint8_t *data, std::size_t size,
+															 std::uint8_t tag, std::vector< std::size_t > &out) {
+	const __m256i needle = _mm256_set1_epi8(static_cast< char >(tag));
+
+	std::size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		append_positions(avx2_match_mask(data + i, needle), i, out);
+	}
+
+	for (; i < size; ++i) {
+		if (data[i] == tag) {
+			out.push_back(i);
+		}
+	}
+}
+#endif
+
+inline const kernels &scalar_kernels() {
+	static constexpr kernels instance = { &scalar_count, &scalar_find_first, &scalar_positions, "scalar" };
+	return instance;
+}
+
+/**
+ * @returns All kernels that can be used on the current CPU, the best one being the last
+ */
+inline std::vector< const kernels * > available_kernels() {
+	std::vector< const kernels * > result = { &scalar_kernels() };
+
+#ifdef PV_TAG_SCAN_SSE2
+	static constexpr kernels sse2 = { &sse2_count, &sse2_find_first, &sse2_positions, "sse2" };
+	result.push_back(&sse2);
+#endif
+#ifdef PV_TAG_SCAN_AVX2
+	static constexpr kernels avx2 = { &avx2_count, &avx2_find_first, &avx2_positions, "avx2" };
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+		result.push_back(&avx2);
+	}
+#endif
+
+	return result;
+}
+
+/**
+ * @returns The best kernels for the current CPU (selected once at runtime)
+ */
+inline const kernels &best_kernels() {
+	static const kernels *selected = available_kernels().back();
+
+	return *selected;
+}
+
+} // namespace pv::details::tag_scan
+
+#endif // PV_DETAILS_TAG_SCAN_HPP__
@@ -0,0 +1,40 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DETAILS_USES_ALLOCATOR_HPP__
+#define PV_DETAILS_USES_ALLOCATOR_HPP__
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace pv::details {
+
+template< typename > constexpr bool dependent_false = false;
+
+/**
+ * Determines the arguments required for constructing an object of type T from the given arguments via uses-allocator
+ * construction (equivalent to C++20's std::uses_allocator_construction_args, except that pairs are not treated
+ * specially). The returned tuple holds references to the given arguments.
+ */
+template< typename T, typename Alloc, typename... Args >
+constexpr auto uses_allocator_construction_args(const Alloc &alloc, Args &&... args) noexcept {
+	if constexpr (!std::uses_allocator_v< T, Alloc >) {
+		static_assert(std::is_constructible_v< T, Args... >, "T can't be constructed from the given arguments");
+		(void) alloc;
+
+		return std::forward_as_tuple(std::forward< Args >(args)...);
+	} else if constexpr (std::is_constructible_v< T, std::allocator_arg_t, const Alloc &, Args... >) {
+		return std::tuple< std::allocator_arg_t, const Alloc &, Args &&... >(std::allocator_arg, alloc,
+																			 std::forward< Args >(args)...);
+	} else if constexpr (std::is_constructible_v< T, Args..., const Alloc & >) {
+		return std::forward_as_tuple(std::forward< Args >(args)..., alloc);
+	} else {
+		static_assert(dependent_false< T >, "T uses the allocator but can't be constructed from it");
+	}
+}
+
+} // namespace pv::details
+
+#endif // PV_DETAILS_USES_ALLOCATOR_HPP__
@@ -5,6 +5,9 @@
 #ifndef PV_DETAILS_VARIADIC_PARAMETER_HELPER_HPP__
 #define PV_DETAILS_VARIADIC_PARAMETER_HELPER_HPP__
 
+#include <cstddef>
+#include <type_traits>
+
 namespace pv::details {
 
 template< typename T1, typename... Rest > struct first_variadic_parameter { using type = T1; };
@@ -15,6 +18,33 @@ template< typename T1, typename... Rest > struct last_variadic_parameter {
 };
 template< typename T1 > struct last_variadic_parameter< T1 > { using type = T1; };
 
+/**
+ * Determines the index of the first occurrence of T within Types (or sizeof...(Types), if T is not contained in Types)
+ */
+template< typename T, typename... Types > struct index_of_type;
+template< typename T > struct index_of_type< T > : std::integral_constant< std::size_t, 0 > {};
+template< typename T, typename... Rest >
+struct index_of_type< T, T, Rest... > : std::integral_constant< std::size_t, 0 > {};
+template< typename T, typename T1, typename... Rest >
+struct index_of_type< T, T1, Rest... >
+	: std::integral_constant< std::size_t, 1 + index_of_type< T, Rest... >::value > {};
+
+template< typename T, typename... Types > constexpr std::size_t index_of_type_v = index_of_type< T, Types... >::value;
+
+/**
+ * Whether T is contained in Types
+ */
+template< typename T, typename... Types >
+constexpr bool contains_type_v = index_of_type_v< T, Types... > < sizeof...(Types);
+
+/**
+ * A list of types. type_list< Subset... >::is_subset_of< Types... > checks whether all of Subset are contained in
+ * Types.
+ */
+template< typename... Subset > struct type_list {
+	template< typename... Types > static constexpr bool is_subset_of = (contains_type_v< Subset, Types... > && ...);
+};
+
 } // namespace pv::details
 
 #endif // PV_DETAILS_VARIADIC_PARAMETER_HELPER_HPP__
@@ -0,0 +1,132 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_DISPATCH_PROFILE_HPP_
+#define PV_DISPATCH_PROFILE_HPP_
+
+#include "pv/pv.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace pv::details {
+
+template< typename Variant > class dispatch_profile;
+
+/**
+ * Access to the runtime profile of the types encountered when visiting objects of the given polymorphic_variant
+ * instantiation. The profile is only recorded if PV_PROFILE_DISPATCH is defined (in all translation units that visit
+ * objects of that type) and can be used to generate a specialization of pv::dispatch_order that makes the dispatch
+ * test for the most frequent types first.
+ */
+template< typename Base, typename... Types > class dispatch_profile< polymorphic_variant< Base, Types... > > {
+public:
+	using variant_type = polymorphic_variant< Base, Types... >;
+
+	static constexpr std::size_t alternatives = sizeof...(Types);
+
+	/**
+	 * @returns Whether dispatches are currently being recorded (i.e. whether PV_PROFILE_DISPATCH is defined)
+	 */
+	static constexpr bool enabled() noexcept {
+#ifdef PV_PROFILE_DISPATCH
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * @returns The amount of dispatches recorded for every type (indexed like Types)
+	 */
+	static std::array< std::uint64_t, alternatives > counts() noexcept {
+		std::array< std::uint64_t, alternatives > result = {};
+		for (std::size_t i = 0; i < alternatives; ++i) {
+			result[i] = counters::hits[i].load(std::memory_order_relaxed);
+		}
+
+		return result;
+	}
+
+	/**
+	 * @returns The total amount of recorded dispatches
+	 */
+	static std::uint64_t total() noexcept {
+		const auto current = counts();
+
+		return std::accumulate(current.begin(), current.end(), std::uint64_t{ 0 });
+	}
+
+	/**
+	 * Discards all recorded dispatches (e.g. after a warm-up phase)
+	 */
+	static void reset() noexcept {
+		for (auto &counter : counters::hits) {
+			counter.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @returns The indices of all types that have been encountered at least once, ordered by decreasing frequency
+	 */
+	static std::vector< std::size_t > order() {
+		const auto current = counts();
+
+		std::vector< std::size_t > indices(alternatives);
+		std::iota(indices.begin(), indices.end(), std::size_t{ 0 });
+		std::stable_sort(indices.begin(), indices.end(),
+						 [&current](std::size_t lhs, std::size_t rhs) { return current[lhs] > current[rhs]; });
+
+		indices.erase(std::find_if(indices.begin(), indices.end(), [&current](std::size_t index) {
+						  return current[index] == 0;
+					  }),
+					  indices.end());
+
+		return indices;
+	}
+
+	/**
+	 * Writes a specialization of pv::dispatch_order for this instantiation (which is spelled as type_name in the
+	 * generated code), listing the types in the recorded order. At most max_types types are listed (the remaining ones
+	 * are dispatched via the regular mechanism).
+	 */
+	static void write_order(std::ostream &stream, std::string_view type_name, std::size_t max_types = 4) {
+		std::vector< std::size_t > indices = order();
+		if (indices.size() > max_types) {
+			indices.resize(max_types);
+		}
+
+		stream << "// Generated from a dispatch profile of " << total() << " dispatches\n";
+		stream << "namespace pv {\n";
+		stream << "template<> struct dispatch_order< " << type_name << " > {\n";
+		stream << "\tusing type = std::index_sequence<";
+		for (std::size_t i = 0; i < indices.size(); ++i) {
+			stream << (i == 0 ? " " : ", ") << indices[i];
+		}
+		stream << (indices.empty() ? "" : " ") << ">;\n";
+		stream << "};\n";
+		stream << "} // namespace pv\n";
+	}
+
+private:
+	using counters = dispatch_counters< variant_type, alternatives >;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::dispatch_profile;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_DISPATCH_PROFILE_HPP_
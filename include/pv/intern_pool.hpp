@@ -0,0 +1,253 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_INTERN_POOL_HPP_
+#define PV_INTERN_POOL_HPP_
+
+#include "pv/pv.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pv::details {
+
+/**
+ * A pool of immutable, deduplicated polymorphic_variant objects (aka a flyweight factory). Interning a value returns a
+ * compact handle to the single instance of that value stored in the pool, so that comparing two interned values for
+ * equality boils down to comparing two integers.
+ *
+ * Values are considered equal if they hold the same alternative and the stored objects compare equal via operator==.
+ * Thus, std::hash has to be specialized and operator== has to be defined for every type in Types.
+ *
+ * Interned values are never removed from the pool and the references handed out by the pool remain valid for its
+ * entire lifetime. The pool is not thread-safe.
+ */
+template< typename Base, typename... Types > class intern_pool {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	/**
+	 * A handle to an interned value. Two handles obtained from the same pool compare equal if and only if they refer
+	 * to equal values.
+	 */
+	class handle {
+	public:
+		constexpr handle() noexcept = default;
+
+		constexpr std::uint32_t id() const noexcept { return m_id; }
+
+		constexpr bool valid() const noexcept { return m_id != invalid_id; }
+
+		friend constexpr bool operator==(handle lhs, handle rhs) noexcept { return lhs.m_id == rhs.m_id; }
+		friend constexpr bool operator!=(handle lhs, handle rhs) noexcept { return lhs.m_id != rhs.m_id; }
+		friend constexpr bool operator<(handle lhs, handle rhs) noexcept { return lhs.m_id < rhs.m_id; }
+
+	private:
+		friend class intern_pool;
+
+		static constexpr std::uint32_t invalid_id = std::numeric_limits< std::uint32_t >::max();
+
+		constexpr explicit handle(std::uint32_t id) noexcept : m_id(id) {}
+
+		std::uint32_t m_id = invalid_id;
+	};
+
+	intern_pool() = default;
+
+	// Copying the pool would be ambiguous w.r.t. handle ownership
+	intern_pool(const intern_pool &) = delete;
+	intern_pool &operator=(const intern_pool &) = delete;
+
+	// The moved-from pool is left empty (and usable)
+	intern_pool(intern_pool &&other)
+		: m_values(std::move(other.m_values)), m_table(std::exchange(other.m_table, make_table(initial_table_size))) {
+		other.m_values.clear();
+	}
+
+	intern_pool &operator=(intern_pool &&other) {
+		if (this != &other) {
+			m_table  = std::exchange(other.m_table, make_table(initial_table_size));
+			m_values = std::move(other.m_values);
+			other.m_values.clear();
+		}
+
+		return *this;
+	}
+
+	/**
+	 * @returns A handle to the pool's instance of the given value (adding a copy of the value to the pool, if it
+	 * doesn't contain an equal value yet)
+	 */
+	handle intern(const value_type &value) { return intern_impl(value); }
+
+	/**
+	 * @returns A handle to the pool's instance of the given value (moving the value into the pool, if it doesn't
+	 * contain an equal value yet)
+	 */
+	handle intern(value_type &&value) { return intern_impl(std::move(value)); }
+
+	/**
+	 * Interns an object of type T constructed from the given arguments
+	 */
+	template< typename T, typename... Args > handle emplace(Args &&... args) {
+		return intern(value_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...));
+	}
+
+	/**
+	 * @returns A handle to the pool's instance of the given value, if the pool contains such a value
+	 */
+	std::optional< handle > find(const value_type &value) const {
+		const std::size_t hash = hash_of(value);
+		const std::size_t slot = find_slot(value, hash);
+
+		if (m_table[slot].id == handle::invalid_id) {
+			return {};
+		}
+
+		return handle(m_table[slot].id);
+	}
+
+	/**
+	 * @returns The interned value the given handle refers to
+	 */
+	const value_type &operator[](handle h) const {
+		assert(h.m_id < m_values.size());
+		return m_values[h.m_id];
+	}
+
+	/**
+	 * @returns The interned value the given handle refers to (as a base-class reference)
+	 */
+	const Base &get(handle h) const { return (*this)[h].get(); }
+
+	/**
+	 * @returns The amount of distinct values stored in the pool
+	 */
+	std::size_t size() const noexcept { return m_values.size(); }
+
+	bool empty() const noexcept { return m_values.empty(); }
+
+private:
+	struct table_entry {
+		std::size_t hash = 0;
+		std::uint32_t id = handle::invalid_id;
+	};
+
+	static constexpr std::size_t initial_table_size = 16;
+
+	static std::vector< table_entry > make_table(std::size_t size) { return std::vector< table_entry >(size); }
+
+	static std::size_t hash_of(const value_type &value) {
+		const std::size_t value_hash = value.visit([](const auto &concrete) {
+			return std::hash< std::decay_t< decltype(concrete) > >{}(concrete);
+		});
+
+		// Mix in the alternative's index, so that equal values of different types end up in different slots
+		return value_hash ^ (value.index() + std::size_t{ 0x9e3779b9 } + (value_hash << 6) + (value_hash >> 2));
+	}
+
+	static bool equal(const value_type &lhs, const value_type &rhs) {
+		if (lhs.index() != rhs.index()) {
+			return false;
+		}
+
+		return lhs.visit([&rhs](const auto &lhs_value) {
+			return rhs.visit([&lhs_value](const auto &rhs_value) {
+				if constexpr (std::is_same_v< decltype(lhs_value), decltype(rhs_value) >) {
+					return static_cast< bool >(lhs_value == rhs_value);
+				} else {
+					// Unreachable as the indices are equal
+					return false;
+				}
+			});
+		});
+	}
+
+	/**
+	 * @returns The slot in the hash table that either contains the given value or that is the empty slot in which the
+	 * value would have to be inserted
+	 */
+	std::size_t find_slot(const value_type &value, std::size_t hash) const {
+		assert(!m_table.empty());
+
+		const std::size_t mask = m_table.size() - 1;
+		for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+			const table_entry &entry = m_table[slot];
+
+			if (entry.id == handle::invalid_id || (entry.hash == hash && equal(m_values[entry.id], value))) {
+				return slot;
+			}
+		}
+	}
+
+	template< typename Value > handle intern_impl(Value &&value) {
+		const std::size_t hash = hash_of(value);
+		std::size_t slot       = find_slot(value, hash);
+
+		if (m_table[slot].id != handle::invalid_id) {
+			return handle(m_table[slot].id);
+		}
+
+		if (m_values.size() >= handle::invalid_id) {
+			throw std::length_error("intern_pool: Too many distinct values");
+		}
+
+		const auto id = static_cast< std::uint32_t >(m_values.size());
+		m_values.push_back(std::forward< Value >(value));
+
+		m_table[slot] = { hash, id };
+
+		// Keep the load factor below 1/2 for short probe sequences
+		if (2 * m_values.size() > m_table.size()) {
+			grow();
+		}
+
+		return handle(id);
+	}
+
+	void grow() {
+		std::vector< table_entry > old_table(m_table.size() * 2);
+		std::swap(old_table, m_table);
+
+		const std::size_t mask = m_table.size() - 1;
+		for (const table_entry &entry : old_table) {
+			if (entry.id == handle::invalid_id) {
+				continue;
+			}
+
+			std::size_t slot = entry.hash & mask;
+			while (m_table[slot].id != handle::invalid_id) {
+				slot = (slot + 1) & mask;
+			}
+
+			m_table[slot] = entry;
+		}
+	}
+
+	// A deque never relocates its elements when growing at the end
+	std::deque< value_type > m_values;
+	// Open-addressing hash table (linear probing) with a power-of-two size
+	std::vector< table_entry > m_table = make_table(initial_table_size);
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::intern_pool;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_INTERN_POOL_HPP_
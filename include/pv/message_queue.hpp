@@ -0,0 +1,366 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_MESSAGE_QUEUE_HPP_
+#define PV_MESSAGE_QUEUE_HPP_
+
+#include "pv/pv.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pv::details {
+
+/**
+ * The assumed size of a cache line. Data that is written to by different threads is kept this far apart in order to
+ * avoid false sharing.
+ */
+static constexpr std::size_t cache_line_size = 64;
+
+/**
+ * A single element of a message queue. Every slot occupies (at least) its own cache line(s) so that a producer
+ * writing into one slot doesn't invalidate the cache line of a neighbouring slot that is currently being read by the
+ * consumer.
+ */
+template< typename Value > struct alignas(cache_line_size) alignas(Value) queue_slot {
+	alignas(Value) unsigned char storage[sizeof(Value)];
+
+	Value *get() noexcept { return std::launder(reinterpret_cast< Value * >(storage)); }
+};
+
+/**
+ * Consumes (visits and destroys) the value in the given slot. The value is destroyed even if the visitor throws.
+ */
+template< typename Value, typename Visitor > void consume_slot(queue_slot< Value > &slot, Visitor &&visitor) {
+	struct destroyer {
+		Value *value;
+
+		~destroyer() { value->~Value(); }
+	} guard{ slot.get() };
+
+	guard.value->visit(std::forward< Visitor >(visitor));
+}
+
+inline std::size_t round_up_to_power_of_two(std::size_t value) {
+	std::size_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+
+	return result;
+}
+
+/**
+ * A bounded, lock-free single-producer single-consumer queue of polymorphic_variant objects. Messages are constructed
+ * in-place inside cache-line-aligned slots and are visited in-place by the consumer (as their concrete type), so that
+ * they never have to be moved or boxed.
+ *
+ * Exactly one thread may act as producer (calling try_emplace/try_push) and exactly one thread may act as consumer
+ * (calling try_consume/consume_all) at any given time.
+ */
+template< typename Base, typename... Types > class spsc_queue {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	/**
+	 * Creates a queue that can hold at least the given amount of messages (the capacity is rounded up to the next power
+	 * of two)
+	 */
+	explicit spsc_queue(std::size_t capacity)
+		: m_capacity(round_up_to_power_of_two(capacity)), m_slots(std::make_unique< slot_type[] >(m_capacity)) {}
+
+	spsc_queue(const spsc_queue &) = delete;
+	spsc_queue &operator=(const spsc_queue &) = delete;
+
+	~spsc_queue() {
+		while (try_consume([](auto &&) {})) {
+		}
+	}
+
+	/**
+	 * Constructs a message of type T from the given arguments in-place at the end of the queue
+	 *
+	 * @returns Whether the message was enqueued. If this returns false, the queue was full.
+	 */
+	template< typename T, typename... Args > bool try_emplace(Args &&... args) {
+		const std::size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+
+		if (tail - m_producer.cached_head == m_capacity) {
+			m_producer.cached_head = m_consumer.head.load(std::memory_order_acquire);
+
+			if (tail - m_producer.cached_head == m_capacity) {
+				return false;
+			}
+		}
+
+		new (m_slots[tail & (m_capacity - 1)].storage) value_type(std::in_place_type_t< T >{},
+																  std::forward< Args >(args)...);
+
+		m_producer.tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * Enqueues a copy of the given message
+	 */
+	bool try_push(const value_type &value) { return try_emplace_value(value); }
+
+	/**
+	 * Moves the given message into the queue
+	 */
+	bool try_push(value_type &&value) { return try_emplace_value(std::move(value)); }
+
+	/**
+	 * Invokes the given visitor on the oldest message in the queue (as its concrete type) and removes the message
+	 * afterwards
+	 *
+	 * @returns Whether a message has been consumed. If this returns false, the queue was empty.
+	 */
+	template< typename Visitor > bool try_consume(Visitor &&visitor) {
+		const std::size_t head = m_consumer.head.load(std::memory_order_relaxed);
+
+		if (head == m_consumer.cached_tail) {
+			m_consumer.cached_tail = m_producer.tail.load(std::memory_order_acquire);
+
+			if (head == m_consumer.cached_tail) {
+				return false;
+			}
+		}
+
+		// The slot's value is destroyed even if the visitor throws, so the slot has to be released in any case
+		struct releaser {
+			std::atomic< std::size_t > &head;
+			std::size_t next;
+
+			~releaser() { head.store(next, std::memory_order_release); }
+		} guard{ m_consumer.head, head + 1 };
+
+		consume_slot(m_slots[head & (m_capacity - 1)], std::forward< Visitor >(visitor));
+
+		return true;
+	}
+
+	/**
+	 * Consumes all messages that are currently in the queue
+	 *
+	 * @returns The amount of consumed messages
+	 */
+	template< typename Visitor > std::size_t consume_all(Visitor &&visitor) {
+		std::size_t consumed = 0;
+		while (try_consume(visitor)) {
+			consumed++;
+		}
+
+		return consumed;
+	}
+
+	/**
+	 * @returns Whether the queue is currently empty. The result is only a snapshot if called concurrently to the
+	 * producer.
+	 */
+	bool empty() const noexcept {
+		return m_consumer.head.load(std::memory_order_acquire) == m_producer.tail.load(std::memory_order_acquire);
+	}
+
+	std::size_t capacity() const noexcept { return m_capacity; }
+
+private:
+	using slot_type = queue_slot< value_type >;
+
+	template< typename Value > bool try_emplace_value(Value &&value) {
+		return std::forward< Value >(value).visit([this](auto &&concrete) {
+			using concrete_type = std::decay_t< decltype(concrete) >;
+
+			return try_emplace< concrete_type >(std::forward< decltype(concrete) >(concrete));
+		});
+	}
+
+	struct alignas(cache_line_size) producer_state {
+		std::atomic< std::size_t > tail = 0;
+		std::size_t cached_head         = 0;
+	};
+
+	struct alignas(cache_line_size) consumer_state {
+		std::atomic< std::size_t > head = 0;
+		std::size_t cached_tail         = 0;
+	};
+
+	const std::size_t m_capacity;
+	std::unique_ptr< slot_type[] > m_slots;
+	producer_state m_producer;
+	consumer_state m_consumer;
+};
+
+/**
+ * A bounded, lock-free multi-producer single-consumer queue of polymorphic_variant objects. Messages are constructed
+ * in-place inside cache-line-aligned slots and are visited in-place by the consumer (as their concrete type), so that
+ * they never have to be moved or boxed.
+ *
+ * Any number of threads may act as producers (calling try_emplace/try_push) concurrently but only a single thread may
+ * act as consumer (calling try_consume/consume_all) at any given time.
+ */
+template< typename Base, typename... Types > class mpsc_queue {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	/**
+	 * Creates a queue that can hold at least the given amount of messages (the capacity is rounded up to the next power
+	 * of two)
+	 */
+	explicit mpsc_queue(std::size_t capacity)
+		: m_capacity(round_up_to_power_of_two(capacity)), m_slots(std::make_unique< slot_type[] >(m_capacity)) {
+		for (std::size_t i = 0; i < m_capacity; ++i) {
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	mpsc_queue(const mpsc_queue &) = delete;
+	mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+	~mpsc_queue() {
+		while (try_consume([](auto &&) {})) {
+		}
+	}
+
+	/**
+	 * Constructs a message of type T from the given arguments in-place at the end of the queue
+	 *
+	 * @returns Whether the message was enqueued. If this returns false, the queue was full.
+	 */
+	template< typename T, typename... Args > bool try_emplace(Args &&... args) {
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		slot_type *slot  = nullptr;
+
+		while (true) {
+			slot = &m_slots[tail & (m_capacity - 1)];
+
+			const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast< std::ptrdiff_t >(sequence) - static_cast< std::ptrdiff_t >(tail);
+
+			if (diff == 0) {
+				if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				// The consumer has not yet released the slot from the previous round -> queue is full
+				return false;
+			} else {
+				tail = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		// The slot is claimed at this point and has to be published in any case (otherwise the consumer would block
+		// on it forever). Thus, if the construction fails, the slot is published as being empty.
+		struct publisher {
+			slot_type *slot;
+			std::size_t sequence;
+
+			~publisher() { slot->sequence.store(sequence, std::memory_order_release); }
+		} guard{ slot, tail + 1 };
+
+		slot->constructed = false;
+		new (slot->value.storage) value_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+		slot->constructed = true;
+
+		return true;
+	}
+
+	/**
+	 * Enqueues a copy of the given message
+	 */
+	bool try_push(const value_type &value) { return try_emplace_value(value); }
+
+	/**
+	 * Moves the given message into the queue
+	 */
+	bool try_push(value_type &&value) { return try_emplace_value(std::move(value)); }
+
+	/**
+	 * Invokes the given visitor on the oldest message in the queue (as its concrete type) and removes the message
+	 * afterwards
+	 *
+	 * @returns Whether a message has been consumed. If this returns false, the queue was empty.
+	 */
+	template< typename Visitor > bool try_consume(Visitor &&visitor) {
+		while (true) {
+			slot_type &slot = m_slots[m_head & (m_capacity - 1)];
+
+			if (slot.sequence.load(std::memory_order_acquire) != m_head + 1) {
+				return false;
+			}
+
+			struct releaser {
+				slot_type &slot;
+				std::size_t sequence;
+
+				~releaser() { slot.sequence.store(sequence, std::memory_order_release); }
+			} guard{ slot, m_head + m_capacity };
+
+			m_head++;
+
+			if (slot.constructed) {
+				consume_slot(slot.value, std::forward< Visitor >(visitor));
+
+				return true;
+			}
+
+			// A producer failed to construct its message -> skip the empty slot
+		}
+	}
+
+	/**
+	 * Consumes all messages that are currently in the queue
+	 *
+	 * @returns The amount of consumed messages
+	 */
+	template< typename Visitor > std::size_t consume_all(Visitor &&visitor) {
+		std::size_t consumed = 0;
+		while (try_consume(visitor)) {
+			consumed++;
+		}
+
+		return consumed;
+	}
+
+	std::size_t capacity() const noexcept { return m_capacity; }
+
+private:
+	struct slot_type {
+		queue_slot< value_type > value;
+		std::atomic< std::size_t > sequence;
+		bool constructed = false;
+	};
+
+	template< typename Value > bool try_emplace_value(Value &&value) {
+		return std::forward< Value >(value).visit([this](auto &&concrete) {
+			using concrete_type = std::decay_t< decltype(concrete) >;
+
+			return try_emplace< concrete_type >(std::forward< decltype(concrete) >(concrete));
+		});
+	}
+
+	const std::size_t m_capacity;
+	std::unique_ptr< slot_type[] > m_slots;
+	alignas(cache_line_size) std::atomic< std::size_t > m_tail = 0;
+	// Only ever accessed by the consumer thread
+	alignas(cache_line_size) std::size_t m_head = 0;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::mpsc_queue;
+	using details::spsc_queue;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_MESSAGE_QUEUE_HPP_
@@ -0,0 +1,207 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_NODE_ARENA_HPP_
+#define PV_NODE_ARENA_HPP_
+
+#include "pv/pv.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace pv::details {
+
+template< typename Base, typename... Types > class node_arena;
+
+/**
+ * A compact (32-bit) handle to a node stored in a node_arena whose nodes derive from Base. As the handle type only
+ * depends on Base, node types can store handles to their children without referring to the (not yet complete) arena
+ * type.
+ */
+template< typename Base > class node_handle {
+public:
+	constexpr node_handle() noexcept = default;
+
+	constexpr std::uint32_t index() const noexcept { return m_index; }
+
+	constexpr bool valid() const noexcept { return m_index != invalid_index; }
+
+	friend constexpr bool operator==(node_handle lhs, node_handle rhs) noexcept { return lhs.m_index == rhs.m_index; }
+	friend constexpr bool operator!=(node_handle lhs, node_handle rhs) noexcept { return lhs.m_index != rhs.m_index; }
+
+private:
+	template< typename, typename... > friend class node_arena;
+
+	static constexpr std::uint32_t invalid_index = std::numeric_limits< std::uint32_t >::max();
+
+	constexpr explicit node_handle(std::uint32_t index) noexcept : m_index(index) {}
+
+	std::uint32_t m_index = invalid_index;
+};
+
+/**
+ * A bump arena for the nodes of recursive data structures (e.g. syntax trees), in which nodes refer to each other via
+ * node_handle objects instead of owning pointers. Nodes are stored contiguously (in order of creation) in chunks of
+ * chunk_size objects that are never moved, so references to nodes remain valid until the arena is cleared. Nodes
+ * can't be freed individually. Instead, clear() destroys all of them at once while keeping the allocated memory for
+ * reuse.
+ *
+ * The arena is not thread-safe.
+ */
+template< typename Base, typename... Types > class node_arena {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+	using handle     = node_handle< Base >;
+
+	// The amount of nodes per chunk (a power of two)
+	static constexpr std::size_t chunk_size = 1024;
+
+	node_arena() = default;
+
+	node_arena(const node_arena &) = delete;
+	node_arena &operator=(const node_arena &) = delete;
+
+	node_arena(node_arena &&other) noexcept
+		: m_chunks(std::move(other.m_chunks)), m_size(std::exchange(other.m_size, 0)) {}
+
+	node_arena &operator=(node_arena &&other) noexcept {
+		if (this != &other) {
+			release();
+
+			m_chunks = std::move(other.m_chunks);
+			m_size   = std::exchange(other.m_size, 0);
+		}
+
+		return *this;
+	}
+
+	~node_arena() { release(); }
+
+	/**
+	 * Creates a node of type T from the given arguments
+	 *
+	 * @returns A handle to the new node
+	 */
+	template< typename T, typename... Args > handle emplace(Args &&... args) {
+		value_type *storage = next_slot();
+		::new (static_cast< void * >(storage)) value_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+
+		return handle(static_cast< std::uint32_t >(m_size++));
+	}
+
+	/**
+	 * Adds the given node to the arena
+	 *
+	 * @returns A handle to the new node
+	 */
+	template< typename T > handle insert(T &&node) {
+		value_type *storage = next_slot();
+		::new (static_cast< void * >(storage)) value_type(std::forward< T >(node));
+
+		return handle(static_cast< std::uint32_t >(m_size++));
+	}
+
+	value_type &operator[](handle h) noexcept {
+		assert(h.m_index < m_size);
+		return *slot(h.m_index);
+	}
+
+	const value_type &operator[](handle h) const noexcept {
+		assert(h.m_index < m_size);
+		return *slot(h.m_index);
+	}
+
+	/**
+	 * @returns The node the given handle refers to (as a base-class reference)
+	 */
+	Base &get(handle h) noexcept { return (*this)[h].get(); }
+	const Base &get(handle h) const noexcept { return (*this)[h].get(); }
+
+	/**
+	 * Reserves memory for (at least) the given total amount of nodes
+	 */
+	void reserve(std::size_t count) {
+		while (capacity() < count) {
+			allocate_chunk();
+		}
+	}
+
+	/**
+	 * Destroys all nodes (invalidating all handles), but keeps the allocated memory for reuse
+	 */
+	void clear() noexcept {
+		for (std::size_t i = 0; i < m_size; ++i) {
+			slot(i)->~value_type();
+		}
+
+		m_size = 0;
+	}
+
+	std::size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	std::size_t capacity() const noexcept { return m_chunks.size() * chunk_size; }
+
+private:
+	static_assert(chunk_size > 0 && (chunk_size & (chunk_size - 1)) == 0, "The chunk size has to be a power of two");
+
+	using allocator_type = std::allocator< value_type >;
+
+	value_type *slot(std::size_t index) const noexcept { return m_chunks[index / chunk_size] + index % chunk_size; }
+
+	value_type *next_slot() {
+		if (m_size >= handle::invalid_index) {
+			throw std::length_error("node_arena: Too many nodes");
+		}
+
+		if (m_size == capacity()) {
+			allocate_chunk();
+		}
+
+		return slot(m_size);
+	}
+
+	void allocate_chunk() {
+		// Reserve before allocating, so that pushing the chunk pointer can't throw and leak the chunk
+		if (m_chunks.size() == m_chunks.capacity()) {
+			m_chunks.reserve(2 * m_chunks.size() + 1);
+		}
+
+		allocator_type alloc;
+		m_chunks.push_back(std::allocator_traits< allocator_type >::allocate(alloc, chunk_size));
+	}
+
+	void release() noexcept {
+		clear();
+
+		allocator_type alloc;
+		for (value_type *chunk : m_chunks) {
+			std::allocator_traits< allocator_type >::deallocate(alloc, chunk, chunk_size);
+		}
+
+		m_chunks.clear();
+	}
+
+	std::vector< value_type * > m_chunks;
+	std::size_t m_size = 0;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::node_arena;
+	using details::node_handle;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_NODE_ARENA_HPP_
@@ -0,0 +1,299 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_OPTIONAL_POLYMORPHIC_VARIANT_HPP_
+#define PV_OPTIONAL_POLYMORPHIC_VARIANT_HPP_
+
+#include "pv/pv.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace pv::details {
+
+/**
+ * A polymorphic_variant that can also be empty. The empty state is stored as an additional alternative
+ * (std::monostate) of the underlying variant, so that it is encoded in the variant's type index instead of requiring a
+ * separate flag (as std::optional< polymorphic_variant< Base, Types... > > would). Hence, an
+ * optional_polymorphic_variant has the same size as the corresponding polymorphic_variant.
+ */
+template< typename Base, typename... Types > class optional_polymorphic_variant {
+public:
+	/**
+	 * The type of the underlying variant object (the first alternative represents the empty state)
+	 */
+	using variant_type = std::variant< std::monostate, Types... >;
+
+	using base_type = std::decay_t< Base >;
+
+private:
+	using self_type = optional_polymorphic_variant< Base, Types... >;
+
+	template< typename T >
+	static constexpr bool
+		is_wrapped_type = (std::is_same_v< std::remove_cv_t< std::remove_reference_t< T > >, Types > || ...);
+
+	template< typename T > using enable_if_wrapped_type = std::enable_if_t< is_wrapped_type< T > >;
+
+public:
+	static_assert(sizeof...(Types) > 0, "Must provide at least one explicit sub-type");
+	static_assert(!std::is_reference_v< Base >, "Base must not be given as a reference");
+	static_assert(!std::is_pointer_v< Base >, "Base must not be given as a pointer");
+	static_assert((!std::is_reference_v< Types > && ...), "None of the types may be given as a reference");
+	static_assert((!std::is_pointer_v< Types > && ...), "None of the types may be given as a pointer");
+	static_assert((std::is_convertible_v< Types &, Base & > && ...), "All types must publicly inherit from Base");
+
+	// Creates an empty object
+	constexpr optional_polymorphic_variant() noexcept = default;
+
+	// Creates an empty object
+	constexpr optional_polymorphic_variant(std::nullopt_t) noexcept {}
+
+	constexpr optional_polymorphic_variant(const self_type &other) = default;
+	constexpr optional_polymorphic_variant(self_type &&other)      = default;
+
+	// Constructor taking one of Types
+	template< typename T, typename = enable_if_wrapped_type< T > >
+	constexpr optional_polymorphic_variant(T &&t)
+		: m_variant(std::forward< T >(t))
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< std::decay_t< T >, std::monostate, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Constructor creating one of Types in-place from given arguments
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	constexpr explicit optional_polymorphic_variant(std::in_place_type_t< T >, Args &&... args)
+		: m_variant(std::in_place_type_t< T >{}, std::forward< Args >(args)...)
+#ifndef PV_USE_VISIT_ACCESS
+		  ,
+		  m_base_offset(storage_offset< std::decay_t< T >, std::monostate, Types... >::get(m_variant))
+#endif
+	{
+	}
+
+	// Converting constructor from a (non-empty) polymorphic_variant
+	optional_polymorphic_variant(const polymorphic_variant< Base, Types... > &other) {
+		other.visit([this](const auto &value) { emplace< std::decay_t< decltype(value) > >(value); });
+	}
+
+	// Converting constructor from a (non-empty) polymorphic_variant
+	optional_polymorphic_variant(polymorphic_variant< Base, Types... > &&other) {
+		std::move(other).visit([this](auto &&value) { emplace< std::decay_t< decltype(value) > >(std::move(value)); });
+	}
+
+	constexpr optional_polymorphic_variant &operator=(const self_type &rhs) = default;
+	constexpr optional_polymorphic_variant &operator=(self_type &&rhs)      = default;
+
+	optional_polymorphic_variant &operator=(std::nullopt_t) noexcept {
+		reset();
+
+		return *this;
+	}
+
+	template< typename T, typename = enable_if_wrapped_type< T > > optional_polymorphic_variant &operator=(T &&t) {
+		m_variant = std::forward< T >(t);
+
+#ifndef PV_USE_VISIT_ACCESS
+		storage_offset< std::decay_t< T >, std::monostate, Types... >::update(m_base_offset, m_variant);
+#endif
+
+		return *this;
+	}
+
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > > T &emplace(Args &&... args) {
+		T &ref = [&]() -> T & {
+			if constexpr (never_valueless_v< variant_type > && !std::is_nothrow_constructible_v< T, Args... >) {
+				// Construct into a temporary first, so that an exception leaves the current state untouched
+				T temporary(std::forward< Args >(args)...);
+				return m_variant.template emplace< T >(std::move(temporary));
+			} else {
+				return m_variant.template emplace< T >(std::forward< Args >(args)...);
+			}
+		}();
+
+#ifndef PV_USE_VISIT_ACCESS
+		storage_offset< T, std::monostate, Types... >::update(m_base_offset, m_variant);
+#endif
+
+		return ref;
+	}
+
+	/**
+	 * Destroys the stored object (if any)
+	 */
+	void reset() noexcept {
+		m_variant.template emplace< std::monostate >();
+
+#ifndef PV_USE_VISIT_ACCESS
+		storage_offset< std::monostate, std::monostate, Types... >::update(m_base_offset, m_variant);
+#endif
+	}
+
+	// A variant that became valueless by exception is treated as being empty
+	constexpr bool has_value() const noexcept {
+		return m_variant.index() != 0 && !m_variant.valueless_by_exception();
+	}
+
+	constexpr explicit operator bool() const noexcept { return has_value(); }
+
+	/**
+	 * @returns The index of the currently stored type within Types or std::variant_npos, if the object is empty
+	 */
+	constexpr std::size_t index() const noexcept { return has_value() ? m_variant.index() - 1 : std::variant_npos; }
+
+	/**
+	 * Gets the stored value as a base-class reference. The object must not be empty.
+	 */
+	Base &get() noexcept {
+		assert(has_value());
+		return *base_pointer();
+	}
+
+	/**
+	 * Gets the stored value as a base-class reference. The object must not be empty.
+	 */
+	const Base &get() const noexcept {
+		assert(has_value());
+		return *base_pointer();
+	}
+
+	/**
+	 * Gets the stored value as a base-class reference
+	 *
+	 * @throws std::bad_optional_access, if the object is empty
+	 */
+	Base &value() {
+		if (!has_value()) {
+			throw std::bad_optional_access();
+		}
+
+		return *base_pointer();
+	}
+
+	/**
+	 * Gets the stored value as a base-class reference
+	 *
+	 * @throws std::bad_optional_access, if the object is empty
+	 */
+	const Base &value() const {
+		if (!has_value()) {
+			throw std::bad_optional_access();
+		}
+
+		return *base_pointer();
+	}
+
+	/**
+	 * Accesses the currently stored object via the base-class interface. The object must not be empty.
+	 */
+	Base *operator->() noexcept { return &get(); }
+
+	/**
+	 * Accesses the currently stored object via the base-class interface. The object must not be empty.
+	 */
+	const Base *operator->() const noexcept { return &get(); }
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type. The object must not be empty.
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) & {
+		return dispatch(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type. The object must not be empty.
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) const & {
+		return dispatch(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object as its concrete type. The object must not be empty.
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) && {
+		return dispatch(std::forward< Visitor >(visitor), std::move(m_variant));
+	}
+
+	void swap(optional_polymorphic_variant &rhs) {
+		m_variant.swap(rhs.m_variant);
+#ifndef PV_USE_VISIT_ACCESS
+		std::swap(m_base_offset, rhs.m_base_offset);
+#endif
+	}
+
+	friend bool operator==(const optional_polymorphic_variant &lhs, std::nullopt_t) noexcept {
+		return !lhs.has_value();
+	}
+	friend bool operator!=(const optional_polymorphic_variant &lhs, std::nullopt_t) noexcept {
+		return lhs.has_value();
+	}
+
+private:
+	base_type *base_pointer() noexcept {
+		return const_cast< base_type * >(static_cast< const self_type & >(*this).base_pointer());
+	}
+
+	const base_type *base_pointer() const noexcept {
+#ifdef PV_USE_VISIT_ACCESS
+		return storage_switch_visit(
+			[](const auto &obj) -> const base_type * {
+				if constexpr (std::is_same_v< std::decay_t< decltype(obj) >, std::monostate >) {
+					return nullptr;
+				} else {
+					return &obj;
+				}
+			},
+			m_variant);
+#else
+		assert(m_base_offset < sizeof(self_type));
+		return reinterpret_cast< const base_type * >(reinterpret_cast< const unsigned char * >(this) + m_base_offset);
+#endif
+	}
+
+	template< typename Visitor, typename Variant >
+	static decltype(auto) dispatch(Visitor &&visitor, Variant &&variant) {
+		using result_type = std::invoke_result_t< Visitor, decltype(std::get< 1 >(std::forward< Variant >(variant))) >;
+		// The std::monostate alternative is never passed to the visitor
+		static_assert(consistent_visit_result_v< Visitor, Variant, 1 >,
+					  "The visitor has to return the same type for all alternatives");
+
+		assert(variant.index() != 0);
+
+		return storage_switch_visit(
+			[&visitor](auto &&value) -> result_type {
+				if constexpr (std::is_same_v< std::decay_t< decltype(value) >, std::monostate >) {
+					unreachable();
+				} else {
+					return std::invoke(std::forward< Visitor >(visitor), std::forward< decltype(value) >(value));
+				}
+			},
+			std::forward< Variant >(variant));
+	}
+
+	variant_type m_variant;
+#ifndef PV_USE_VISIT_ACCESS
+	// Offset of the stored object (or of the std::monostate, if the object is empty)
+	std::size_t m_base_offset = storage_offset< std::monostate, std::monostate, Types... >::get(m_variant);
+#endif
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::optional_polymorphic_variant;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_OPTIONAL_POLYMORPHIC_VARIANT_HPP_
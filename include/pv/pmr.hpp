@@ -0,0 +1,42 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_PMR_HPP_
+#define PV_PMR_HPP_
+
+#include "pv/pv.hpp"
+#include "pv/tagged_ptr.hpp"
+
+#include <deque>
+#include <memory_resource>
+#include <vector>
+
+namespace pv {
+
+inline namespace v2 {
+	/**
+	 * Aliases for containers of polymorphic_variant objects using a std::pmr::polymorphic_allocator. If the stored
+	 * types use a polymorphic allocator themselves (e.g. because they contain std::pmr::string members), the
+	 * container's memory resource is propagated to them, so that all (nested) allocations are served from the same
+	 * memory resource.
+	 */
+	namespace pmr {
+		template< typename Base, typename... Types >
+		using polymorphic_allocator = std::pmr::polymorphic_allocator< polymorphic_variant< Base, Types... > >;
+
+		template< typename Base, typename... Types >
+		using vector = std::vector< polymorphic_variant< Base, Types... >, polymorphic_allocator< Base, Types... > >;
+
+		template< typename Base, typename... Types >
+		using deque = std::deque< polymorphic_variant< Base, Types... >, polymorphic_allocator< Base, Types... > >;
+
+		// Note that the polymorphic allocator is stateful, so this pointer is twice as large as pv::tagged_ptr
+		template< typename Base, typename... Types >
+		using tagged_ptr = basic_tagged_ptr< std::pmr::polymorphic_allocator< Base >, Base, Types... >;
+	} // namespace pmr
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_PMR_HPP_
@@ -15,6 +15,11 @@ inline namespace v2 {
 	using pv = details::polymorphic_variant<Base, Types...>;
 
 	using details::polymorphic_variant;
+	using details::visit;
+	using details::holds_alternative;
+	using details::get_if;
+	using details::get;
+	using details::narrow;
 }
 
 }
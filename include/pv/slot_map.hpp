@@ -0,0 +1,270 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_SLOT_MAP_HPP_
+#define PV_SLOT_MAP_HPP_
+
+#include "pv/pv.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace pv::details {
+
+template< typename Base, typename... Types > class slot_map;
+
+/**
+ * A 64-bit handle to an object stored in a slot_map whose objects derive from Base. It consists of the index of a slot
+ * and the generation of that slot at the time the object was inserted. Once the object is erased, the slot's
+ * generation changes, so the handle no longer refers to any object (even if the slot is reused).
+ */
+template< typename Base > class slot_handle {
+public:
+	constexpr slot_handle() noexcept = default;
+
+	constexpr std::uint32_t index() const noexcept { return m_index; }
+	constexpr std::uint32_t generation() const noexcept { return m_generation; }
+
+	constexpr bool valid() const noexcept { return m_index != invalid_index; }
+
+	/**
+	 * @returns The handle packed into a single integer (e.g. for use as an external ID)
+	 */
+	constexpr std::uint64_t value() const noexcept {
+		return (static_cast< std::uint64_t >(m_generation) << 32) | m_index;
+	}
+
+	static constexpr slot_handle from_value(std::uint64_t value) noexcept {
+		return slot_handle(static_cast< std::uint32_t >(value), static_cast< std::uint32_t >(value >> 32));
+	}
+
+	friend constexpr bool operator==(slot_handle lhs, slot_handle rhs) noexcept {
+		return lhs.m_index == rhs.m_index && lhs.m_generation == rhs.m_generation;
+	}
+	friend constexpr bool operator!=(slot_handle lhs, slot_handle rhs) noexcept { return !(lhs == rhs); }
+
+private:
+	template< typename, typename... > friend class slot_map;
+
+	static constexpr std::uint32_t invalid_index = std::numeric_limits< std::uint32_t >::max();
+
+	constexpr slot_handle(std::uint32_t index, std::uint32_t generation) noexcept
+		: m_index(index), m_generation(generation) {}
+
+	std::uint32_t m_index      = invalid_index;
+	std::uint32_t m_generation = 0;
+};
+
+/**
+ * A container of polymorphic_variant objects that hands out stable handles (see slot_handle) to its elements. The
+ * elements themselves are stored densely (in no particular order) and can be iterated like a std::vector. A handle is
+ * resolved via a single indirection through the slot table (no hashing). Erasing an element moves the last element
+ * into its place, so references and iterators to elements are invalidated by insertions and erasures - handles are not.
+ *
+ * Erased slots are reused (most recently erased first). Every slot can be reused 2^32 times before its generation
+ * wraps around, after which a stale handle could refer to a new element again.
+ */
+template< typename Base, typename... Types > class slot_map {
+public:
+	using value_type     = polymorphic_variant< Base, Types... >;
+	using handle         = slot_handle< Base >;
+	using iterator       = typename std::vector< value_type >::iterator;
+	using const_iterator = typename std::vector< value_type >::const_iterator;
+
+	/**
+	 * Creates an object of type T from the given arguments
+	 *
+	 * @returns A handle to the new object
+	 */
+	template< typename T, typename... Args > handle emplace(Args &&... args) {
+		m_values.emplace_back(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+
+		return register_last();
+	}
+
+	/**
+	 * Adds the given object to the map
+	 *
+	 * @returns A handle to the new object
+	 */
+	template< typename T > handle insert(T &&value) {
+		m_values.emplace_back(std::forward< T >(value));
+
+		return register_last();
+	}
+
+	/**
+	 * Erases the object the given handle refers to (if any)
+	 *
+	 * @returns Whether an object has been erased
+	 */
+	bool erase(handle h) {
+		if (!contains(h)) {
+			return false;
+		}
+
+		slot &erased                  = m_slots[h.m_index];
+		const std::uint32_t dense_pos = erased.dense_index;
+		const std::uint32_t last_pos  = static_cast< std::uint32_t >(m_values.size() - 1);
+
+		if (dense_pos != last_pos) {
+			m_values[dense_pos]      = std::move(m_values[last_pos]);
+			m_dense_slots[dense_pos] = m_dense_slots[last_pos];
+
+			m_slots[m_dense_slots[dense_pos]].dense_index = dense_pos;
+		}
+
+		m_values.pop_back();
+		m_dense_slots.pop_back();
+
+		release_slot(h.m_index);
+
+		return true;
+	}
+
+	/**
+	 * @returns Whether the given handle refers to an object in this map
+	 */
+	bool contains(handle h) const noexcept {
+		if (h.m_index >= m_slots.size() || m_slots[h.m_index].generation != h.m_generation) {
+			return false;
+		}
+
+		// Guards against handles that have been forged via from_value
+		const std::uint32_t dense_pos = m_slots[h.m_index].dense_index;
+		return dense_pos < m_dense_slots.size() && m_dense_slots[dense_pos] == h.m_index;
+	}
+
+	/**
+	 * @returns A pointer to the object the given handle refers to or nullptr, if there is no such object
+	 */
+	value_type *find(handle h) noexcept { return contains(h) ? &m_values[m_slots[h.m_index].dense_index] : nullptr; }
+
+	const value_type *find(handle h) const noexcept {
+		return contains(h) ? &m_values[m_slots[h.m_index].dense_index] : nullptr;
+	}
+
+	value_type &operator[](handle h) noexcept {
+		assert(contains(h));
+		return m_values[m_slots[h.m_index].dense_index];
+	}
+
+	const value_type &operator[](handle h) const noexcept {
+		assert(contains(h));
+		return m_values[m_slots[h.m_index].dense_index];
+	}
+
+	/**
+	 * @returns The object the given handle refers to (as a base-class reference)
+	 */
+	Base &get(handle h) noexcept { return (*this)[h].get(); }
+	const Base &get(handle h) const noexcept { return (*this)[h].get(); }
+
+	/**
+	 * @returns The handle of the object at the given position of the dense storage
+	 */
+	handle handle_at(std::size_t pos) const noexcept {
+		assert(pos < m_values.size());
+		const std::uint32_t slot_index = m_dense_slots[pos];
+
+		return handle(slot_index, m_slots[slot_index].generation);
+	}
+
+	iterator begin() noexcept { return m_values.begin(); }
+	iterator end() noexcept { return m_values.end(); }
+	const_iterator begin() const noexcept { return m_values.begin(); }
+	const_iterator end() const noexcept { return m_values.end(); }
+
+	value_type *data() noexcept { return m_values.data(); }
+	const value_type *data() const noexcept { return m_values.data(); }
+
+	void reserve(std::size_t count) {
+		m_values.reserve(count);
+		m_dense_slots.reserve(count);
+		m_slots.reserve(count);
+	}
+
+	/**
+	 * Erases all objects (invalidating all handles)
+	 */
+	void clear() noexcept {
+		for (std::uint32_t slot_index : m_dense_slots) {
+			release_slot(slot_index);
+		}
+
+		m_values.clear();
+		m_dense_slots.clear();
+	}
+
+	std::size_t size() const noexcept { return m_values.size(); }
+	bool empty() const noexcept { return m_values.empty(); }
+
+private:
+	static constexpr std::uint32_t no_slot = handle::invalid_index;
+
+	struct slot {
+		// Position of the object in the dense storage (or the next free slot, if this slot is free)
+		std::uint32_t dense_index;
+		std::uint32_t generation;
+	};
+
+	// Assigns a slot to the object that has just been appended to the dense storage
+	handle register_last() {
+		try {
+			if (m_free_head == no_slot) {
+				if (m_slots.size() >= no_slot) {
+					throw std::length_error("slot_map: Too many objects");
+				}
+
+				m_slots.push_back({ no_slot, 0 });
+				m_free_head = static_cast< std::uint32_t >(m_slots.size() - 1);
+			}
+
+			m_dense_slots.push_back(m_free_head);
+		} catch (...) {
+			m_values.pop_back();
+			throw;
+		}
+
+		const std::uint32_t slot_index = m_free_head;
+		slot &current                  = m_slots[slot_index];
+
+		m_free_head         = current.dense_index;
+		current.dense_index = static_cast< std::uint32_t >(m_values.size() - 1);
+
+		return handle(slot_index, current.generation);
+	}
+
+	void release_slot(std::uint32_t slot_index) noexcept {
+		slot &released = m_slots[slot_index];
+
+		++released.generation;
+		released.dense_index = m_free_head;
+		m_free_head          = slot_index;
+	}
+
+	std::vector< value_type > m_values;
+	// The slot index of every object in m_values
+	std::vector< std::uint32_t > m_dense_slots;
+	std::vector< slot > m_slots;
+	std::uint32_t m_free_head = no_slot;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::slot_handle;
+	using details::slot_map;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_SLOT_MAP_HPP_
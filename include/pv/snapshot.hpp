@@ -0,0 +1,308 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_SNAPSHOT_HPP_
+#define PV_SNAPSHOT_HPP_
+
+#include "pv/pv.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Restamping vtable pointers relies on the Itanium C++ ABI (primary vtable pointer at offset 0) and mapping files
+// relies on POSIX
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__unix__) || defined(__APPLE__))
+#	define PV_SNAPSHOT_SUPPORTED
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace pv {
+
+/**
+ * Has to be specialized (deriving from std::true_type) for every type that is to be stored in a snapshot. By doing so,
+ * one asserts that objects of type T can be relocated to a different process by copying their bytes, except for their
+ * vtable pointer. In particular, T must
+ * - not contain pointers, references or handles to any other memory or resources (e.g. no std::string members)
+ * - only contain a single vtable pointer (i.e. no polymorphic members and no polymorphic base classes other than the
+ *   chain of primary base classes)
+ * - be default-constructible (a default-constructed object serves as the prototype for restoring the vtable pointer)
+ */
+template< typename T > struct snapshot_relocatable : std::false_type {};
+
+template< typename T > constexpr bool snapshot_relocatable_v = snapshot_relocatable< T >::value;
+
+} // namespace pv
+
+namespace pv::details {
+
+struct snapshot_header {
+	static constexpr std::array< char, 8 > expected_magic = { 'P', 'V', 'S', 'N', 'A', 'P', '0', '1' };
+
+	std::array< char, 8 > magic = expected_magic;
+	// Identifies the layout of the stored polymorphic_variant instantiation
+	std::uint64_t layout_fingerprint = 0;
+	std::uint64_t element_count      = 0;
+	// Offset of the first element from the start of the file
+	std::uint64_t data_offset = 0;
+};
+
+template< typename Base, typename... Types > struct snapshot_layout {
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	static_assert(sizeof...(Types) > 0);
+	static_assert((snapshot_relocatable_v< Types > && ...),
+				  "pv::snapshot_relocatable must be specialized for all types stored in a snapshot");
+	static_assert((std::is_polymorphic_v< Types > && ...), "Snapshots only support polymorphic types");
+	static_assert((std::is_default_constructible_v< Types > && ...),
+				  "Types stored in a snapshot have to be default-constructible");
+
+	static constexpr std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+		return (hash ^ value) * std::uint64_t{ 0x100000001b3 };
+	}
+
+	/**
+	 * A hash over the sizes and alignments of the variant and all its alternatives
+	 */
+	static constexpr std::uint64_t fingerprint() {
+		std::uint64_t hash = std::uint64_t{ 0xcbf29ce484222325 };
+		hash               = mix(hash, sizeof(value_type));
+		hash               = mix(hash, alignof(value_type));
+		hash               = mix(hash, sizeof...(Types));
+		((hash = mix(mix(hash, sizeof(Types)), alignof(Types))), ...);
+
+		return hash;
+	}
+
+	static constexpr std::uint64_t data_offset() {
+		constexpr std::uint64_t alignment = alignof(value_type) > 64 ? alignof(value_type) : 64;
+
+		return (sizeof(snapshot_header) + alignment - 1) / alignment * alignment;
+	}
+};
+
+/**
+ * Writes the given elements to a snapshot file that can be mapped into memory via mapped_snapshot. The file can only
+ * be loaded by programs using the same polymorphic_variant instantiation and the same layout of all types.
+ */
+template< typename Base, typename... Types >
+void write_snapshot(const std::string &path, const polymorphic_variant< Base, Types... > *elements, std::size_t count) {
+	using layout = snapshot_layout< Base, Types... >;
+
+	snapshot_header header;
+	header.layout_fingerprint = layout::fingerprint();
+	header.element_count      = count;
+	header.data_offset        = layout::data_offset();
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (!stream) {
+		throw std::runtime_error("Failed to open snapshot file \"" + path + "\" for writing");
+	}
+
+	const std::vector< char > padding(header.data_offset - sizeof(snapshot_header), 0);
+
+	stream.write(reinterpret_cast< const char * >(&header), sizeof(header));
+	stream.write(padding.data(), static_cast< std::streamsize >(padding.size()));
+	stream.write(reinterpret_cast< const char * >(elements),
+				 static_cast< std::streamsize >(count * sizeof(polymorphic_variant< Base, Types... >)));
+
+	if (!stream.flush()) {
+		throw std::runtime_error("Failed to write snapshot file \"" + path + "\"");
+	}
+}
+
+template< typename Base, typename... Types >
+void write_snapshot(const std::string &path, const std::vector< polymorphic_variant< Base, Types... > > &elements) {
+	write_snapshot(path, elements.data(), elements.size());
+}
+
+#ifdef PV_SNAPSHOT_SUPPORTED
+
+/**
+ * A snapshot file (see write_snapshot) that is mapped into memory. Loading doesn't copy any elements. Instead, the
+ * vtable pointer of every element is restored in place from the element's type index. The mapping is private, so
+ * modifying the elements doesn't modify the file (and only pages whose vtable pointers actually had to be restored
+ * are copied in memory).
+ *
+ * The destructors of the elements are never invoked.
+ */
+template< typename Base, typename... Types > class mapped_snapshot {
+public:
+	using value_type = polymorphic_variant< Base, Types... >;
+
+	explicit mapped_snapshot(const std::string &path) {
+		using layout = snapshot_layout< Base, Types... >;
+
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to open snapshot file \"" + path + "\"");
+		}
+
+		struct stat info = {};
+		if (::fstat(fd, &info) != 0) {
+			const int error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "Failed to stat snapshot file \"" + path + "\"");
+		}
+
+		m_mapping_size = static_cast< std::size_t >(info.st_size);
+		if (m_mapping_size < sizeof(snapshot_header)) {
+			::close(fd);
+			throw std::runtime_error("\"" + path + "\" is not a snapshot file");
+		}
+
+		m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		::close(fd);
+
+		if (m_mapping == MAP_FAILED) {
+			m_mapping = nullptr;
+			throw std::system_error(errno, std::generic_category(), "Failed to map snapshot file \"" + path + "\"");
+		}
+
+		try {
+			snapshot_header header;
+			std::memcpy(&header, m_mapping, sizeof(header));
+
+			if (header.magic != snapshot_header::expected_magic) {
+				throw std::runtime_error("\"" + path + "\" is not a snapshot file");
+			}
+			if (header.layout_fingerprint != layout::fingerprint() || header.data_offset != layout::data_offset()) {
+				throw std::runtime_error("Snapshot file \"" + path + "\" has been written for a different type");
+			}
+			if (m_mapping_size < header.data_offset) {
+				throw std::runtime_error("Snapshot file \"" + path + "\" is truncated");
+			}
+			if (header.element_count > (m_mapping_size - header.data_offset) / sizeof(value_type)) {
+				throw std::runtime_error("Snapshot file \"" + path + "\" is truncated");
+			}
+
+			unsigned char *data = static_cast< unsigned char * >(m_mapping) + header.data_offset;
+
+			m_elements = reinterpret_cast< value_type * >(data);
+			m_size     = static_cast< std::size_t >(header.element_count);
+
+			restamp();
+		} catch (...) {
+			unmap();
+			throw;
+		}
+	}
+
+	mapped_snapshot(const mapped_snapshot &) = delete;
+	mapped_snapshot &operator=(const mapped_snapshot &) = delete;
+
+	mapped_snapshot(mapped_snapshot &&other) noexcept
+		: m_mapping(std::exchange(other.m_mapping, nullptr)), m_mapping_size(std::exchange(other.m_mapping_size, 0)),
+		  m_elements(std::exchange(other.m_elements, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+	mapped_snapshot &operator=(mapped_snapshot &&other) noexcept {
+		if (this != &other) {
+			unmap();
+
+			m_mapping      = std::exchange(other.m_mapping, nullptr);
+			m_mapping_size = std::exchange(other.m_mapping_size, 0);
+			m_elements     = std::exchange(other.m_elements, nullptr);
+			m_size         = std::exchange(other.m_size, 0);
+		}
+
+		return *this;
+	}
+
+	~mapped_snapshot() { unmap(); }
+
+	std::size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	value_type *data() noexcept { return m_elements; }
+	const value_type *data() const noexcept { return m_elements; }
+
+	value_type &operator[](std::size_t pos) noexcept { return m_elements[pos]; }
+	const value_type &operator[](std::size_t pos) const noexcept { return m_elements[pos]; }
+
+	value_type *begin() noexcept { return m_elements; }
+	value_type *end() noexcept { return m_elements + m_size; }
+	const value_type *begin() const noexcept { return m_elements; }
+	const value_type *end() const noexcept { return m_elements + m_size; }
+
+private:
+	using vptr_type = const void *;
+
+	template< typename T > static vptr_type prototype_vptr() {
+		static const vptr_type vptr = [] {
+			alignas(T) unsigned char buffer[sizeof(T)];
+			T *prototype = ::new (buffer) T();
+
+			vptr_type result;
+			std::memcpy(&result, prototype, sizeof(result));
+			prototype->~T();
+
+			return result;
+		}();
+
+		return vptr;
+	}
+
+	void restamp() {
+		for (std::size_t i = 0; i < m_size; ++i) {
+			if (m_elements[i].index() >= sizeof...(Types)) {
+				throw std::runtime_error("Snapshot contains an invalid element");
+			}
+
+			// The element's vtable pointer is invalid at this point, so the stored object is only located (no virtual
+			// function is called on it)
+			m_elements[i].visit([](auto &object) {
+				const vptr_type vptr = prototype_vptr< std::decay_t< decltype(object) > >();
+
+				// Only write if necessary in order to avoid copying pages that are already correct
+				if (std::memcmp(std::addressof(object), &vptr, sizeof(vptr)) != 0) {
+					std::memcpy(static_cast< void * >(std::addressof(object)), &vptr, sizeof(vptr));
+				}
+			});
+		}
+	}
+
+	void unmap() noexcept {
+		if (m_mapping) {
+			::munmap(m_mapping, m_mapping_size);
+			m_mapping = nullptr;
+		}
+	}
+
+	void *m_mapping            = nullptr;
+	std::size_t m_mapping_size = 0;
+	value_type *m_elements     = nullptr;
+	std::size_t m_size         = 0;
+};
+
+#endif // PV_SNAPSHOT_SUPPORTED
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::write_snapshot;
+#ifdef PV_SNAPSHOT_SUPPORTED
+	using details::mapped_snapshot;
+#endif
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_SNAPSHOT_HPP_
@@ -0,0 +1,203 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_STATIC_POLYMORPHIC_VARIANT_HPP_
+#define PV_STATIC_POLYMORPHIC_VARIANT_HPP_
+
+#include "pv/details/switch_visit.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * Declares a member function of an interface (see pv::static_interface) that forwards all arguments to the member
+ * function of the same name of the object that is currently stored in the static_polymorphic_variant. Each of the
+ * alternatives has to provide a function of that name whose return type is the same for all alternatives.
+ */
+#define PV_INTERFACE_FUNCTION(name)                                                                                   \
+	template< typename... Args > decltype(auto) name(Args &&... args) {                                              \
+		return this->self().visit(                                                                                    \
+			[&](auto &object) -> decltype(auto) { return object.name(std::forward< Args >(args)...); });             \
+	}                                                                                                                 \
+	template< typename... Args > decltype(auto) name(Args &&... args) const {                                        \
+		return this->self().visit(                                                                                    \
+			[&](const auto &object) -> decltype(auto) { return object.name(std::forward< Args >(args)...); });       \
+	}
+
+namespace pv::details {
+
+/**
+ * Base class for the interfaces of static_polymorphic_variant. An interface is a class template taking the variant type
+ * (Self) as its only template parameter, which derives from static_interface< Self > and declares the functions that
+ * all alternatives provide - either via PV_INTERFACE_FUNCTION or by hand, using self().visit(...). E.g.
+ *
+ * template< typename Self > struct ShapeInterface : pv::static_interface< Self > {
+ *     PV_INTERFACE_FUNCTION(area)
+ * };
+ *
+ * Interfaces must not have any data members.
+ */
+template< typename Self > class static_interface {
+protected:
+	constexpr Self &self() noexcept { return static_cast< Self & >(*this); }
+	constexpr const Self &self() const noexcept { return static_cast< const Self & >(*this); }
+};
+
+/**
+ * A variant that supports calling functions that all of its alternatives provide without any of them being virtual.
+ * Instead of a common base class, the set of functions is described by Interface (see static_interface) and every call
+ * is dispatched to the currently stored type via a switch statement over the type index. Thus, the alternatives don't
+ * need a vtable pointer (or a common base class) and calls can be inlined.
+ *
+ * As for polymorphic_variant, the functions of the interface are accessed via operator->. As the interface is a base
+ * class of the variant, they can also be called directly on the variant.
+ */
+template< template< typename > class Interface, typename... Types >
+class static_polymorphic_variant : public Interface< static_polymorphic_variant< Interface, Types... > > {
+public:
+	using variant_type   = std::variant< Types... >;
+	using interface_type = Interface< static_polymorphic_variant< Interface, Types... > >;
+
+private:
+	template< typename T >
+	static constexpr bool
+		is_wrapped_type = (std::is_same_v< std::remove_cv_t< std::remove_reference_t< T > >, Types > || ...);
+
+	template< typename T > using enable_if_wrapped_type = std::enable_if_t< is_wrapped_type< T > >;
+
+public:
+	static_assert(sizeof...(Types) > 0, "Must provide at least one explicit sub-type");
+	static_assert((!std::is_reference_v< Types > && ...), "None of the types may be given as a reference");
+	static_assert((!std::is_pointer_v< Types > && ...), "None of the types may be given as a pointer");
+	static_assert(std::is_empty_v< interface_type >, "The interface must not have any data members");
+
+	constexpr static_polymorphic_variant() = default;
+
+	constexpr static_polymorphic_variant(const static_polymorphic_variant &other) = default;
+	constexpr static_polymorphic_variant(static_polymorphic_variant &&other)      = default;
+
+	// Constructor taking one of Types
+	template< typename T, typename = enable_if_wrapped_type< T > >
+	constexpr static_polymorphic_variant(T &&t) : m_variant(std::forward< T >(t)) {}
+
+	// Constructor creating one of Types in-place from given arguments
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	constexpr explicit static_polymorphic_variant(std::in_place_type_t< T >, Args &&... args)
+		: m_variant(std::in_place_type_t< T >{}, std::forward< Args >(args)...) {}
+
+	// Constructor creating one of Types in-place from given initializer list and arguments
+	template< typename T, typename U, typename... Args, typename = enable_if_wrapped_type< T > >
+	constexpr explicit static_polymorphic_variant(std::in_place_type_t< T >, std::initializer_list< U > il,
+												  Args &&... args)
+		: m_variant(std::in_place_type_t< T >{}, il, std::forward< Args >(args)...) {}
+
+	constexpr static_polymorphic_variant &operator=(const static_polymorphic_variant &rhs) = default;
+	constexpr static_polymorphic_variant &operator=(static_polymorphic_variant &&rhs)      = default;
+
+	template< typename T, typename = enable_if_wrapped_type< T > > static_polymorphic_variant &operator=(T &&t) {
+		m_variant = std::forward< T >(t);
+
+		return *this;
+	}
+
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > > T &emplace(Args &&... args) {
+		return m_variant.template emplace< T >(std::forward< Args >(args)...);
+	}
+
+	/**
+	 * @returns The interface through which the functions common to all alternatives can be called
+	 */
+	constexpr interface_type *operator->() noexcept { return this; }
+
+	/**
+	 * @returns The interface through which the functions common to all alternatives can be called
+	 */
+	constexpr const interface_type *operator->() const noexcept { return this; }
+
+	/**
+	 * @returns The index of the currently stored type (see std::variant::index)
+	 */
+	constexpr std::size_t index() const noexcept { return m_variant.index(); }
+
+	/**
+	 * @returns A pointer to the currently stored object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > constexpr std::add_pointer_t< T > get_if() noexcept { return std::get_if< T >(&m_variant); }
+
+	/**
+	 * @returns A pointer to the currently stored object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > constexpr std::add_pointer_t< const T > get_if() const noexcept {
+		return std::get_if< T >(&m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object. Just like for std::visit, the visitor has to return
+	 * the same type for all alternatives.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) & {
+		return switch_visit(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object. Just like for std::visit, the visitor has to return
+	 * the same type for all alternatives.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) const & {
+		return switch_visit(std::forward< Visitor >(visitor), m_variant);
+	}
+
+	/**
+	 * Invokes the given visitor with the currently stored object. Just like for std::visit, the visitor has to return
+	 * the same type for all alternatives.
+	 */
+	template< typename Visitor > constexpr decltype(auto) visit(Visitor &&visitor) && {
+		return switch_visit(std::forward< Visitor >(visitor), std::move(m_variant));
+	}
+
+	void swap(static_polymorphic_variant &rhs) { m_variant.swap(rhs.m_variant); }
+
+private:
+	variant_type m_variant;
+};
+
+/**
+ * Invokes the given visitor with the object stored in the given static_polymorphic_variant
+ */
+template< typename Visitor, template< typename > class Interface, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, static_polymorphic_variant< Interface, Types... > &variant) {
+	return variant.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given static_polymorphic_variant
+ */
+template< typename Visitor, template< typename > class Interface, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, const static_polymorphic_variant< Interface, Types... > &variant) {
+	return variant.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object stored in the given static_polymorphic_variant
+ */
+template< typename Visitor, template< typename > class Interface, typename... Types >
+constexpr decltype(auto) visit(Visitor &&visitor, static_polymorphic_variant< Interface, Types... > &&variant) {
+	return std::move(variant).visit(std::forward< Visitor >(visitor));
+}
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::static_interface;
+	using details::static_polymorphic_variant;
+	using details::visit;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_STATIC_POLYMORPHIC_VARIANT_HPP_
@@ -0,0 +1,259 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_STATIC_VECTOR_HPP_
+#define PV_STATIC_VECTOR_HPP_
+
+#include "pv/pv.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace pv {
+
+/**
+ * Can be specialized (deriving from std::true_type) for types that can be relocated (i.e. moved to a new location
+ * followed by the destruction of the original object) by simply copying their bytes. This is the case for most types
+ * that don't store pointers to themselves - including polymorphic types, whose vtable pointer doesn't depend on the
+ * object's location. Containers use this in order to relocate elements via memcpy/memmove.
+ *
+ * By default, only trivially copyable types are considered trivially relocatable. Polymorphic types are never
+ * trivially copyable, so they have to opt in explicitly by specializing this template.
+ *
+ * A polymorphic_variant is trivially relocatable if all of its alternatives are.
+ */
+template< typename T > struct trivially_relocatable : std::is_trivially_copyable< T > {};
+
+template< typename Base, typename... Types >
+struct trivially_relocatable< polymorphic_variant< Base, Types... > >
+	: std::conjunction< trivially_relocatable< Types >... > {};
+
+template< typename T > constexpr bool trivially_relocatable_v = trivially_relocatable< T >::value;
+
+} // namespace pv
+
+namespace pv::details {
+
+/**
+ * A vector of polymorphic_variant objects with a fixed capacity of N elements that are stored inline (i.e. inside the
+ * static_vector object itself). It never allocates memory, which makes its worst-case behavior known up front. Adding
+ * an element to a full static_vector throws std::length_error.
+ *
+ * If the elements are trivially relocatable (see pv::trivially_relocatable), moving the vector and erasing elements
+ * relocates the elements via memcpy/memmove instead of move-constructing and destroying them one by one.
+ */
+template< typename Base, std::size_t N, typename... Types > class static_vector {
+public:
+	using value_type      = polymorphic_variant< Base, Types... >;
+	using size_type       = std::size_t;
+	using reference       = value_type &;
+	using const_reference = const value_type &;
+	using iterator        = value_type *;
+	using const_iterator  = const value_type *;
+
+	static_assert(N > 0, "A static_vector must have a non-zero capacity");
+
+	static_vector() = default;
+
+	static_vector(std::initializer_list< value_type > values) { push_back_all(values.begin(), values.end()); }
+
+	static_vector(const static_vector &other) { push_back_all(other.begin(), other.end()); }
+
+	/**
+	 * Moves all elements of the given vector into this one, leaving the other vector empty
+	 */
+	static_vector(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v< value_type >) {
+		take_elements(other);
+	}
+
+	static_vector &operator=(const static_vector &other) {
+		if (this != &other) {
+			clear();
+			push_back_all(other.begin(), other.end());
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Replaces the elements of this vector with the ones of the given vector, leaving the other vector empty
+	 */
+	static_vector &operator=(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v< value_type >) {
+		if (this != &other) {
+			clear();
+			take_elements(other);
+		}
+
+		return *this;
+	}
+
+	~static_vector() { clear(); }
+
+	static constexpr size_type capacity() noexcept { return N; }
+	static constexpr size_type max_size() noexcept { return N; }
+
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+	bool full() const noexcept { return m_size == N; }
+
+	reference operator[](size_type pos) noexcept {
+		assert(pos < m_size);
+		return data()[pos];
+	}
+
+	const_reference operator[](size_type pos) const noexcept {
+		assert(pos < m_size);
+		return data()[pos];
+	}
+
+	reference at(size_type pos) {
+		if (pos >= m_size) {
+			throw std::out_of_range("static_vector: Index out of range");
+		}
+
+		return data()[pos];
+	}
+
+	const_reference at(size_type pos) const {
+		if (pos >= m_size) {
+			throw std::out_of_range("static_vector: Index out of range");
+		}
+
+		return data()[pos];
+	}
+
+	/**
+	 * Gets the element at the given position as a (mutable) base-class reference
+	 */
+	Base &get(size_type pos) noexcept { return (*this)[pos].get(); }
+
+	/**
+	 * Gets the element at the given position as a base-class reference
+	 */
+	const Base &get(size_type pos) const noexcept { return (*this)[pos].get(); }
+
+	reference front() noexcept { return (*this)[0]; }
+	const_reference front() const noexcept { return (*this)[0]; }
+	reference back() noexcept { return (*this)[m_size - 1]; }
+	const_reference back() const noexcept { return (*this)[m_size - 1]; }
+
+	value_type *data() noexcept { return std::launder(reinterpret_cast< value_type * >(m_storage)); }
+	const value_type *data() const noexcept { return std::launder(reinterpret_cast< const value_type * >(m_storage)); }
+
+	iterator begin() noexcept { return data(); }
+	iterator end() noexcept { return data() + m_size; }
+	const_iterator begin() const noexcept { return data(); }
+	const_iterator end() const noexcept { return data() + m_size; }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	void push_back(const value_type &value) { ::new (next_slot()) value_type(value); ++m_size; }
+
+	void push_back(value_type &&value) { ::new (next_slot()) value_type(std::move(value)); ++m_size; }
+
+	/**
+	 * Constructs an object of type T from the given arguments in place at the end of the vector
+	 */
+	template< typename T, typename... Args > T &emplace_back(Args &&... args) {
+		value_type *element =
+			::new (next_slot()) value_type(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+		++m_size;
+
+		return *element->template get_if< T >();
+	}
+
+	void pop_back() noexcept {
+		assert(m_size > 0);
+		data()[--m_size].~value_type();
+	}
+
+	/**
+	 * Removes the element at the given position (preserving the order of the remaining elements)
+	 */
+	void erase(size_type pos) {
+		assert(pos < m_size);
+		value_type *elements = data();
+
+		if constexpr (trivially_relocatable_v< value_type >) {
+			elements[pos].~value_type();
+			std::memmove(static_cast< void * >(elements + pos), static_cast< const void * >(elements + pos + 1),
+						 (m_size - pos - 1) * sizeof(value_type));
+			--m_size;
+		} else {
+			for (size_type i = pos; i + 1 < m_size; ++i) {
+				elements[i] = std::move(elements[i + 1]);
+			}
+			pop_back();
+		}
+	}
+
+	void clear() noexcept {
+		value_type *elements = data();
+		for (size_type i = 0; i < m_size; ++i) {
+			elements[i].~value_type();
+		}
+
+		m_size = 0;
+	}
+
+private:
+	void *next_slot() {
+		if (m_size == N) {
+			throw std::length_error("static_vector: Capacity exceeded");
+		}
+
+		return static_cast< void * >(m_storage + m_size * sizeof(value_type));
+	}
+
+	/**
+	 * Appends the given elements. If constructing one of them fails, all elements are destroyed (as the destructor
+	 * doesn't run for a vector whose constructor throws).
+	 */
+	template< typename Iterator > void push_back_all(Iterator first, Iterator last) {
+		try {
+			for (; first != last; ++first) {
+				push_back(*first);
+			}
+		} catch (...) {
+			clear();
+			throw;
+		}
+	}
+
+	void take_elements(static_vector &other) noexcept(std::is_nothrow_move_constructible_v< value_type >) {
+		assert(empty());
+
+		if constexpr (trivially_relocatable_v< value_type >) {
+			std::memcpy(static_cast< void * >(m_storage), static_cast< const void * >(other.m_storage),
+						other.m_size * sizeof(value_type));
+			m_size       = other.m_size;
+			other.m_size = 0;
+		} else {
+			push_back_all(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+			other.clear();
+		}
+	}
+
+	alignas(value_type) unsigned char m_storage[N * sizeof(value_type)];
+	size_type m_size = 0;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::static_vector;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_STATIC_VECTOR_HPP_
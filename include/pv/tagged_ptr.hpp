@@ -0,0 +1,424 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_TAGGED_PTR_HPP_
+#define PV_TAGGED_PTR_HPP_
+
+#include "pv/details/switch_visit.hpp"
+#include "pv/details/variadic_parameter_helper.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace pv::details {
+
+namespace {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+	// User-space addresses don't use more than 48 bits on these platforms, unless the process opted into a larger
+	// address space (e.g. 5-level paging on x86-64 or 52-bit virtual addresses on ARM). The topmost byte is left
+	// alone, as it might be used by hardware pointer tagging (e.g. ARM's memory tagging extension).
+	static constexpr bool use_high_pointer_bits = true;
+#else
+	static constexpr bool use_high_pointer_bits = false;
+#endif
+} // namespace
+
+/**
+ * Whether a pointer to Base can be converted to a pointer to T via static_cast (which is not the case, if T inherits
+ * Base virtually)
+ */
+template< typename Base, typename T, typename = void > struct is_static_downcastable : std::false_type {};
+template< typename Base, typename T >
+struct is_static_downcastable< Base, T, std::void_t< decltype(static_cast< T * >(std::declval< Base * >())) > >
+	: std::true_type {};
+
+/**
+ * An owning pointer to a heap-allocated object of one of Types (similar to std::unique_ptr< Base >), which stores the
+ * index of the object's type within Types in the otherwise unused bits of the pointer. Hence, it is no larger than a
+ * plain pointer (as long as the allocator is stateless), but the type of the pointed-to object is known without
+ * dereferencing the pointer. This allows for typed access (get_if, holds_alternative) and for visiting the object as
+ * its concrete type (which allows the compiler to devirtualize calls) based on the index alone.
+ *
+ * The index is stored in the lowest bits, which are always zero due to the alignment of Base, if Base's alignment
+ * allows for enough distinct values. Otherwise, it is stored in bits 48 to 55 on 64-bit platforms on which these are
+ * usually unused. This requires all objects to be allocated below 2^48, which doesn't hold for processes that use a
+ * larger address space (e.g. with 5-level paging). This is asserted whenever a pointer is tagged.
+ *
+ * The objects are allocated via the given allocator (rebound to the respective type). As for allocator-aware
+ * containers, the allocator is only propagated on move assignment and swap if the allocator requests it.
+ */
+template< typename Alloc, typename Base, typename... Types > class basic_tagged_ptr {
+public:
+	using allocator_type = Alloc;
+	using base_type      = std::decay_t< Base >;
+
+private:
+	template< typename T >
+	static constexpr bool
+		is_wrapped_type = (std::is_same_v< std::remove_cv_t< std::remove_reference_t< T > >, Types > || ...);
+
+	template< typename T > using enable_if_wrapped_type = std::enable_if_t< is_wrapped_type< T > >;
+
+	template< typename T > using allocator_for = typename std::allocator_traits< Alloc >::template rebind_alloc< T >;
+
+	template< std::size_t Index > using alternative_t = std::variant_alternative_t< Index, std::variant< Types... > >;
+
+	using allocator_traits = std::allocator_traits< Alloc >;
+
+	static constexpr bool use_low_bits = sizeof...(Types) <= alignof(base_type);
+
+	static constexpr unsigned int tag_shift = use_low_bits ? 0 : 48;
+
+	static constexpr std::uintptr_t tag_mask =
+		use_low_bits ? alignof(base_type) - 1 : static_cast< std::uintptr_t >(0xFF) << tag_shift;
+
+public:
+	static_assert(sizeof...(Types) > 0, "Must provide at least one explicit sub-type");
+	static_assert(!std::is_reference_v< Base >, "Base must not be given as a reference");
+	static_assert(!std::is_pointer_v< Base >, "Base must not be given as a pointer");
+	static_assert((!std::is_reference_v< Types > && ...), "None of the types may be given as a reference");
+	static_assert((!std::is_pointer_v< Types > && ...), "None of the types may be given as a pointer");
+	static_assert((std::is_convertible_v< Types &, Base & > && ...), "All types must publicly inherit from Base");
+	static_assert((is_static_downcastable< base_type, Types >::value && ...),
+				  "None of the types may inherit Base virtually");
+	static_assert(use_low_bits || (use_high_pointer_bits && sizeof...(Types) <= 256),
+				  "Too many types for the bits available for the type index on this platform");
+
+	// Creates a null pointer
+	basic_tagged_ptr() = default;
+
+	// Creates a null pointer
+	basic_tagged_ptr(std::nullptr_t) noexcept {}
+
+	// Creates a null pointer that uses the given allocator
+	explicit basic_tagged_ptr(const allocator_type &alloc) noexcept : m_storage(alloc) {}
+
+	basic_tagged_ptr(const basic_tagged_ptr &other) = delete;
+
+	basic_tagged_ptr(basic_tagged_ptr &&other) noexcept
+		: m_storage(std::move(other.allocator()), std::exchange(other.m_storage.bits, 0)) {}
+
+	// Constructor moving or copying the given object to the heap
+	template< typename T, typename = enable_if_wrapped_type< T > >
+	basic_tagged_ptr(T &&t) : basic_tagged_ptr(std::in_place_type_t< std::decay_t< T > >{}, std::forward< T >(t)) {}
+
+	// Constructor creating one of Types on the heap from the given arguments
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	explicit basic_tagged_ptr(std::in_place_type_t< T >, Args &&... args) {
+		m_storage.bits = create< T >(allocator(), std::forward< Args >(args)...);
+	}
+
+	// Constructor creating one of Types on the heap from the given arguments, using the given allocator
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > >
+	basic_tagged_ptr(std::allocator_arg_t, const allocator_type &alloc, std::in_place_type_t< T >, Args &&... args)
+		: m_storage(alloc) {
+		m_storage.bits = create< T >(allocator(), std::forward< Args >(args)...);
+	}
+
+	~basic_tagged_ptr() { destroy(m_storage.bits); }
+
+	basic_tagged_ptr &operator=(const basic_tagged_ptr &other) = delete;
+
+	basic_tagged_ptr &operator=(basic_tagged_ptr &&other) noexcept(
+		allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value) {
+		if (this == &other) {
+			return *this;
+		}
+
+		// other might be owned by the current pointee (e.g. p = std::move(p->child)), so everything that is needed from
+		// it has to be taken before the current pointee is destroyed
+		if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+			allocator_type alloc(std::move(other.allocator()));
+			const std::uintptr_t bits = std::exchange(other.m_storage.bits, 0);
+
+			destroy(std::exchange(m_storage.bits, 0));
+			allocator()    = std::move(alloc);
+			m_storage.bits = bits;
+		} else if (allocator() == other.allocator()) {
+			destroy(std::exchange(m_storage.bits, std::exchange(other.m_storage.bits, 0)));
+		} else {
+			// The object has to be moved into memory obtained from this object's allocator. It is created before the
+			// current object is destroyed, so that both pointers are left untouched if this throws.
+			std::uintptr_t bits = 0;
+			if (other) {
+				bits = std::move(other).visit([this](auto &&value) {
+					return create< std::decay_t< decltype(value) > >(allocator(), std::move(value));
+				});
+			}
+
+			other.reset();
+			destroy(std::exchange(m_storage.bits, bits));
+		}
+
+		return *this;
+	}
+
+	basic_tagged_ptr &operator=(std::nullptr_t) noexcept {
+		reset();
+
+		return *this;
+	}
+
+	/**
+	 * Replaces the pointed-to object (if any) with a T created from the given arguments. If the construction throws,
+	 * the current object is kept.
+	 */
+	template< typename T, typename... Args, typename = enable_if_wrapped_type< T > > T &emplace(Args &&... args) {
+		const std::uintptr_t bits = create< T >(allocator(), std::forward< Args >(args)...);
+
+		destroy(std::exchange(m_storage.bits, bits));
+
+		return *static_cast< T * >(base_pointer());
+	}
+
+	/**
+	 * Destroys the pointed-to object (if any)
+	 */
+	void reset() noexcept { destroy(std::exchange(m_storage.bits, 0)); }
+
+	/**
+	 * @returns A pointer to the pointed-to object (as a base-class pointer) or nullptr
+	 */
+	Base *get() noexcept { return base_pointer(); }
+
+	/**
+	 * @returns A pointer to the pointed-to object (as a base-class pointer) or nullptr
+	 */
+	const Base *get() const noexcept { return base_pointer(); }
+
+	Base *operator->() noexcept {
+		assert(*this);
+		return get();
+	}
+
+	const Base *operator->() const noexcept {
+		assert(*this);
+		return get();
+	}
+
+	Base &operator*() noexcept {
+		assert(*this);
+		return *get();
+	}
+
+	const Base &operator*() const noexcept {
+		assert(*this);
+		return *get();
+	}
+
+	explicit operator bool() const noexcept { return m_storage.bits != 0; }
+
+	/**
+	 * @returns The index of the type of the pointed-to object within Types or std::variant_npos, if this is a null
+	 * pointer
+	 */
+	std::size_t index() const noexcept { return *this ? tag() : std::variant_npos; }
+
+	/**
+	 * @returns Whether the pointed-to object is of type T (a comparison of the type index - no RTTI involved)
+	 */
+	template< typename T > bool holds_alternative() const noexcept {
+		static_assert(is_wrapped_type< T >, "T must be one of Types");
+
+		return *this && tag() == index_of_type_v< T, Types... >;
+	}
+
+	/**
+	 * @returns A pointer to the pointed-to object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > T *get_if() noexcept {
+		return holds_alternative< T >() ? static_cast< T * >(base_pointer()) : nullptr;
+	}
+
+	/**
+	 * @returns A pointer to the pointed-to object, if it is of type T or nullptr otherwise
+	 */
+	template< typename T > const T *get_if() const noexcept {
+		return holds_alternative< T >() ? static_cast< const T * >(base_pointer()) : nullptr;
+	}
+
+	/**
+	 * Invokes the given visitor with the pointed-to object (which must exist) as its concrete type
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) & {
+		return dispatch< alternative_t< 0 > & >(std::forward< Visitor >(visitor), [this](auto index) -> auto & {
+			return *static_cast< alternative_t< decltype(index)::value > * >(base_pointer());
+		});
+	}
+
+	/**
+	 * Invokes the given visitor with the pointed-to object (which must exist) as its concrete type
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) const & {
+		return dispatch< const alternative_t< 0 > & >(std::forward< Visitor >(visitor), [this](auto index) -> auto & {
+			return *static_cast< const alternative_t< decltype(index)::value > * >(base_pointer());
+		});
+	}
+
+	/**
+	 * Invokes the given visitor with the pointed-to object (which must exist) as an rvalue of its concrete type
+	 */
+	template< typename Visitor > decltype(auto) visit(Visitor &&visitor) && {
+		return dispatch< alternative_t< 0 > && >(std::forward< Visitor >(visitor), [this](auto index) -> auto && {
+			return std::move(*static_cast< alternative_t< decltype(index)::value > * >(base_pointer()));
+		});
+	}
+
+	allocator_type get_allocator() const noexcept { return allocator(); }
+
+	void swap(basic_tagged_ptr &other) noexcept {
+		if constexpr (allocator_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(allocator(), other.allocator());
+		} else {
+			assert(allocator() == other.allocator());
+		}
+
+		std::swap(m_storage.bits, other.m_storage.bits);
+	}
+
+	friend bool operator==(const basic_tagged_ptr &lhs, std::nullptr_t) noexcept { return !lhs; }
+	friend bool operator!=(const basic_tagged_ptr &lhs, std::nullptr_t) noexcept { return static_cast< bool >(lhs); }
+
+private:
+	// Derives from the allocator, so that stateless allocators don't take up any space (empty base optimization)
+	struct storage : allocator_type {
+		std::uintptr_t bits = 0;
+
+		storage() = default;
+		explicit storage(const allocator_type &alloc) noexcept : allocator_type(alloc) {}
+		storage(allocator_type &&alloc, std::uintptr_t b) noexcept : allocator_type(std::move(alloc)), bits(b) {}
+	};
+
+	allocator_type &allocator() noexcept { return m_storage; }
+	const allocator_type &allocator() const noexcept { return m_storage; }
+
+	static std::size_t tag_of(std::uintptr_t bits) noexcept {
+		return static_cast< std::size_t >((bits & tag_mask) >> tag_shift);
+	}
+
+	static base_type *pointer_of(std::uintptr_t bits) noexcept {
+		return reinterpret_cast< base_type * >(bits & ~tag_mask);
+	}
+
+	std::size_t tag() const noexcept { return tag_of(m_storage.bits); }
+
+	base_type *base_pointer() const noexcept { return pointer_of(m_storage.bits); }
+
+	/**
+	 * Creates a T via the given allocator
+	 *
+	 * @returns The tagged pointer to the created object
+	 */
+	template< typename T, typename... Args > static std::uintptr_t create(allocator_type &alloc, Args &&... args) {
+		using traits = std::allocator_traits< allocator_for< T > >;
+
+		allocator_for< T > typed_alloc(alloc);
+		T *object = traits::allocate(typed_alloc, 1);
+
+		try {
+			traits::construct(typed_alloc, object, std::forward< Args >(args)...);
+		} catch (...) {
+			traits::deallocate(typed_alloc, object, 1);
+			throw;
+		}
+
+		const std::uintptr_t address = reinterpret_cast< std::uintptr_t >(static_cast< base_type * >(object));
+		assert((use_low_bits || (address & tag_mask) == 0) && "Address exceeds 48 bits - can't store the type index");
+		assert((!use_low_bits || (address & tag_mask) == 0) && "Object isn't aligned as required by Base");
+
+		return address | (static_cast< std::uintptr_t >(index_of_type_v< T, Types... >) << tag_shift);
+	}
+
+	/**
+	 * Destroys the object the given tagged pointer points to (if any)
+	 */
+	void destroy(std::uintptr_t bits) noexcept {
+		if (bits == 0) {
+			return;
+		}
+
+		switch_index< sizeof...(Types) >(tag_of(bits), [this, bits](auto index) {
+			using type   = alternative_t< decltype(index)::value >;
+			using traits = std::allocator_traits< allocator_for< type > >;
+
+			allocator_for< type > typed_alloc(allocator());
+			type *object = static_cast< type * >(pointer_of(bits));
+
+			traits::destroy(typed_alloc, object);
+			traits::deallocate(typed_alloc, object, 1);
+		});
+	}
+
+	template< typename Visitor, typename Access, std::size_t... Indices >
+	static constexpr bool consistent_result(std::index_sequence< Indices... >) {
+		return same_invoke_result_v< Visitor,
+									 std::invoke_result_t< Access, std::integral_constant< std::size_t, Indices > >... >;
+	}
+
+	template< typename First, typename Visitor, typename Access >
+	decltype(auto) dispatch(Visitor &&visitor, Access &&access) const {
+		using result_type = std::invoke_result_t< Visitor, First >;
+		static_assert(consistent_result< Visitor, Access >(std::index_sequence_for< Types... >{}),
+					  "The visitor has to return the same type for all alternatives");
+
+		assert(*this);
+
+		return switch_index< sizeof...(Types) >(tag(), [&visitor, &access](auto index) -> result_type {
+			return std::invoke(std::forward< Visitor >(visitor), access(index));
+		});
+	}
+
+	storage m_storage;
+};
+
+/**
+ * Invokes the given visitor with the object the given basic_tagged_ptr points to as its concrete type
+ */
+template< typename Visitor, typename Alloc, typename Base, typename... Types >
+decltype(auto) visit(Visitor &&visitor, basic_tagged_ptr< Alloc, Base, Types... > &ptr) {
+	return ptr.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object the given basic_tagged_ptr points to as its concrete type
+ */
+template< typename Visitor, typename Alloc, typename Base, typename... Types >
+decltype(auto) visit(Visitor &&visitor, const basic_tagged_ptr< Alloc, Base, Types... > &ptr) {
+	return ptr.visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * Invokes the given visitor with the object the given basic_tagged_ptr points to as its concrete type
+ */
+template< typename Visitor, typename Alloc, typename Base, typename... Types >
+decltype(auto) visit(Visitor &&visitor, basic_tagged_ptr< Alloc, Base, Types... > &&ptr) {
+	return std::move(ptr).visit(std::forward< Visitor >(visitor));
+}
+
+/**
+ * A basic_tagged_ptr using std::allocator
+ */
+template< typename Base, typename... Types >
+using tagged_ptr = basic_tagged_ptr< std::allocator< Base >, Base, Types... >;
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::basic_tagged_ptr;
+	using details::tagged_ptr;
+	using details::visit;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_TAGGED_PTR_HPP_
@@ -0,0 +1,249 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#ifndef PV_TAGGED_VECTOR_HPP_
+#define PV_TAGGED_VECTOR_HPP_
+
+#include "pv/algorithm.hpp"
+#include "pv/details/tag_scan.hpp"
+#include "pv/details/variadic_parameter_helper.hpp"
+#include "pv/pv.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace pv::details {
+
+/**
+ * A vector of polymorphic_variant objects that maintains a companion index of the type stored in every element. The
+ * index is a dense array holding one byte (the alternative's index) per element, so that queries about the types of
+ * the stored elements (e.g. counting all elements of a given type) don't have to touch the (potentially large)
+ * elements themselves. The index is scanned using SIMD instructions, if the CPU supports them.
+ *
+ * In order to keep the index in sync, elements can only be modified via the base-class interface (which can't change
+ * the type of the element) or via the assign/emplace functions of this class.
+ */
+template< typename Base, typename... Types > class tagged_vector {
+public:
+	using value_type      = polymorphic_variant< Base, Types... >;
+	using size_type       = std::size_t;
+	using const_iterator  = typename std::vector< value_type >::const_iterator;
+	using const_reference = const value_type &;
+
+	static_assert(sizeof...(Types) <= 255, "The type index only supports up to 255 types");
+
+	tagged_vector() = default;
+
+	tagged_vector(std::initializer_list< value_type > values) {
+		reserve(values.size());
+		for (const value_type &current : values) {
+			push_back(current);
+		}
+	}
+
+	size_type size() const noexcept { return m_values.size(); }
+	bool empty() const noexcept { return m_values.empty(); }
+	size_type capacity() const noexcept { return m_values.capacity(); }
+
+	void reserve(size_type capacity) {
+		m_values.reserve(capacity);
+		m_tags.reserve(capacity);
+	}
+
+	void clear() noexcept {
+		m_values.clear();
+		m_tags.clear();
+	}
+
+	const_reference operator[](size_type pos) const { return m_values[pos]; }
+
+	const_reference at(size_type pos) const { return m_values.at(pos); }
+
+	/**
+	 * Gets the element at the given position as a (mutable) base-class reference
+	 */
+	Base &get(size_type pos) { return m_values[pos].get(); }
+
+	/**
+	 * Gets the element at the given position as a base-class reference
+	 */
+	const Base &get(size_type pos) const { return m_values[pos].get(); }
+
+	const_iterator begin() const noexcept { return m_values.begin(); }
+	const_iterator end() const noexcept { return m_values.end(); }
+
+	const_reference front() const { return m_values.front(); }
+	const_reference back() const { return m_values.back(); }
+
+	void push_back(const value_type &value) {
+		m_values.push_back(value);
+		push_tag(value.index());
+	}
+
+	void push_back(value_type &&value) {
+		m_values.push_back(std::move(value));
+		push_tag(m_values.back().index());
+	}
+
+	template< typename T, typename... Args > T &emplace_back(Args &&... args) {
+		m_values.emplace_back(std::in_place_type_t< T >{}, std::forward< Args >(args)...);
+		push_tag(m_values.back().index());
+
+		return *m_values.back().template get_if< T >();
+	}
+
+	/**
+	 * Appends an object of type T constructed from each element of [first, last) (see pv::append_n). The type index
+	 * of the appended elements is filled in a single operation.
+	 */
+	template< typename T, typename InputIt > void append_n(InputIt first, InputIt last) {
+		append_run< T >([&]() { details::append_n< T >(m_values, first, last); });
+	}
+
+	/**
+	 * Appends the given amount of objects of type T, each of which is constructed from the result of calling the given
+	 * generator (see pv::append_n). The type index of the appended elements is filled in a single operation.
+	 */
+	template< typename T, typename Generator > void append_n(size_type count, Generator generator) {
+		append_run< T >([&]() { details::append_n< T >(m_values, count, std::move(generator)); });
+	}
+
+	void pop_back() {
+		m_values.pop_back();
+		m_tags.pop_back();
+	}
+
+	/**
+	 * Removes the element at the given position (preserving the order of the remaining elements)
+	 */
+	void erase(size_type pos) {
+		try {
+			m_values.erase(m_values.begin() + static_cast< std::ptrdiff_t >(pos));
+		} catch (...) {
+			// The elements from pos onward might have been shifted partially and some of them might have become
+			// valueless in the process
+			m_tags.resize(m_values.size());
+			for (size_type i = pos; i < m_values.size(); ++i) {
+				sync_tag(i);
+			}
+			throw;
+		}
+		m_tags.erase(m_tags.begin() + static_cast< std::ptrdiff_t >(pos));
+	}
+
+	/**
+	 * Replaces the element at the given position with the given value
+	 */
+	template< typename Value > void assign(size_type pos, Value &&value) {
+		value_type &element = m_values.at(pos);
+
+		try {
+			element = std::forward< Value >(value);
+			sync_tag(pos);
+		} catch (...) {
+			// The element might have become valueless or hold another alternative by now
+			sync_tag(pos);
+			throw;
+		}
+	}
+
+	/**
+	 * Replaces the element at the given position with an object of type T constructed from the given arguments
+	 */
+	template< typename T, typename... Args > T &emplace(size_type pos, Args &&... args) {
+		value_type &element = m_values.at(pos);
+
+		try {
+			T &ref = element.template emplace< T >(std::forward< Args >(args)...);
+			sync_tag(pos);
+
+			return ref;
+		} catch (...) {
+			// The element might have become valueless or hold another alternative by now
+			sync_tag(pos);
+			throw;
+		}
+	}
+
+	/**
+	 * @returns The amount of elements that currently hold an object of type T (exactly - objects of subclasses of T
+	 * are not counted)
+	 */
+	template< typename T > size_type count_if_type() const {
+		return tag_scan::best_kernels().count(m_tags.data(), m_tags.size(), tag_of< T >());
+	}
+
+	/**
+	 * @returns The position of the first element that holds an object of type T or size(), if there is no such element
+	 */
+	template< typename T > size_type find_first_of_type() const {
+		return tag_scan::best_kernels().find_first(m_tags.data(), m_tags.size(), tag_of< T >());
+	}
+
+	/**
+	 * @returns The (ascending) positions of all elements that hold an object of type T
+	 */
+	template< typename T > std::vector< size_type > positions_of_type() const {
+		std::vector< size_type > positions;
+		tag_scan::best_kernels().positions(m_tags.data(), m_tags.size(), tag_of< T >(), positions);
+
+		return positions;
+	}
+
+	/**
+	 * @returns The dense array of type indices (one per element)
+	 */
+	const std::vector< std::uint8_t > &type_indices() const noexcept { return m_tags; }
+
+private:
+	template< typename T > static constexpr std::uint8_t tag_of() {
+		constexpr std::size_t index = index_of_type_v< T, Types... >;
+		static_assert(index < sizeof...(Types), "T must be one of Types");
+
+		return static_cast< std::uint8_t >(index);
+	}
+
+	template< typename T, typename Append > void append_run(Append append) {
+		const size_type previous_size = m_values.size();
+
+		try {
+			append();
+			m_tags.resize(m_values.size(), tag_of< T >());
+		} catch (...) {
+			while (m_values.size() > previous_size) {
+				m_values.pop_back();
+			}
+			throw;
+		}
+	}
+
+	void push_tag(std::size_t index) {
+		try {
+			m_tags.push_back(static_cast< std::uint8_t >(index));
+		} catch (...) {
+			m_values.pop_back();
+			throw;
+		}
+	}
+
+	void sync_tag(size_type pos) noexcept { m_tags[pos] = static_cast< std::uint8_t >(m_values[pos].index()); }
+
+	std::vector< value_type > m_values;
+	std::vector< std::uint8_t > m_tags;
+};
+
+} // namespace pv::details
+
+namespace pv {
+
+inline namespace v2 {
+	using details::tagged_vector;
+} // namespace v2
+
+} // namespace pv
+
+#endif // PV_TAGGED_VECTOR_HPP_
@@ -0,0 +1,205 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/algorithm.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual int area() const = 0;
+
+	friend bool operator<(const Shape &lhs, const Shape &rhs) { return lhs.area() < rhs.area(); }
+};
+
+class Square final : public Shape {
+public:
+	int side;
+
+	Square(int s) : side(s) {}
+
+	int area() const override { return side * side; }
+};
+
+class Rectangle final : public Shape {
+public:
+	int width;
+	int height;
+
+	Rectangle(int w, int h) : width(w), height(h) {}
+
+	int area() const override { return width * height; }
+};
+
+class Circle final : public Shape {
+public:
+	int radius;
+
+	Circle(int r) : radius(r) {}
+
+	int area() const override { return 3 * radius * radius; }
+};
+
+using shape_variant = pv::polymorphic_variant< Shape, Square, Rectangle, Circle >;
+
+std::vector< shape_variant > make_shapes() {
+	return { Circle(2), Square(3), Rectangle(1, 2), Square(1), Circle(1), Rectangle(3, 3), Square(2), Rectangle(1, 1) };
+}
+
+// Whether the given shapes are grouped by type and ordered by area within each group
+bool is_type_major_sorted(const std::vector< shape_variant > &shapes) {
+	return std::is_sorted(shapes.begin(), shapes.end(), [](const shape_variant &lhs, const shape_variant &rhs) {
+		if (lhs.index() != rhs.index()) {
+			return lhs.index() < rhs.index();
+		}
+
+		return lhs->area() < rhs->area();
+	});
+}
+
+class ThrowOnMove {
+public:
+	ThrowOnMove() = default;
+	ThrowOnMove(ThrowOnMove &&) { throw std::runtime_error("Move failed"); }
+	ThrowOnMove &operator=(ThrowOnMove &&) = default;
+
+	friend bool operator<(const ThrowOnMove &, const ThrowOnMove &) { return false; }
+};
+
+} // namespace
+
+TEST(algorithm, type_major_compare) {
+	const shape_variant small_square = Square(1);
+	const shape_variant large_square = Square(5);
+	const shape_variant rectangle    = Rectangle(1, 1);
+
+	ASSERT_LT(pv::type_major_compare(small_square, large_square), 0);
+	ASSERT_GT(pv::type_major_compare(large_square, small_square), 0);
+	ASSERT_EQ(pv::type_major_compare(small_square, shape_variant(Square(1))), 0);
+
+	// The type takes precedence over the value
+	ASSERT_LT(pv::type_major_compare(large_square, rectangle), 0);
+	ASSERT_GT(pv::type_major_compare(rectangle, small_square), 0);
+
+	// Custom comparison on the concrete types
+	const auto larger = [](const auto &lhs, const auto &rhs) { return lhs.area() > rhs.area(); };
+	ASSERT_GT(pv::type_major_compare(small_square, large_square, larger), 0);
+
+	pv::type_major_less<> less;
+	ASSERT_TRUE(less(small_square, large_square));
+	ASSERT_FALSE(less(rectangle, large_square));
+}
+
+TEST(algorithm, type_major_compare_std_variant) {
+	using variant = std::variant< int, std::string, ThrowOnMove >;
+
+	ASSERT_LT(pv::type_major_compare(variant(5), variant(std::string("a"))), 0);
+	ASSERT_GT(pv::type_major_compare(variant(std::string("b")), variant(std::string("a"))), 0);
+
+	// Valueless variants are ordered after all others
+	variant valueless(std::in_place_type_t< ThrowOnMove >{});
+	ASSERT_THROW(valueless.emplace< ThrowOnMove >(ThrowOnMove()), std::runtime_error);
+	ASSERT_TRUE(valueless.valueless_by_exception());
+
+	ASSERT_LT(pv::type_major_compare(variant(std::in_place_type_t< ThrowOnMove >{}), valueless), 0);
+	ASSERT_EQ(pv::type_major_compare(valueless, valueless), 0);
+}
+
+TEST(algorithm, partition_by_type) {
+	std::vector< shape_variant > shapes = make_shapes();
+
+	const auto offsets = pv::partition_by_type(shapes);
+	ASSERT_EQ(offsets.size(), 5u);
+	ASSERT_EQ(offsets[0], 0u);
+	ASSERT_EQ(offsets[1], 3u);
+	ASSERT_EQ(offsets[2], 6u);
+	ASSERT_EQ(offsets[3], 8u);
+	ASSERT_EQ(offsets[4], 8u);
+
+	ASSERT_TRUE(std::is_sorted(shapes.begin(), shapes.end(), [](const shape_variant &lhs, const shape_variant &rhs) {
+		return lhs.index() < rhs.index();
+	}));
+}
+
+TEST(algorithm, sort_by_type) {
+	std::vector< shape_variant > shapes = make_shapes();
+
+	pv::sort_by_type(shapes);
+	ASSERT_TRUE(is_type_major_sorted(shapes));
+	ASSERT_EQ(shapes[0].get_if< Square >()->side, 1);
+	ASSERT_EQ(shapes[2].get_if< Square >()->side, 3);
+	ASSERT_EQ(shapes[7].get_if< Circle >()->radius, 2);
+
+	// Equivalent to sorting with type_major_less
+	std::vector< shape_variant > expected = make_shapes();
+	std::sort(expected.begin(), expected.end(), pv::type_major_less<>{});
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		ASSERT_EQ(pv::type_major_compare(shapes[i], expected[i]), 0);
+	}
+
+	// Comparing on the concrete types, without going through the base class
+	pv::sort_by_type(shapes, [](const auto &lhs, const auto &rhs) { return lhs.area() > rhs.area(); });
+	ASSERT_EQ(shapes[0].get_if< Square >()->side, 3);
+
+	std::vector< shape_variant > empty;
+	pv::sort_by_type(empty);
+}
+
+TEST(algorithm, sort_permutation_by_type) {
+	const std::vector< shape_variant > shapes = make_shapes();
+
+	const std::vector< std::size_t > permutation = pv::sort_permutation_by_type(shapes);
+	ASSERT_EQ(permutation, (std::vector< std::size_t >{ 3, 6, 1, 7, 2, 5, 4, 0 }));
+
+	std::vector< shape_variant > sorted;
+	for (std::size_t index : permutation) {
+		sorted.push_back(shapes[index]);
+	}
+	ASSERT_TRUE(is_type_major_sorted(sorted));
+}
+
+TEST(algorithm, append_n) {
+	std::vector< shape_variant > shapes = { Circle(1) };
+
+	const std::vector< int > sides = { 1, 2, 3 };
+	pv::append_n< Square >(shapes, sides.begin(), sides.end());
+	ASSERT_EQ(shapes.size(), 4u);
+	ASSERT_GE(shapes.capacity(), 4u);
+
+	// Input iterators can't reserve up front
+	std::istringstream stream("4 5");
+	pv::append_n< Circle >(shapes, std::istream_iterator< int >(stream), std::istream_iterator< int >());
+
+	int width = 0;
+	pv::append_n< Rectangle >(shapes, 2, [&width]() { return Rectangle(++width, 1); });
+
+	ASSERT_EQ(shapes.size(), 8u);
+	const std::vector< int > areas = { 3, 1, 4, 9, 48, 75, 1, 2 };
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		ASSERT_EQ(shapes[i]->area(), areas[i]);
+	}
+	ASSERT_EQ(shapes[4].index(), 2u);
+	ASSERT_EQ(shapes[7].index(), 1u);
+
+	// Appending short runs keeps the geometric growth of the vector (instead of reserving the exact size every time)
+	std::vector< shape_variant > runs;
+	for (int i = 0; i < 100; ++i) {
+		pv::append_n< Square >(runs, sides.begin(), sides.begin() + 1);
+	}
+	ASSERT_EQ(runs.size(), 100u);
+	ASSERT_GT(runs.capacity(), runs.size());
+}
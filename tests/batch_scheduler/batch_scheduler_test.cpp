@@ -0,0 +1,156 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/batch_scheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#	include <sys/resource.h>
+#	include <unistd.h>
+#endif
+
+struct Task {
+	virtual ~Task() = default;
+
+	virtual void run() = 0;
+};
+
+std::array< std::atomic< int >, 3 > executed = {};
+
+template< int Id > struct CountingTask : Task {
+	void run() override { executed[Id]++; }
+};
+
+struct OrderedTask : Task {
+	static inline std::mutex mutex;
+	static inline std::vector< int > order;
+
+	int id = 0;
+
+	OrderedTask(int i) : id(i) {}
+
+	void run() override {
+		std::lock_guard< std::mutex > guard(mutex);
+		order.push_back(id);
+	}
+};
+
+struct ThrowingTask : Task {
+	void run() override { throw std::runtime_error("Task failed"); }
+};
+
+TEST(batch_scheduler, runs_all_tasks) {
+	using task_variant = pv::polymorphic_variant< Task, CountingTask< 0 >, CountingTask< 1 >, CountingTask< 2 > >;
+
+	for (std::atomic< int > &counter : executed) {
+		counter = 0;
+	}
+
+	pv::batch_scheduler< Task, CountingTask< 0 >, CountingTask< 1 >, CountingTask< 2 > > scheduler(4, 8);
+	ASSERT_EQ(scheduler.worker_count(), 4u);
+
+	constexpr int task_count = 1000;
+	for (int i = 0; i < task_count; ++i) {
+		switch (i % 3) {
+			case 0:
+				scheduler.emplace< CountingTask< 0 > >();
+				break;
+			case 1:
+				scheduler.submit(task_variant(CountingTask< 1 >{}));
+				break;
+			default: {
+				const task_variant task(CountingTask< 2 >{});
+				scheduler.submit(task);
+				break;
+			}
+		}
+	}
+
+	scheduler.wait();
+
+	ASSERT_EQ(executed[0], 334);
+	ASSERT_EQ(executed[1], 333);
+	ASSERT_EQ(executed[2], 333);
+}
+
+TEST(batch_scheduler, same_type_fifo) {
+	OrderedTask::order.clear();
+
+	// With a single worker, tasks of the same type have to be executed in submission order
+	pv::batch_scheduler< Task, OrderedTask, CountingTask< 0 > > scheduler(1, 4);
+
+	for (int i = 0; i < 100; ++i) {
+		scheduler.emplace< OrderedTask >(i);
+		scheduler.emplace< CountingTask< 0 > >();
+	}
+
+	scheduler.wait();
+
+	ASSERT_EQ(OrderedTask::order.size(), 100u);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(OrderedTask::order[static_cast< std::size_t >(i)], i);
+	}
+}
+
+TEST(batch_scheduler, propagates_exceptions) {
+	executed[0] = 0;
+
+	pv::batch_scheduler< Task, ThrowingTask, CountingTask< 0 > > scheduler(2);
+
+	scheduler.emplace< ThrowingTask >();
+	scheduler.emplace< ThrowingTask >();
+	scheduler.emplace< CountingTask< 0 > >();
+
+	ASSERT_THROW(scheduler.wait(), std::runtime_error);
+	ASSERT_EQ(executed[0], 1);
+
+	// The error has been reported and the scheduler remains usable
+	scheduler.emplace< CountingTask< 0 > >();
+	ASSERT_NO_THROW(scheduler.wait());
+	ASSERT_EQ(executed[0], 2);
+}
+
+#ifdef __linux__
+/**
+ * Creates a scheduler with many workers in a process whose address space is limited, so that only the stacks of the
+ * first few workers can be allocated. Exits with code 0, if the constructor reports the failure via an exception.
+ */
+[[noreturn]] void create_scheduler_with_limited_address_space() {
+	std::ifstream statm("/proc/self/statm");
+	rlim_t pages = 0;
+	statm >> pages;
+
+	const rlimit limit = { pages * static_cast< rlim_t >(sysconf(_SC_PAGESIZE)) + 32 * 1024 * 1024, RLIM_INFINITY };
+	if (setrlimit(RLIMIT_AS, &limit) != 0) {
+		std::exit(2);
+	}
+
+	try {
+		pv::batch_scheduler< Task, CountingTask< 0 > > scheduler(256);
+	} catch (const std::system_error &) {
+		std::exit(0);
+	}
+
+	std::exit(1);
+}
+#endif
+
+TEST(batch_scheduler, failed_worker_creation) {
+#ifdef __linux__
+	// If the already started workers weren't shut down, the constructor would call std::terminate
+	EXPECT_EXIT(create_scheduler_with_limited_address_space(), ::testing::ExitedWithCode(0), "");
+#else
+	GTEST_SKIP() << "Limiting the address space is only implemented for Linux";
+#endif
+}
@@ -0,0 +1,93 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/cow_polymorphic_variant.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <utility>
+
+using cow_type = pv::cow_polymorphic_variant< Base, Derived1, Base, Derived2 >;
+
+TEST(cow_polymorphic_variant, default_constructible) {
+	const cow_type variant;
+
+	ASSERT_EQ(variant->get_test(), Derived1::test_value);
+	ASSERT_EQ(variant.index(), 0u);
+	ASSERT_TRUE(variant.unique());
+}
+
+TEST(cow_polymorphic_variant, copies_share_storage) {
+	const cow_type variant1(Derived2{ 5 });
+	const cow_type variant2 = variant1;
+
+	ASSERT_EQ(&variant1.get(), &variant2.get());
+	ASSERT_EQ(variant1.use_count(), 2u);
+	ASSERT_EQ(variant2->the_value, 5);
+	ASSERT_EQ(variant2->get_test(), Derived2::test_value);
+}
+
+TEST(cow_polymorphic_variant, mutation_clones) {
+	cow_type variant1(Derived1{ 1 });
+	cow_type variant2 = variant1;
+
+	// Reading doesn't clone
+	ASSERT_EQ(variant2.cget().the_value, 1);
+	ASSERT_EQ(&variant1.cget(), &variant2.cget());
+
+	variant2->the_value = 2;
+
+	ASSERT_NE(&variant1.cget(), &variant2.cget());
+	ASSERT_EQ(variant1.cget().the_value, 1);
+	ASSERT_EQ(variant2.cget().the_value, 2);
+	ASSERT_EQ(variant2.cget().get_test(), Derived1::test_value);
+	ASSERT_TRUE(variant1.unique());
+	ASSERT_TRUE(variant2.unique());
+
+	// Unshared objects are mutated in-place
+	const Base *address = &variant2.cget();
+	variant2->the_value = 3;
+	ASSERT_EQ(&variant2.cget(), address);
+}
+
+TEST(cow_polymorphic_variant, assignment) {
+	cow_type variant1(Derived1{ 1 });
+	cow_type variant2 = variant1;
+
+	variant2 = Derived2{ 2 };
+	ASSERT_EQ(variant1.cget().get_test(), Derived1::test_value);
+	ASSERT_EQ(variant2.cget().get_test(), Derived2::test_value);
+	ASSERT_EQ(variant2.index(), 2u);
+
+	variant1 = variant2;
+	ASSERT_EQ(variant2.use_count(), 2u);
+
+	Base &emplaced = variant1.emplace< Base >(7);
+	ASSERT_EQ(emplaced.the_value, 7);
+	ASSERT_EQ(variant1.cget().get_test(), Base::test_value);
+	ASSERT_EQ(variant2.cget().get_test(), Derived2::test_value);
+	ASSERT_TRUE(variant2.unique());
+
+	cow_type variant3 = std::move(variant1);
+	ASSERT_EQ(variant3.cget().the_value, 7);
+	ASSERT_EQ(variant1.use_count(), 0u);
+
+	variant1 = variant3;
+	ASSERT_EQ(variant3.use_count(), 2u);
+}
+
+TEST(cow_polymorphic_variant, visit) {
+	const cow_type variant(Derived2{});
+
+	const int field = variant.visit([](const auto &value) {
+		if constexpr (std::is_same_v< std::decay_t< decltype(value) >, Derived2 >) {
+			return value.derived2Field;
+		} else {
+			return -1;
+		}
+	});
+
+	ASSERT_EQ(field, Derived2::field_value);
+}
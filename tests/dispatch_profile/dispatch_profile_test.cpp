@@ -0,0 +1,96 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/dispatch_profile.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Derived3 : public Base {
+public:
+	static constexpr int test_value = 3;
+
+	using Base::Base;
+
+	int get_test() const override { return test_value; }
+};
+
+using profiled_type = pv::polymorphic_variant< Base, Derived1, Base, Derived2 >;
+using ordered_type  = pv::polymorphic_variant< Base, Derived1, Derived2, Derived3, Base >;
+
+namespace pv {
+template<> struct dispatch_order< ordered_type > { using type = std::index_sequence< 2, 0 >; };
+} // namespace pv
+
+TEST(dispatch_profile, records_visits) {
+	using profile = pv::dispatch_profile< profiled_type >;
+	static_assert(profile::enabled());
+
+	profile::reset();
+
+	std::vector< profiled_type > values = { Derived2{}, Derived2{}, Derived1{}, Derived2{} };
+	for (const profiled_type &current : values) {
+		current.visit([](const auto &) {});
+	}
+	pv::visit([](auto &) {}, values[2]);
+
+	const auto counts = profile::counts();
+	ASSERT_EQ(counts[0], 2u);
+	ASSERT_EQ(counts[1], 0u);
+	ASSERT_EQ(counts[2], 3u);
+	ASSERT_EQ(profile::total(), 5u);
+	ASSERT_EQ(profile::order(), (std::vector< std::size_t >{ 2, 0 }));
+
+	profile::reset();
+	ASSERT_EQ(profile::total(), 0u);
+	ASSERT_TRUE(profile::order().empty());
+}
+
+TEST(dispatch_profile, write_order) {
+	using profile = pv::dispatch_profile< profiled_type >;
+
+	profile::reset();
+	profiled_type value(Base{});
+	for (int i = 0; i < 3; ++i) {
+		value.visit([](auto &) {});
+	}
+	value = Derived1{};
+	value.visit([](auto &) {});
+
+	std::stringstream stream;
+	profile::write_order(stream, "my_variant");
+
+	const std::string expected = "// Generated from a dispatch profile of 4 dispatches\n"
+								 "namespace pv {\n"
+								 "template<> struct dispatch_order< my_variant > {\n"
+								 "\tusing type = std::index_sequence< 1, 0 >;\n"
+								 "};\n"
+								 "} // namespace pv\n";
+	ASSERT_EQ(stream.str(), expected);
+
+	stream.str("");
+	profile::write_order(stream, "my_variant", 1);
+	ASSERT_NE(stream.str().find("std::index_sequence< 1 >;"), std::string::npos);
+}
+
+TEST(dispatch_profile, ordered_dispatch) {
+	// Listed types as well as types that are not part of the dispatch order must be dispatched correctly
+	std::vector< ordered_type > values = { Derived1{}, Derived2{}, Derived3{}, Base{ 4 } };
+	std::vector< int > results;
+	for (ordered_type &current : values) {
+		results.push_back(current.visit([](auto &value) { return value.get_test(); }));
+	}
+
+	ASSERT_EQ(results, (std::vector< int >{ Derived1::test_value, Derived2::test_value, Derived3::test_value,
+											Base::test_value }));
+
+	ASSERT_TRUE(
+		values[2].visit([](auto &value) { return std::is_same_v< std::decay_t< decltype(value) >, Derived3 >; }));
+	ASSERT_EQ(std::move(values[3]).visit([](auto &&value) { return value.the_value; }), 4);
+}
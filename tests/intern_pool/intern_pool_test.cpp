@@ -0,0 +1,134 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/intern_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Token {
+	virtual ~Token() = default;
+
+	virtual std::string text() const = 0;
+};
+
+struct Identifier : Token {
+	std::string name;
+
+	Identifier(std::string n) : name(std::move(n)) {}
+
+	std::string text() const override { return name; }
+
+	bool operator==(const Identifier &other) const { return name == other.name; }
+};
+
+struct Number : Token {
+	int value = 0;
+
+	Number(int v) : value(v) {}
+
+	std::string text() const override { return std::to_string(value); }
+
+	bool operator==(const Number &other) const { return value == other.value; }
+};
+
+namespace std {
+template<> struct hash< Identifier > {
+	std::size_t operator()(const Identifier &id) const { return std::hash< std::string >{}(id.name); }
+};
+
+template<> struct hash< Number > {
+	// Deliberately bad hash function to provoke collisions
+	std::size_t operator()(const Number &number) const { return static_cast< std::size_t >(number.value % 2); }
+};
+} // namespace std
+
+using pool_type = pv::intern_pool< Token, Identifier, Number >;
+
+TEST(intern_pool, deduplicates) {
+	pool_type pool;
+
+	const pool_type::handle a1 = pool.emplace< Identifier >("a");
+	const pool_type::handle b  = pool.emplace< Identifier >("b");
+	const pool_type::handle a2 = pool.intern(pool_type::value_type(Identifier("a")));
+
+	ASSERT_TRUE(a1.valid());
+	ASSERT_EQ(a1, a2);
+	ASSERT_NE(a1, b);
+	ASSERT_EQ(pool.size(), 2u);
+	ASSERT_EQ(&pool.get(a1), &pool.get(a2));
+	ASSERT_EQ(pool.get(b).text(), "b");
+}
+
+TEST(intern_pool, distinguishes_types) {
+	pool_type pool;
+
+	const pool_type::handle id     = pool.emplace< Identifier >("1");
+	const pool_type::handle number = pool.emplace< Number >(1);
+
+	ASSERT_NE(id, number);
+	ASSERT_EQ(pool[id].index(), 0u);
+	ASSERT_EQ(pool[number].index(), 1u);
+	ASSERT_EQ(pool.get(id).text(), pool.get(number).text());
+}
+
+TEST(intern_pool, collisions_and_growth) {
+	pool_type pool;
+
+	std::vector< pool_type::handle > handles;
+	for (int i = 0; i < 1000; ++i) {
+		handles.push_back(pool.emplace< Number >(i));
+	}
+	const Token *first = &pool.get(handles.front());
+
+	ASSERT_EQ(pool.size(), 1000u);
+
+	for (int i = 0; i < 1000; ++i) {
+		const pool_type::handle current = pool.emplace< Number >(i);
+
+		ASSERT_EQ(current, handles[static_cast< std::size_t >(i)]);
+		ASSERT_EQ(pool.get(current).text(), std::to_string(i));
+	}
+
+	ASSERT_EQ(pool.size(), 1000u);
+	// References remain stable while the pool grows
+	ASSERT_EQ(first, &pool.get(handles.front()));
+}
+
+TEST(intern_pool, find) {
+	pool_type pool;
+
+	ASSERT_FALSE(pool.find(pool_type::value_type(Number(3))).has_value());
+
+	const pool_type::handle three = pool.emplace< Number >(3);
+
+	ASSERT_EQ(pool.find(pool_type::value_type(Number(3))), three);
+	ASSERT_FALSE(pool.find(pool_type::value_type(Identifier("3"))).has_value());
+	ASSERT_FALSE(pool_type::handle().valid());
+}
+
+TEST(intern_pool, move) {
+	pool_type pool;
+	const pool_type::handle three = pool.emplace< Number >(3);
+
+	pool_type moved(std::move(pool));
+	ASSERT_EQ(moved.size(), 1u);
+	ASSERT_EQ(moved.find(pool_type::value_type(Number(3))), three);
+
+	// The moved-from pool is empty but can still be used
+	ASSERT_TRUE(pool.empty());
+	ASSERT_FALSE(pool.find(pool_type::value_type(Number(3))).has_value());
+	ASSERT_EQ(pool.emplace< Number >(4).id(), 0u);
+
+	pool_type assigned;
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.find(pool_type::value_type(Number(3))), three);
+	ASSERT_TRUE(moved.empty());
+	ASSERT_FALSE(moved.find(pool_type::value_type(Number(3))).has_value());
+	ASSERT_EQ(moved.emplace< Identifier >("x").id(), 0u);
+}
@@ -7,6 +7,11 @@
 #include <gtest/gtest.h>
 #include <test_definitions.hpp>
 
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+
 
 TEST(main, default_constructible) {
 	pv::polymorphic_variant< Base, Base > variant1;
@@ -95,3 +100,161 @@ TEST(main, implicit_conversion) {
 	// The variant should be implicitly convertible to a base-class reference
 	ASSERT_EQ(func(variant), Derived1::test_value);
 }
+
+TEST(main, visit) {
+	pv::polymorphic_variant< Base, Derived1, Base, Derived2 > variant(Derived2{ 3 });
+
+	ASSERT_EQ(variant.index(), 2u);
+	ASSERT_EQ(pv::visit([](auto &value) { return value.get_test() + value.the_value; }, variant), 5);
+
+	// Visiting yields the concrete type
+	ASSERT_TRUE(pv::visit([](auto &value) { return std::is_same_v< decltype(value), Derived2 & >; }, variant));
+
+	const auto &const_ref = variant;
+	ASSERT_TRUE(pv::visit([](auto &value) { return std::is_same_v< decltype(value), const Derived2 & >; }, const_ref));
+
+	ASSERT_TRUE(
+		pv::visit([](auto &&value) { return std::is_same_v< decltype(value), Derived2 && >; }, std::move(variant)));
+}
+
+template< std::size_t I > struct Numbered : Base {
+	int get_test() const override { return static_cast< int >(I); }
+};
+
+template< std::size_t... I > auto make_numbered_variant(std::size_t index, std::index_sequence< I... >) {
+	using variant_type = pv::polymorphic_variant< Base, Numbered< I >... >;
+
+	variant_type variant;
+	((index == I ? static_cast< void >(variant = Numbered< I >{}) : static_cast< void >(0)), ...);
+
+	return variant;
+}
+
+TEST(main, visit_many_alternatives) {
+	// More alternatives than are handled by a single switch statement internally
+	constexpr std::size_t alternatives = 40;
+
+	for (std::size_t i = 0; i < alternatives; ++i) {
+		const auto variant = make_numbered_variant(i, std::make_index_sequence< alternatives >{});
+
+		ASSERT_EQ(variant.index(), i);
+		ASSERT_EQ(variant->get_test(), static_cast< int >(i));
+		ASSERT_EQ(pv::visit([](const auto &value) { return value.get_test(); }, variant), static_cast< int >(i));
+	}
+}
+
+struct identity_visitor {
+	template< typename T > T operator()(T value) const { return value; }
+};
+
+// Just like std::visit, pv::visit must reject visitors whose result type depends on the alternative (instead of
+// converting all results to the result for the first alternative)
+static_assert(pv::details::consistent_visit_result_v< identity_visitor, std::variant< int, int > & >);
+static_assert(!pv::details::consistent_visit_result_v< identity_visitor, std::variant< int, double > & >);
+static_assert(pv::details::consistent_visit_result_v< identity_visitor, std::variant< int, double, double > &, 1 >);
+
+TEST(main, visit_std_variant) {
+	std::variant< int, std::string > variant = std::string("test");
+
+	ASSERT_EQ(pv::visit([](const auto &value) { return sizeof(value); }, variant), sizeof(std::string));
+
+	variant = 42;
+	ASSERT_EQ(pv::visit([](auto &value) { return std::is_same_v< decltype(value), int & >; }, variant), true);
+
+	std::string moved_to;
+	variant = std::string("moved");
+	pv::visit(
+		[&moved_to](auto &&value) {
+			if constexpr (std::is_same_v< decltype(value), std::string && >) {
+				moved_to = std::move(value);
+			}
+		},
+		std::move(variant));
+	ASSERT_EQ(moved_to, "moved");
+}
+
+TEST(main, typed_access) {
+	pv::polymorphic_variant< Base, Derived1, Base, Derived2 > variant(Derived2{ 3 });
+
+	ASSERT_TRUE(variant.holds_alternative< Derived2 >());
+	ASSERT_FALSE(variant.holds_alternative< Base >());
+	ASSERT_TRUE(pv::holds_alternative< Derived2 >(variant));
+
+	ASSERT_EQ(variant.get_if< Derived1 >(), nullptr);
+	ASSERT_EQ(pv::get_if< Base >(&variant), nullptr);
+	ASSERT_EQ(variant.get_if< Derived2 >(), &variant.get());
+
+	Derived2 *derived = pv::get_if< Derived2 >(&variant);
+	ASSERT_NE(derived, nullptr);
+	ASSERT_EQ(derived->derived2Field, Derived2::field_value);
+	ASSERT_EQ(derived->the_value, 3);
+
+	const auto &const_variant = variant;
+	ASSERT_EQ(pv::get< Derived2 >(const_variant).the_value, 3);
+	ASSERT_THROW(pv::get< Derived1 >(const_variant), std::bad_variant_access);
+
+	pv::get< Derived2 >(variant).the_value = 4;
+	ASSERT_EQ(variant->the_value, 4);
+
+	decltype(variant) *null_variant = nullptr;
+	ASSERT_EQ(pv::get_if< Derived2 >(null_variant), nullptr);
+}
+
+TEST(main, adopt_and_release_variant) {
+	std::variant< Derived1, Base, Derived2 > plain(std::in_place_type_t< Derived2 >{}, 7);
+
+	pv::polymorphic_variant< Base, Derived1, Base, Derived2 > variant(std::move(plain));
+	ASSERT_EQ(variant.index(), 2);
+	ASSERT_EQ(variant->get_test(), Derived2::test_value);
+	ASSERT_EQ(variant->the_value, 7);
+
+	variant = Derived1{ 8 };
+	std::variant< Derived1, Base, Derived2 > released = std::move(variant).release();
+	ASSERT_EQ(released.index(), 0);
+	ASSERT_EQ(std::get< Derived1 >(released).the_value, 8);
+}
+
+TEST(main, widening_conversion) {
+	using narrow_variant = pv::polymorphic_variant< Base, Derived1, Derived2 >;
+	using wide_variant   = pv::polymorphic_variant< Base, Derived2, Base, Derived1 >;
+
+	static_assert(std::is_convertible_v< narrow_variant, wide_variant >);
+	static_assert(!std::is_convertible_v< wide_variant, narrow_variant >);
+
+	const narrow_variant source(Derived1{ 5 });
+	wide_variant copy = source;
+	ASSERT_EQ(copy.index(), 2u);
+	ASSERT_EQ(copy->get_test(), Derived1::test_value);
+	ASSERT_EQ(copy->the_value, 5);
+
+	wide_variant moved = narrow_variant(Derived2{ 6 });
+	ASSERT_EQ(moved.index(), 0u);
+	ASSERT_EQ(moved->the_value, 6);
+
+	moved = source;
+	ASSERT_TRUE(moved.holds_alternative< Derived1 >());
+	ASSERT_EQ(moved->the_value, 5);
+
+	moved = narrow_variant(Derived2{ 7 });
+	ASSERT_TRUE(moved.holds_alternative< Derived2 >());
+	ASSERT_EQ(moved->the_value, 7);
+}
+
+TEST(main, narrowing_conversion) {
+	using wide_variant   = pv::polymorphic_variant< Base, Derived1, Base, Derived2 >;
+	using narrow_variant = pv::polymorphic_variant< Base, Derived2, Derived1 >;
+
+	const wide_variant derived(Derived2{ 3 });
+	std::optional< narrow_variant > narrowed = pv::narrow< narrow_variant >(derived);
+	ASSERT_TRUE(narrowed.has_value());
+	ASSERT_EQ(narrowed->index(), 0u);
+	ASSERT_EQ(narrowed->get().the_value, 3);
+
+	const wide_variant base(Base{ 4 });
+	ASSERT_FALSE(pv::narrow< narrow_variant >(base).has_value());
+
+	narrowed = pv::narrow< narrow_variant >(wide_variant(Derived1{ 8 }));
+	ASSERT_TRUE(narrowed.has_value());
+	ASSERT_EQ(narrowed->get().get_test(), Derived1::test_value);
+	ASSERT_EQ(narrowed->get().the_value, 8);
+}
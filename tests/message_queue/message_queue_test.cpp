@@ -0,0 +1,190 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/message_queue.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using variant_type = pv::polymorphic_variant< Base, Derived1, Derived2 >;
+
+struct type_recorder {
+	std::vector< int > &values;
+
+	void operator()(Derived1 &d) { values.push_back(d.the_value); }
+	void operator()(Derived2 &d) { values.push_back(-d.the_value); }
+};
+
+TEST(spsc_queue, fifo_order) {
+	pv::spsc_queue< Base, Derived1, Derived2 > queue(4);
+
+	ASSERT_EQ(queue.capacity(), 4u);
+	ASSERT_TRUE(queue.empty());
+
+	ASSERT_TRUE(queue.try_emplace< Derived1 >(1));
+	ASSERT_TRUE(queue.try_emplace< Derived2 >(2));
+	ASSERT_TRUE(queue.try_push(variant_type(Derived1{ 3 })));
+	const variant_type value(Derived2{ 4 });
+	ASSERT_TRUE(queue.try_push(value));
+
+	// Queue is full now
+	ASSERT_FALSE(queue.try_emplace< Derived1 >(5));
+	ASSERT_FALSE(queue.empty());
+
+	std::vector< int > values;
+	ASSERT_EQ(queue.consume_all(type_recorder{ values }), 4u);
+	ASSERT_EQ(values, (std::vector< int >{ 1, -2, 3, -4 }));
+	ASSERT_TRUE(queue.empty());
+
+	// Slots can be reused
+	ASSERT_TRUE(queue.try_emplace< Derived2 >(6));
+	values.clear();
+	ASSERT_TRUE(queue.try_consume(type_recorder{ values }));
+	ASSERT_FALSE(queue.try_consume(type_recorder{ values }));
+	ASSERT_EQ(values, (std::vector< int >{ -6 }));
+}
+
+TEST(spsc_queue, concurrent) {
+	constexpr int message_count = 10000;
+	pv::spsc_queue< Base, Derived1, Derived2 > queue(16);
+
+	std::thread producer([&]() {
+		for (int i = 0; i < message_count; ++i) {
+			bool pushed = i % 2 == 0 ? queue.try_emplace< Derived1 >(i) : queue.try_emplace< Derived2 >(i);
+			while (!pushed) {
+				std::this_thread::yield();
+				pushed = i % 2 == 0 ? queue.try_emplace< Derived1 >(i) : queue.try_emplace< Derived2 >(i);
+			}
+		}
+	});
+
+	int expected = 0;
+	bool in_order = true;
+	while (expected < message_count) {
+		const bool consumed = queue.try_consume([&](auto &&message) {
+			using type = std::decay_t< decltype(message) >;
+			in_order   = in_order && message.the_value == expected
+					   && std::is_same_v< type, Derived1 > == (expected % 2 == 0);
+			expected++;
+		});
+
+		if (!consumed) {
+			std::this_thread::yield();
+		}
+	}
+
+	producer.join();
+
+	ASSERT_TRUE(in_order);
+	ASSERT_TRUE(queue.empty());
+}
+
+TEST(mpsc_queue, fifo_order) {
+	pv::mpsc_queue< Base, Derived1, Derived2 > queue(3);
+
+	ASSERT_EQ(queue.capacity(), 4u);
+
+	ASSERT_TRUE(queue.try_emplace< Derived1 >(1));
+	ASSERT_TRUE(queue.try_emplace< Derived2 >(2));
+	ASSERT_TRUE(queue.try_push(variant_type(Derived1{ 3 })));
+	ASSERT_TRUE(queue.try_emplace< Derived2 >(4));
+	ASSERT_FALSE(queue.try_emplace< Derived1 >(5));
+
+	std::vector< int > values;
+	ASSERT_EQ(queue.consume_all(type_recorder{ values }), 4u);
+	ASSERT_EQ(values, (std::vector< int >{ 1, -2, 3, -4 }));
+	ASSERT_FALSE(queue.try_consume(type_recorder{ values }));
+}
+
+TEST(mpsc_queue, concurrent) {
+	constexpr int producer_count         = 4;
+	constexpr int messages_per_producer = 5000;
+	pv::mpsc_queue< Base, Derived1, Derived2 > queue(32);
+
+	std::vector< std::thread > producers;
+	for (int p = 0; p < producer_count; ++p) {
+		producers.emplace_back([&queue, p]() {
+			for (int i = 0; i < messages_per_producer; ++i) {
+				while (!(p % 2 == 0 ? queue.try_emplace< Derived1 >(p) : queue.try_emplace< Derived2 >(p))) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	std::vector< int > received(producer_count, 0);
+	int total = 0;
+	while (total < producer_count * messages_per_producer) {
+		if (queue.try_consume([&](auto &&message) { received[static_cast< std::size_t >(message.the_value)]++; })) {
+			total++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	for (std::thread &current : producers) {
+		current.join();
+	}
+
+	for (int count : received) {
+		ASSERT_EQ(count, messages_per_producer);
+	}
+}
+
+struct throwing_type : Base {
+	struct error {};
+
+	throwing_type(bool do_throw) {
+		if (do_throw) {
+			throw error{};
+		}
+	}
+};
+
+TEST(mpsc_queue, failed_construction) {
+	pv::mpsc_queue< Base, Derived1, throwing_type > queue(4);
+
+	ASSERT_TRUE(queue.try_emplace< Derived1 >(1));
+	ASSERT_THROW(queue.try_emplace< throwing_type >(true), throwing_type::error);
+	ASSERT_TRUE(queue.try_emplace< Derived1 >(2));
+
+	std::vector< int > values;
+	ASSERT_EQ(queue.consume_all([&](auto &&message) { values.push_back(message.the_value); }), 2u);
+	ASSERT_EQ(values, (std::vector< int >{ 1, 2 }));
+}
+
+struct counted_type : Base {
+	static inline int instances = 0;
+
+	counted_type(int i) : Base(i) { ++instances; }
+	counted_type(const counted_type &other) : Base(other) { ++instances; }
+	~counted_type() override { --instances; }
+};
+
+TEST(spsc_queue, throwing_visitor) {
+	{
+		pv::spsc_queue< Base, Derived1, counted_type > queue(4);
+
+		ASSERT_TRUE(queue.try_emplace< counted_type >(1));
+		ASSERT_TRUE(queue.try_emplace< counted_type >(2));
+		ASSERT_EQ(counted_type::instances, 2);
+
+		// The message is removed (and destroyed exactly once) even though the visitor throws
+		ASSERT_THROW(queue.try_consume([](auto &&) { throw throwing_type::error{}; }), throwing_type::error);
+		ASSERT_EQ(counted_type::instances, 1);
+
+		std::vector< int > values;
+		ASSERT_TRUE(queue.try_consume([&](auto &&message) { values.push_back(message.the_value); }));
+		ASSERT_EQ(values, (std::vector< int >{ 2 }));
+		ASSERT_TRUE(queue.empty());
+
+		ASSERT_TRUE(queue.try_emplace< counted_type >(3));
+	}
+
+	ASSERT_EQ(counted_type::instances, 0);
+}
@@ -0,0 +1,106 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/optional_polymorphic_variant.hpp>
+#include <pv/polymorphic_variant.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+namespace {
+
+class Value {
+public:
+	virtual ~Value() = default;
+
+	virtual int number() const = 0;
+};
+
+class Fixed final : public Value {
+public:
+	int value;
+
+	Fixed(int v) : value(v) {}
+
+	int number() const override { return value; }
+};
+
+// Construction from a string may throw, but moving never does
+class Parsed final : public Value {
+public:
+	int value;
+
+	Parsed(const std::string &text) : value(std::stoi(text)) {}
+	Parsed(Parsed &&) noexcept = default;
+	Parsed(const Parsed &)     = default;
+
+	int number() const override { return value; }
+};
+
+class ThrowingMove final : public Value {
+public:
+	ThrowingMove() = default;
+	ThrowingMove(ThrowingMove &&) {}
+	ThrowingMove(const ThrowingMove &) = default;
+
+	int number() const override { return 0; }
+};
+
+using value_variant          = pv::polymorphic_variant< Value, Fixed, Parsed >;
+using optional_value_variant = pv::optional_polymorphic_variant< Value, Fixed, Parsed >;
+
+static_assert(pv::details::never_valueless_v< value_variant::variant_type >);
+static_assert(pv::details::never_valueless_v< optional_value_variant::variant_type >);
+// Types whose move constructor may throw keep the checks for the valueless state
+static_assert(!pv::details::never_valueless_v< pv::polymorphic_variant< Value, Fixed, ThrowingMove >::variant_type >);
+
+} // namespace
+
+TEST(never_valueless, failed_emplace_keeps_value) {
+	value_variant variant(Fixed(7));
+
+	ASSERT_THROW(variant.emplace< Parsed >(std::string("not a number")), std::invalid_argument);
+
+	ASSERT_EQ(variant.index(), 0);
+	ASSERT_EQ(variant->number(), 7);
+	ASSERT_FALSE(std::move(variant).release().valueless_by_exception());
+}
+
+TEST(never_valueless, successful_emplace) {
+	value_variant variant(Fixed(7));
+
+	Parsed &parsed = variant.emplace< Parsed >(std::string("42"));
+
+	ASSERT_EQ(&parsed, &variant.get());
+	ASSERT_EQ(variant.index(), 1);
+	ASSERT_EQ(variant->number(), 42);
+}
+
+TEST(never_valueless, adopt_valueless_variant) {
+	value_variant::variant_type variant(Fixed(5));
+	ASSERT_THROW(variant.emplace< Parsed >(std::string("not a number")), std::invalid_argument);
+	ASSERT_TRUE(variant.valueless_by_exception());
+
+	ASSERT_THROW(value_variant(std::move(variant)), std::bad_variant_access);
+
+	value_variant::variant_type valid(Parsed(std::string("12")));
+	const value_variant adopted(std::move(valid));
+	ASSERT_EQ(adopted->number(), 12);
+}
+
+TEST(never_valueless, optional_failed_emplace_keeps_value) {
+	optional_value_variant variant(Fixed(3));
+
+	ASSERT_THROW(variant.emplace< Parsed >(std::string("")), std::invalid_argument);
+
+	ASSERT_TRUE(variant.has_value());
+	ASSERT_EQ(variant->number(), 3);
+
+	variant.reset();
+	ASSERT_THROW(variant.emplace< Parsed >(std::string("x")), std::invalid_argument);
+	ASSERT_FALSE(variant.has_value());
+}
@@ -0,0 +1,160 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/node_arena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Literal;
+class Add;
+class Multiply;
+class Counted;
+
+class Expression;
+
+using expression_arena = pv::node_arena< Expression, Literal, Add, Multiply, Counted >;
+using expression_handle = pv::node_handle< Expression >;
+
+class Expression {
+public:
+	virtual ~Expression() = default;
+
+	virtual int evaluate(const expression_arena &arena) const = 0;
+};
+
+class Literal : public Expression {
+public:
+	int value;
+
+	Literal(int v) : value(v) {}
+
+	int evaluate(const expression_arena &) const override { return value; }
+};
+
+class Add : public Expression {
+public:
+	expression_handle lhs;
+	expression_handle rhs;
+
+	Add(expression_handle l, expression_handle r) : lhs(l), rhs(r) {}
+
+	int evaluate(const expression_arena &arena) const override;
+};
+
+class Multiply : public Expression {
+public:
+	expression_handle lhs;
+	expression_handle rhs;
+
+	Multiply(expression_handle l, expression_handle r) : lhs(l), rhs(r) {}
+
+	int evaluate(const expression_arena &arena) const override;
+};
+
+class Counted : public Expression {
+public:
+	static inline int instances = 0;
+
+	Counted() { ++instances; }
+	Counted(const Counted &) { ++instances; }
+	~Counted() override { --instances; }
+
+	int evaluate(const expression_arena &) const override { return 0; }
+};
+
+int Add::evaluate(const expression_arena &arena) const {
+	return arena.get(lhs).evaluate(arena) + arena.get(rhs).evaluate(arena);
+}
+
+int Multiply::evaluate(const expression_arena &arena) const {
+	return arena.get(lhs).evaluate(arena) * arena.get(rhs).evaluate(arena);
+}
+
+} // namespace
+
+TEST(node_arena, expression_tree) {
+	expression_arena arena;
+
+	// (2 + 3) * 4
+	const expression_handle two   = arena.emplace< Literal >(2);
+	const expression_handle three = arena.emplace< Literal >(3);
+	const expression_handle sum   = arena.emplace< Add >(two, three);
+	const expression_handle root  = arena.emplace< Multiply >(sum, arena.insert(Literal(4)));
+
+	ASSERT_EQ(arena.size(), 5);
+	ASSERT_EQ(arena.get(root).evaluate(arena), 20);
+	ASSERT_EQ(arena[sum].index(), 1);
+	ASSERT_EQ(root.index(), 4);
+	ASSERT_TRUE(root.valid());
+	ASSERT_FALSE(expression_handle().valid());
+	ASSERT_NE(root, sum);
+}
+
+TEST(node_arena, stable_references) {
+	expression_arena arena;
+
+	const expression_handle first = arena.emplace< Literal >(0);
+	const Expression *address     = &arena.get(first);
+
+	// Build a long chain spanning several chunks
+	expression_handle current = first;
+	for (int i = 1; i < static_cast< int >(3 * expression_arena::chunk_size); ++i) {
+		current = arena.emplace< Add >(current, arena.emplace< Literal >(i));
+	}
+
+	ASSERT_EQ(&arena.get(first), address);
+	ASSERT_GE(arena.capacity(), arena.size());
+
+	const int n = static_cast< int >(3 * expression_arena::chunk_size) - 1;
+	ASSERT_EQ(arena.get(current).evaluate(arena), n * (n + 1) / 2);
+}
+
+TEST(node_arena, bulk_clear) {
+	expression_arena arena;
+	arena.reserve(2 * expression_arena::chunk_size);
+	const std::size_t capacity = arena.capacity();
+
+	ASSERT_GE(capacity, 2 * expression_arena::chunk_size);
+
+	for (std::size_t i = 0; i < expression_arena::chunk_size + 1; ++i) {
+		arena.emplace< Counted >();
+	}
+	ASSERT_EQ(Counted::instances, static_cast< int >(expression_arena::chunk_size + 1));
+
+	arena.clear();
+	ASSERT_EQ(Counted::instances, 0);
+	ASSERT_TRUE(arena.empty());
+	ASSERT_EQ(arena.capacity(), capacity);
+
+	// Memory is reused after clearing
+	const expression_handle handle = arena.emplace< Literal >(7);
+	ASSERT_EQ(handle.index(), 0);
+	ASSERT_EQ(arena.capacity(), capacity);
+	ASSERT_EQ(arena.get(handle).evaluate(arena), 7);
+}
+
+TEST(node_arena, move) {
+	expression_arena arena;
+	arena.emplace< Counted >();
+	const expression_handle literal = arena.emplace< Literal >(5);
+
+	expression_arena moved(std::move(arena));
+	ASSERT_EQ(moved.size(), 2);
+	ASSERT_EQ(moved.get(literal).evaluate(moved), 5);
+	ASSERT_EQ(Counted::instances, 1);
+
+	expression_arena other;
+	other.emplace< Counted >();
+	ASSERT_EQ(Counted::instances, 2);
+
+	other = std::move(moved);
+	ASSERT_EQ(Counted::instances, 1);
+	ASSERT_EQ(other.get(literal).evaluate(other), 5);
+}
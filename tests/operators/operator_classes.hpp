@@ -85,3 +85,19 @@ protected:
 	int m_result = InitialValue;
 	int m_factor = Factor;
 };
+
+// Provides operator+= as well as operator+ for a Base rhs, so the latter must not be inferred from the former
+class Accumulator {
+public:
+	int sum = 0;
+
+	Accumulator &operator+=(const Base &other) {
+		sum += other.result();
+
+		return *this;
+	}
+};
+
+inline int operator+(const Accumulator &lhs, const Base &rhs) {
+	return lhs.sum + rhs.result();
+}
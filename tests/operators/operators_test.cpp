@@ -9,6 +9,11 @@
 #include "operator_classes.hpp"
 
 #include <algorithm>
+#include <type_traits>
+
+#if defined(PV_TEST_CONCEPTS) && !defined(PV_USE_CONCEPTS)
+#	error "The concept-based operator overloads are not in use"
+#endif
 
 using variant_type = pv::polymorphic_variant< Base, Derived1, Derived2 >;
 
@@ -84,6 +89,21 @@ TEST(operators, add) {
 	ASSERT_EQ(result->result(), Derived1::InitialValue + Derived2::InitialValue);
 }
 
+TEST(operators, add_not_inferred) {
+	// Accumulator provides operator+ itself, so no operator+ is inferred from Accumulator::operator+=
+	Accumulator accumulator;
+	accumulator.sum = 3;
+	variant_type variant(Derived2{});
+
+	auto result = accumulator + variant;
+	static_assert(std::is_same_v< decltype(result), int >);
+
+	ASSERT_EQ(result, 3 + Derived2::InitialValue);
+
+	accumulator += variant;
+	ASSERT_EQ(accumulator.sum, 3 + Derived2::InitialValue);
+}
+
 TEST(operators, prefix_increment) {
 	variant_type variant(Derived1{});
 
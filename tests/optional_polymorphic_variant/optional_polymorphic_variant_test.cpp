@@ -0,0 +1,119 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/optional_polymorphic_variant.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+using optional_variant = pv::optional_polymorphic_variant< Base, Derived1, Base, Derived2 >;
+using plain_variant    = pv::polymorphic_variant< Base, Derived1, Base, Derived2 >;
+
+// The empty state doesn't need any additional storage
+static_assert(sizeof(optional_variant) == sizeof(plain_variant));
+static_assert(sizeof(optional_variant) < sizeof(std::optional< plain_variant >));
+static_assert(sizeof(pv::optional_polymorphic_variant< Base, Derived1 >)
+			  == sizeof(pv::polymorphic_variant< Base, Derived1 >));
+
+TEST(optional_polymorphic_variant, empty) {
+	optional_variant variant;
+
+	ASSERT_FALSE(variant.has_value());
+	ASSERT_FALSE(variant);
+	ASSERT_EQ(variant, std::nullopt);
+	ASSERT_EQ(variant.index(), std::variant_npos);
+	ASSERT_THROW(variant.value(), std::bad_optional_access);
+
+	const optional_variant other(std::nullopt);
+	ASSERT_FALSE(other.has_value());
+}
+
+TEST(optional_polymorphic_variant, assign_and_reset) {
+	optional_variant variant = Derived2(3);
+
+	ASSERT_TRUE(variant.has_value());
+	ASSERT_NE(variant, std::nullopt);
+	ASSERT_EQ(variant.index(), 2);
+	ASSERT_EQ(variant->get_test(), Derived2::test_value);
+	ASSERT_EQ(variant.value().the_value, 3);
+
+	variant.reset();
+	ASSERT_FALSE(variant.has_value());
+
+	variant.emplace< Derived1 >(7);
+	ASSERT_EQ(variant.index(), 0);
+	ASSERT_EQ(variant->get_test(), Derived1::test_value);
+	ASSERT_EQ(variant.get().the_value, 7);
+
+	variant = std::nullopt;
+	ASSERT_FALSE(variant.has_value());
+
+	variant = Base(1);
+	ASSERT_EQ(variant->get_test(), Base::test_value);
+
+	optional_variant empty;
+	variant.swap(empty);
+	ASSERT_FALSE(variant.has_value());
+	ASSERT_EQ(empty->the_value, 1);
+
+	variant = empty;
+	ASSERT_EQ(variant->get_test(), Base::test_value);
+}
+
+TEST(optional_polymorphic_variant, visit) {
+	const optional_variant variant(std::in_place_type_t< Derived1 >{}, 4);
+
+	const int field = variant.visit([](const auto &value) {
+		if constexpr (std::is_same_v< std::decay_t< decltype(value) >, Derived1 >) {
+			return value.derived1Field;
+		} else {
+			return 0;
+		}
+	});
+	ASSERT_EQ(field, Derived1::field_value);
+}
+
+TEST(optional_polymorphic_variant, from_polymorphic_variant) {
+	pv::polymorphic_variant< Base, Derived1, Base, Derived2 > source = Derived2(5);
+
+	optional_variant variant = source;
+	ASSERT_EQ(variant.index(), 2);
+	ASSERT_EQ(variant->the_value, 5);
+
+	optional_variant moved = std::move(source);
+	ASSERT_EQ(moved->get_test(), Derived2::test_value);
+}
+
+struct ThrowingDerived : Base {
+	struct error {};
+
+	ThrowingDerived(bool do_throw) {
+		if (do_throw) {
+			throw error{};
+		}
+	}
+	// A move constructor that may throw keeps the variant from guaranteeing to never become valueless
+	ThrowingDerived(ThrowingDerived &&other) noexcept(false) : Base(other) {}
+};
+
+TEST(optional_polymorphic_variant, valueless_by_exception) {
+	pv::optional_polymorphic_variant< Base, Derived1, ThrowingDerived > variant = Derived1(1);
+
+	ASSERT_THROW(variant.emplace< ThrowingDerived >(true), ThrowingDerived::error);
+
+	// A valueless variant is treated as being empty
+	ASSERT_FALSE(variant.has_value());
+	ASSERT_FALSE(variant);
+	ASSERT_EQ(variant, std::nullopt);
+	ASSERT_EQ(variant.index(), std::variant_npos);
+	ASSERT_THROW(variant.value(), std::bad_optional_access);
+
+	variant.emplace< ThrowingDerived >(false);
+	ASSERT_TRUE(variant.has_value());
+	ASSERT_EQ(variant.index(), 1u);
+}
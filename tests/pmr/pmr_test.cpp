@@ -0,0 +1,168 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/pmr.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual std::size_t payload() const = 0;
+};
+
+// Uses the leading allocator convention
+class Label : public Shape {
+public:
+	using allocator_type = std::pmr::polymorphic_allocator< char >;
+
+	std::pmr::string text;
+
+	Label(const char *t, const allocator_type &alloc = {}) : text(t, alloc) {}
+	Label(std::allocator_arg_t, const allocator_type &alloc) : text(alloc) {}
+	Label(std::allocator_arg_t, const allocator_type &alloc, const char *t) : text(t, alloc) {}
+	Label(std::allocator_arg_t, const allocator_type &alloc, const Label &other) : text(other.text, alloc) {}
+	Label(std::allocator_arg_t, const allocator_type &alloc, Label &&other) : text(std::move(other.text), alloc) {}
+	Label(const Label &) = default;
+	Label(Label &&)      = default;
+	Label &operator=(const Label &) = default;
+	Label &operator=(Label &&) = default;
+
+	std::size_t payload() const override { return text.size(); }
+};
+
+// Uses the trailing allocator convention
+class Polygon : public Shape {
+public:
+	using allocator_type = std::pmr::polymorphic_allocator< int >;
+
+	std::pmr::vector< int > points;
+
+	Polygon(std::size_t count, const allocator_type &alloc = {}) : points(count, 1, alloc) {}
+	Polygon(const Polygon &other, const allocator_type &alloc) : points(other.points, alloc) {}
+	Polygon(Polygon &&other, const allocator_type &alloc) : points(std::move(other.points), alloc) {}
+	Polygon(const Polygon &) = default;
+	Polygon(Polygon &&)      = default;
+	Polygon &operator=(const Polygon &) = default;
+	Polygon &operator=(Polygon &&) = default;
+
+	std::size_t payload() const override { return points.size(); }
+};
+
+// Doesn't use an allocator at all
+class Point : public Shape {
+public:
+	std::size_t payload() const override { return 0; }
+};
+
+using variant_type = pv::polymorphic_variant< Shape, Label, Polygon, Point >;
+using allocator    = std::pmr::polymorphic_allocator< char >;
+
+constexpr const char *long_text = "This text is too long for the small string optimization";
+
+} // namespace
+
+TEST(pmr, uses_allocator) {
+	static_assert(std::uses_allocator_v< variant_type, allocator >);
+	static_assert(!std::uses_allocator_v< pv::polymorphic_variant< Shape, Point >, allocator >);
+}
+
+TEST(pmr, allocator_extended_construction) {
+	counting_resource resource;
+	const allocator alloc(&resource);
+
+	const variant_type label(std::allocator_arg, alloc, std::in_place_type_t< Label >{}, long_text);
+	ASSERT_EQ(label->payload(), std::string(long_text).size());
+	ASSERT_GT(resource.allocated, 0u);
+
+	const std::size_t before = resource.allocated;
+	const variant_type polygon(std::allocator_arg, alloc, std::in_place_type_t< Polygon >{}, 16u);
+	ASSERT_EQ(polygon->payload(), 16u);
+	ASSERT_EQ(resource.allocated, before + 16 * sizeof(int));
+
+	const variant_type point(std::allocator_arg, alloc, Point{});
+	ASSERT_EQ(point.index(), 2u);
+	ASSERT_EQ(resource.allocated, before + 16 * sizeof(int));
+
+	const variant_type defaulted(std::allocator_arg, alloc);
+	ASSERT_EQ(defaulted.index(), 0u);
+	ASSERT_EQ(static_cast< const Label & >(defaulted.get()).text.get_allocator().resource(), &resource);
+}
+
+TEST(pmr, allocator_extended_copy) {
+	const variant_type original(Label{ long_text });
+
+	counting_resource resource;
+	const variant_type copy(std::allocator_arg, allocator(&resource), original);
+	ASSERT_GT(resource.allocated, 0u);
+	ASSERT_EQ(copy->payload(), original->payload());
+
+	variant_type moved(std::allocator_arg, allocator(&resource), variant_type(Polygon(4)));
+	ASSERT_EQ(moved->payload(), 4u);
+	ASSERT_EQ(static_cast< Polygon & >(moved.get()).points.get_allocator().resource(), &resource);
+}
+
+TEST(pmr, emplace_and_assign) {
+	counting_resource resource;
+	const allocator alloc(&resource);
+
+	variant_type variant(Point{});
+	Label &label = variant.emplace< Label >(std::allocator_arg, alloc, long_text);
+	ASSERT_EQ(label.text.get_allocator().resource(), &resource);
+	ASSERT_EQ(&variant.get(), &label);
+	ASSERT_GT(resource.allocated, 0u);
+
+	variant.assign(std::allocator_arg, alloc, Polygon(8));
+	ASSERT_EQ(variant.index(), 1u);
+	ASSERT_EQ(static_cast< Polygon & >(variant.get()).points.get_allocator().resource(), &resource);
+	ASSERT_EQ(resource.allocated, 8 * sizeof(int));
+
+	// Assigning the same type keeps the existing allocator
+	counting_resource other;
+	variant.assign(std::allocator_arg, allocator(&other), Polygon(2));
+	ASSERT_EQ(static_cast< Polygon & >(variant.get()).points.get_allocator().resource(), &resource);
+	ASSERT_EQ(variant->payload(), 2u);
+	ASSERT_EQ(other.allocated, 0u);
+}
+
+TEST(pmr, container_propagates_resource) {
+	counting_resource resource;
+
+	{
+		pv::pmr::vector< Shape, Label, Polygon, Point > shapes(&resource);
+		shapes.emplace_back(Label(long_text));
+		shapes.emplace_back(std::in_place_type_t< Polygon >{}, 32u);
+		shapes.emplace_back(Point{});
+		shapes.push_back(shapes.front());
+		shapes.resize(8);
+
+		const std::size_t allocated = resource.allocated;
+		ASSERT_GT(allocated, shapes.capacity() * sizeof(variant_type));
+
+		for (const variant_type &current : shapes) {
+			if (current.index() == 0) {
+				ASSERT_EQ(static_cast< const Label & >(current.get()).text.get_allocator().resource(), &resource);
+			} else if (current.index() == 1) {
+				ASSERT_EQ(static_cast< const Polygon & >(current.get()).points.get_allocator().resource(),
+						  &resource);
+			}
+		}
+
+		ASSERT_EQ(shapes[1]->payload(), 32u);
+		ASSERT_EQ(shapes[3]->payload(), std::string(long_text).size());
+	}
+
+	ASSERT_EQ(resource.allocated, 0u);
+}
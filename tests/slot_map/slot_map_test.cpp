@@ -0,0 +1,163 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/algorithm.hpp>
+#include <pv/slot_map.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+class Entity {
+public:
+	virtual ~Entity() = default;
+
+	virtual int health() const = 0;
+};
+
+class Player final : public Entity {
+public:
+	int hp;
+
+	Player(int h) : hp(h) {}
+
+	int health() const override { return hp; }
+};
+
+class Monster final : public Entity {
+public:
+	int hp;
+	int damage;
+
+	Monster(int h, int d) : hp(h), damage(d) {}
+
+	int health() const override { return hp; }
+};
+
+class Counted final : public Entity {
+public:
+	static inline int instances = 0;
+
+	Counted() { ++instances; }
+	Counted(const Counted &) { ++instances; }
+	Counted(Counted &&) { ++instances; }
+	Counted &operator=(const Counted &) = default;
+	Counted &operator=(Counted &&)      = default;
+	~Counted() override { --instances; }
+
+	int health() const override { return 0; }
+};
+
+using entity_map    = pv::slot_map< Entity, Player, Monster, Counted >;
+using entity_handle = pv::slot_handle< Entity >;
+
+} // namespace
+
+TEST(slot_map, insert_and_lookup) {
+	entity_map entities;
+	ASSERT_TRUE(entities.empty());
+
+	const entity_handle player  = entities.emplace< Player >(100);
+	const entity_handle monster = entities.insert(Monster(30, 5));
+
+	ASSERT_EQ(entities.size(), 2);
+	ASSERT_TRUE(entities.contains(player));
+	ASSERT_EQ(entities.get(player).health(), 100);
+	ASSERT_EQ(entities[monster].index(), 1);
+	ASSERT_EQ(entities.find(monster), &entities[monster]);
+	ASSERT_NE(player, monster);
+
+	ASSERT_FALSE(entity_handle().valid());
+	ASSERT_FALSE(entities.contains(entity_handle()));
+	ASSERT_EQ(entities.find(entity_handle()), nullptr);
+
+	ASSERT_EQ(entity_handle::from_value(monster.value()), monster);
+	ASSERT_EQ(entities.handle_at(0), player);
+}
+
+TEST(slot_map, erase_keeps_handles_stable) {
+	entity_map entities;
+
+	std::vector< entity_handle > handles;
+	for (int i = 0; i < 10; ++i) {
+		handles.push_back(entities.emplace< Player >(i));
+	}
+
+	ASSERT_TRUE(entities.erase(handles[2]));
+	ASSERT_TRUE(entities.erase(handles[9]));
+	ASSERT_TRUE(entities.erase(handles[0]));
+	ASSERT_FALSE(entities.erase(handles[0]));
+
+	ASSERT_EQ(entities.size(), 7);
+	for (int i = 0; i < 10; ++i) {
+		const bool erased = i == 0 || i == 2 || i == 9;
+		ASSERT_EQ(entities.contains(handles[static_cast< std::size_t >(i)]), !erased);
+
+		if (!erased) {
+			ASSERT_EQ(entities.get(handles[static_cast< std::size_t >(i)]).health(), i);
+		}
+	}
+
+	// Every element's dense position maps back to its handle
+	for (std::size_t i = 0; i < entities.size(); ++i) {
+		ASSERT_EQ(&entities[entities.handle_at(i)], &*(entities.begin() + static_cast< std::ptrdiff_t >(i)));
+	}
+}
+
+TEST(slot_map, reused_slots_reject_stale_handles) {
+	entity_map entities;
+
+	const entity_handle first = entities.emplace< Player >(1);
+	entities.erase(first);
+
+	const entity_handle second = entities.emplace< Monster >(2, 3);
+	ASSERT_EQ(second.index(), first.index());
+	ASSERT_NE(second.generation(), first.generation());
+
+	ASSERT_FALSE(entities.contains(first));
+	ASSERT_EQ(entities.find(first), nullptr);
+	ASSERT_EQ(entities.get(second).health(), 2);
+
+	// A forged handle to a free slot is rejected as well
+	entities.erase(second);
+	ASSERT_FALSE(entities.contains(entity_handle::from_value(second.value() + (std::uint64_t{ 1 } << 32))));
+}
+
+TEST(slot_map, iteration) {
+	entity_map entities;
+	entities.emplace< Player >(10);
+	const entity_handle monster = entities.emplace< Monster >(20, 1);
+	entities.emplace< Monster >(30, 2);
+	entities.erase(monster);
+
+	int total = 0;
+	pv::for_each(entities, [&total](const auto &entity) { total += entity.health(); });
+	ASSERT_EQ(total, 40);
+
+	const std::size_t monsters = pv::count_if(
+		entities, [](const auto &entity) { return std::is_same_v< std::decay_t< decltype(entity) >, Monster >; });
+	ASSERT_EQ(monsters, 1);
+}
+
+TEST(slot_map, clear) {
+	entity_map entities;
+	const entity_handle counted = entities.emplace< Counted >();
+	entities.emplace< Counted >();
+	ASSERT_EQ(Counted::instances, 2);
+
+	entities.clear();
+	ASSERT_EQ(Counted::instances, 0);
+	ASSERT_TRUE(entities.empty());
+	ASSERT_FALSE(entities.contains(counted));
+
+	const entity_handle player = entities.emplace< Player >(5);
+	ASSERT_TRUE(entities.contains(player));
+	ASSERT_FALSE(entities.contains(counted));
+	ASSERT_EQ(entities.size(), 1);
+}
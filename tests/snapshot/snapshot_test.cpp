@@ -0,0 +1,190 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/snapshot.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct Shape {
+	virtual ~Shape() = default;
+
+	virtual double area() const = 0;
+};
+
+struct Square : Shape {
+	double length = 0;
+
+	Square() = default;
+	Square(double l) : length(l) {}
+
+	double area() const override { return length * length; }
+};
+
+struct Rectangle : Shape {
+	float width  = 0;
+	float height = 0;
+
+	Rectangle() = default;
+	Rectangle(float w, float h) : width(w), height(h) {}
+
+	double area() const override { return static_cast< double >(width * height); }
+};
+
+struct Circle : Shape {
+	int radius = 0;
+
+	Circle() = default;
+	Circle(int r) : radius(r) {}
+
+	double area() const override { return 3 * radius * radius; }
+};
+
+template<> struct pv::snapshot_relocatable< Square > : std::true_type {};
+template<> struct pv::snapshot_relocatable< Rectangle > : std::true_type {};
+template<> struct pv::snapshot_relocatable< Circle > : std::true_type {};
+
+using variant_type = pv::polymorphic_variant< Shape, Square, Rectangle, Circle >;
+
+class snapshot : public ::testing::Test {
+protected:
+	void TearDown() override { std::filesystem::remove(m_path); }
+
+	static std::string temporary_path() {
+		const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+
+		return (std::filesystem::temp_directory_path() / ("pv_snapshot_test_" + name)).string();
+	}
+
+	std::string m_path = temporary_path();
+};
+
+std::vector< variant_type > make_shapes() {
+	std::vector< variant_type > shapes;
+	for (int i = 0; i < 1000; ++i) {
+		switch (i % 3) {
+			case 0:
+				shapes.emplace_back(Square(i));
+				break;
+			case 1:
+				shapes.emplace_back(Rectangle(static_cast< float >(i), 2));
+				break;
+			default:
+				shapes.emplace_back(Circle(i));
+				break;
+		}
+	}
+
+	return shapes;
+}
+
+#ifdef PV_SNAPSHOT_SUPPORTED
+
+TEST_F(snapshot, round_trip) {
+	const std::vector< variant_type > shapes = make_shapes();
+
+	pv::write_snapshot(m_path, shapes);
+
+	const pv::mapped_snapshot< Shape, Square, Rectangle, Circle > loaded(m_path);
+
+	ASSERT_EQ(loaded.size(), shapes.size());
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		ASSERT_EQ(loaded[i].index(), shapes[i].index());
+		ASSERT_EQ(loaded[i]->area(), shapes[i]->area());
+	}
+}
+
+TEST_F(snapshot, restamps_vtable_pointers) {
+	std::vector< variant_type > shapes = make_shapes();
+
+	// Corrupt the vtable pointers (as would be the case if the snapshot was written by a different process) and restore
+	// them afterwards, so that the objects can be destroyed
+	std::vector< const void * > vptrs;
+	for (variant_type &shape : shapes) {
+		shape.visit([&vptrs](auto &object) {
+			vptrs.emplace_back();
+			std::memcpy(&vptrs.back(), std::addressof(object), sizeof(void *));
+			std::memset(static_cast< void * >(std::addressof(object)), 0xAB, sizeof(void *));
+		});
+	}
+
+	pv::write_snapshot(m_path, shapes);
+
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		shapes[i].visit([&vptrs, i](auto &object) {
+			std::memcpy(static_cast< void * >(std::addressof(object)), &vptrs[i], sizeof(void *));
+		});
+	}
+
+	pv::mapped_snapshot< Shape, Square, Rectangle, Circle > loaded(m_path);
+
+	double total = 0;
+	for (const variant_type &shape : loaded) {
+		total += shape->area();
+	}
+
+	const std::vector< variant_type > expected = make_shapes();
+	double expected_total                      = 0;
+	for (const variant_type &shape : expected) {
+		expected_total += shape->area();
+	}
+
+	ASSERT_EQ(total, expected_total);
+
+	// Modifications don't affect the file
+	loaded[0] = Circle(42);
+	ASSERT_EQ(loaded[0]->area(), 3 * 42 * 42);
+
+	const pv::mapped_snapshot< Shape, Square, Rectangle, Circle > reloaded(m_path);
+	ASSERT_EQ(reloaded[0].index(), 0);
+}
+
+TEST_F(snapshot, empty) {
+	pv::write_snapshot(m_path, std::vector< variant_type >{});
+
+	const pv::mapped_snapshot< Shape, Square, Rectangle, Circle > loaded(m_path);
+
+	ASSERT_TRUE(loaded.empty());
+	ASSERT_EQ(loaded.begin(), loaded.end());
+}
+
+TEST_F(snapshot, rejects_invalid_files) {
+	using other_type = pv::polymorphic_variant< Shape, Square, Circle >;
+
+	ASSERT_THROW((pv::mapped_snapshot< Shape, Square, Rectangle, Circle >(m_path)), std::system_error);
+
+	{
+		std::ofstream stream(m_path, std::ios::binary);
+		stream << "This is not a snapshot file, but it is long enough to contain a header";
+	}
+	ASSERT_THROW((pv::mapped_snapshot< Shape, Square, Rectangle, Circle >(m_path)), std::runtime_error);
+
+	pv::write_snapshot(m_path, std::vector< other_type >{ Square(1), Circle(2) });
+	ASSERT_THROW((pv::mapped_snapshot< Shape, Square, Rectangle, Circle >(m_path)), std::runtime_error);
+	ASSERT_EQ((pv::mapped_snapshot< Shape, Square, Circle >(m_path)).size(), 2);
+
+	// Truncated file
+	std::filesystem::resize_file(m_path, std::filesystem::file_size(m_path) - 1);
+	ASSERT_THROW((pv::mapped_snapshot< Shape, Square, Circle >(m_path)), std::runtime_error);
+
+	// File that is truncated within the padding between the header and the elements
+	std::filesystem::resize_file(m_path, 40);
+	ASSERT_THROW((pv::mapped_snapshot< Shape, Square, Circle >(m_path)), std::runtime_error);
+}
+
+#else
+
+TEST_F(snapshot, write_only) {
+	pv::write_snapshot(m_path, make_shapes());
+
+	ASSERT_TRUE(std::filesystem::exists(m_path));
+}
+
+#endif
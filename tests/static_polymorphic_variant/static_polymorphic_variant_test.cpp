@@ -0,0 +1,131 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/algorithm.hpp>
+#include <pv/static_polymorphic_variant.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// Neither of these classes has a virtual function or a common base class
+
+struct Circle {
+	double radius;
+
+	Circle(double r) : radius(r) {}
+
+	double area() const { return 3 * radius * radius; }
+	void scale(double factor) { radius *= factor; }
+	std::string name() const { return "circle"; }
+};
+
+struct Rectangle {
+	double width;
+	double height;
+
+	Rectangle(double w, double h) : width(w), height(h) {}
+
+	double area() const { return width * height; }
+	void scale(double factor) {
+		width *= factor;
+		height *= factor;
+	}
+	std::string name() const { return "rectangle"; }
+};
+
+template< typename Self > struct ShapeInterface : pv::static_interface< Self > {
+	PV_INTERFACE_FUNCTION(area)
+	PV_INTERFACE_FUNCTION(scale)
+	PV_INTERFACE_FUNCTION(name)
+
+	// Interface functions can also be written by hand
+	bool is_larger_than(double value) const {
+		return this->self().visit([value](const auto &shape) { return shape.area() > value; });
+	}
+};
+
+using shape = pv::static_polymorphic_variant< ShapeInterface, Circle, Rectangle >;
+
+static_assert(!std::is_polymorphic_v< shape >);
+static_assert(sizeof(shape) == sizeof(std::variant< Circle, Rectangle >));
+
+} // namespace
+
+TEST(static_polymorphic_variant, call_interface_functions) {
+	shape s = Circle{ 2 };
+	ASSERT_EQ(s.index(), 0);
+	ASSERT_EQ(s->area(), 12);
+	ASSERT_EQ(s->name(), "circle");
+	ASSERT_TRUE(s.is_larger_than(10));
+
+	s->scale(0.5);
+	ASSERT_EQ(s.area(), 3);
+
+	const shape rectangle(std::in_place_type_t< Rectangle >{}, 2.0, 3.0);
+	ASSERT_EQ(rectangle.index(), 1);
+	ASSERT_EQ(rectangle->area(), 6);
+	ASSERT_EQ(rectangle->name(), "rectangle");
+	ASSERT_FALSE(rectangle->is_larger_than(6));
+}
+
+TEST(static_polymorphic_variant, assignment) {
+	shape s = Circle{ 1 };
+
+	s = Rectangle{ 1, 4 };
+	ASSERT_EQ(s->area(), 4);
+
+	Circle &circle = s.emplace< Circle >(Circle{ 1 });
+	circle.radius  = 3;
+	ASSERT_EQ(s->area(), 27);
+
+	shape other = Rectangle{ 2, 2 };
+	s.swap(other);
+	ASSERT_EQ(s->area(), 4);
+	ASSERT_EQ(other->area(), 27);
+
+	s = other;
+	ASSERT_EQ(s->name(), "circle");
+}
+
+TEST(static_polymorphic_variant, visit) {
+	shape s = Rectangle{ 2, 5 };
+
+	const double width = pv::visit(
+		[](const auto &value) {
+			if constexpr (std::is_same_v< std::decay_t< decltype(value) >, Rectangle >) {
+				return value.width;
+			} else {
+				return 0.0;
+			}
+		},
+		s);
+	ASSERT_EQ(width, 2);
+
+	std::vector< shape > shapes = { Circle{ 1 }, Rectangle{ 1, 2 }, Circle{ 2 } };
+
+	double total = 0;
+	pv::for_each(shapes, [&total](const auto &value) { total += value.area(); });
+	ASSERT_EQ(total, 17);
+	ASSERT_EQ(pv::count_if(shapes, [](const auto &value) { return value.area() > 2; }), 2);
+}
+
+TEST(static_polymorphic_variant, typed_access) {
+	shape s = Rectangle{ 2, 5 };
+	ASSERT_EQ(s.get_if< Circle >(), nullptr);
+	ASSERT_EQ(s.get_if< Rectangle >()->height, 5);
+
+	std::vector< shape > shapes = { Circle{ 2 }, Rectangle{ 3, 3 }, Circle{ 1 }, Rectangle{ 1, 2 } };
+	pv::sort_by_type(shapes, [](const auto &lhs, const auto &rhs) { return lhs.area() < rhs.area(); });
+
+	ASSERT_EQ(shapes[0].get_if< Circle >()->radius, 1);
+	ASSERT_EQ(shapes[1].get_if< Circle >()->radius, 2);
+	ASSERT_EQ(shapes[2].get_if< Rectangle >()->width, 1);
+	ASSERT_EQ(shapes[3].get_if< Rectangle >()->width, 3);
+}
@@ -0,0 +1,283 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/algorithm.hpp>
+#include <pv/static_vector.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Shape {
+public:
+	virtual ~Shape() = default;
+
+	virtual int area() const = 0;
+};
+
+class Square final : public Shape {
+public:
+	int side;
+
+	Square(int s) : side(s) {}
+
+	int area() const override { return side * side; }
+};
+
+class Rectangle final : public Shape {
+public:
+	int width;
+	int height;
+
+	Rectangle(int w, int h) : width(w), height(h) {}
+
+	int area() const override { return width * height; }
+};
+
+class Counted final : public Shape {
+public:
+	static inline int instances = 0;
+	// The amount of copies that succeed before copying throws (negative for no limit)
+	static inline int remaining_copies = -1;
+
+	Counted() { ++instances; }
+	Counted(const Counted &) {
+		if (remaining_copies == 0) {
+			throw std::runtime_error("Copy failed");
+		}
+		--remaining_copies;
+		++instances;
+	}
+	~Counted() override { --instances; }
+
+	int area() const override { return 0; }
+};
+
+// Counts its copies, so that relocations via memcpy/memmove can be told apart from relocations via constructors
+class Relocated final : public Shape {
+public:
+	static inline int copies = 0;
+
+	int value;
+
+	Relocated(int v) : value(v) {}
+	Relocated(const Relocated &other) : Shape(other), value(other.value) { ++copies; }
+	Relocated &operator=(const Relocated &other) {
+		value = other.value;
+		++copies;
+
+		return *this;
+	}
+
+	int area() const override { return value; }
+};
+
+} // namespace
+
+template<> struct pv::trivially_relocatable< Square > : std::true_type {};
+template<> struct pv::trivially_relocatable< Rectangle > : std::true_type {};
+template<> struct pv::trivially_relocatable< Relocated > : std::true_type {};
+
+namespace {
+
+using shape_vector    = pv::static_vector< Shape, 4, Square, Rectangle >;
+using counted_vector  = pv::static_vector< Shape, 4, Square, Counted >;
+using shape_variant   = shape_vector::value_type;
+using counted_variant = counted_vector::value_type;
+
+static_assert(pv::trivially_relocatable_v< shape_variant >);
+static_assert(!pv::trivially_relocatable_v< counted_variant >);
+// Polymorphic types are never trivially copyable, so they are only trivially relocatable when opted in
+static_assert(!std::is_trivially_copyable_v< Counted >);
+static_assert(!pv::trivially_relocatable_v< Counted >);
+
+} // namespace
+
+TEST(static_vector, emplace_and_access) {
+	shape_vector shapes;
+	ASSERT_TRUE(shapes.empty());
+	ASSERT_EQ(shape_vector::capacity(), 4);
+
+	Square &square = shapes.emplace_back< Square >(2);
+	ASSERT_EQ(&square, &shapes.get(0));
+	shapes.emplace_back< Rectangle >(2, 3);
+	shapes.push_back(shape_variant(Square(3)));
+
+	ASSERT_EQ(shapes.size(), 3);
+	ASSERT_EQ(shapes.front().get().area(), 4);
+	ASSERT_EQ(shapes[1].index(), 1);
+	ASSERT_EQ(shapes.back().get().area(), 9);
+	ASSERT_EQ(shapes.at(1).get().area(), 6);
+	ASSERT_THROW(shapes.at(3), std::out_of_range);
+
+	// The elements are stored inline
+	const void *begin = static_cast< const void * >(&shapes);
+	const void *end   = static_cast< const void * >(&shapes + 1);
+	ASSERT_GE(static_cast< const void * >(shapes.data()), begin);
+	ASSERT_LT(static_cast< const void * >(shapes.data()), end);
+
+	shapes.pop_back();
+	ASSERT_EQ(shapes.size(), 2);
+}
+
+TEST(static_vector, capacity_exceeded) {
+	counted_vector shapes;
+	for (std::size_t i = 0; i < counted_vector::capacity(); ++i) {
+		shapes.emplace_back< Counted >();
+	}
+
+	ASSERT_TRUE(shapes.full());
+	ASSERT_THROW(shapes.emplace_back< Counted >(), std::length_error);
+	ASSERT_THROW(shapes.push_back(counted_variant(Square(1))), std::length_error);
+	ASSERT_EQ(shapes.size(), 4);
+	ASSERT_EQ(Counted::instances, 4);
+
+	shapes.clear();
+	ASSERT_EQ(Counted::instances, 0);
+}
+
+TEST(static_vector, erase) {
+	shape_vector shapes{ Square(1), Rectangle(1, 2), Square(3) };
+
+	shapes.erase(1);
+	ASSERT_EQ(shapes.size(), 2);
+	ASSERT_EQ(shapes[0].get().area(), 1);
+	ASSERT_EQ(shapes[1].get().area(), 9);
+
+	counted_vector counted;
+	counted.emplace_back< Square >(1);
+	counted.emplace_back< Counted >();
+	counted.emplace_back< Square >(2);
+
+	counted.erase(1);
+	ASSERT_EQ(Counted::instances, 0);
+	ASSERT_EQ(counted.size(), 2);
+	ASSERT_EQ(counted[1].get().area(), 4);
+}
+
+TEST(static_vector, copy_and_move) {
+	shape_vector shapes{ Square(2), Rectangle(2, 3) };
+
+	shape_vector copy(shapes);
+	ASSERT_EQ(copy.size(), 2);
+	ASSERT_EQ(copy[1].get().area(), 6);
+
+	shape_vector moved(std::move(copy));
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved.size(), 2);
+	ASSERT_EQ(moved[0].get().area(), 4);
+	ASSERT_EQ(moved[1].get().area(), 6);
+
+	counted_vector counted;
+	counted.emplace_back< Counted >();
+	counted.emplace_back< Counted >();
+
+	counted_vector other;
+	other.emplace_back< Counted >();
+	other = counted;
+	ASSERT_EQ(Counted::instances, 4);
+
+	counted_vector counted_moved(std::move(counted));
+	ASSERT_TRUE(counted.empty());
+	ASSERT_EQ(Counted::instances, 4);
+
+	other = std::move(counted_moved);
+	ASSERT_EQ(other.size(), 2);
+	ASSERT_EQ(Counted::instances, 2);
+}
+
+TEST(static_vector, trivial_relocation) {
+	using relocated_vector = pv::static_vector< Shape, 4, Square, Relocated >;
+	static_assert(pv::trivially_relocatable_v< relocated_vector::value_type >);
+
+	relocated_vector shapes;
+	shapes.emplace_back< Relocated >(1);
+	shapes.emplace_back< Square >(2);
+	shapes.emplace_back< Relocated >(3);
+	Relocated::copies = 0;
+
+	// Both operations relocate the elements by copying their bytes
+	relocated_vector moved(std::move(shapes));
+	moved.erase(0);
+	ASSERT_EQ(Relocated::copies, 0);
+
+	ASSERT_EQ(moved.size(), 2);
+	ASSERT_EQ(moved[0].get().area(), 4);
+	ASSERT_EQ(moved[1].get().area(), 3);
+	ASSERT_EQ(moved[1].index(), 1);
+}
+
+TEST(static_vector, failed_copy) {
+	counted_vector shapes;
+	for (std::size_t i = 0; i < counted_vector::capacity(); ++i) {
+		shapes.emplace_back< Counted >();
+	}
+	ASSERT_EQ(Counted::instances, 4);
+
+	// The elements that have already been copied are destroyed again
+	Counted::remaining_copies = 2;
+	ASSERT_THROW(counted_vector copy(shapes), std::runtime_error);
+	ASSERT_EQ(Counted::instances, 4);
+
+	Counted::remaining_copies = 2;
+	counted_vector assigned;
+	ASSERT_THROW(assigned = shapes, std::runtime_error);
+	ASSERT_TRUE(assigned.empty());
+	ASSERT_EQ(Counted::instances, 4);
+
+	{
+		const Counted counted;
+		// Two copies for the initializer list, of which only the first can be copied into the vector
+		Counted::remaining_copies = 3;
+		ASSERT_THROW((counted_vector{ counted_variant(counted), counted_variant(counted) }), std::runtime_error);
+		ASSERT_EQ(Counted::instances, 5);
+	}
+
+	Counted::remaining_copies = -1;
+	shapes.clear();
+	ASSERT_EQ(Counted::instances, 0);
+}
+
+TEST(algorithm, for_each) {
+	shape_vector shapes{ Square(2), Rectangle(2, 3), Square(1) };
+
+	int total   = 0;
+	int squares = 0;
+	pv::for_each(shapes, [&](const auto &shape) {
+		total += shape.area();
+		if constexpr (std::is_same_v< std::decay_t< decltype(shape) >, Square >) {
+			++squares;
+		}
+	});
+
+	ASSERT_EQ(total, 11);
+	ASSERT_EQ(squares, 2);
+
+	pv::for_each(shapes, [](auto &shape) {
+		if constexpr (std::is_same_v< std::decay_t< decltype(shape) >, Square >) {
+			shape.side *= 2;
+		}
+	});
+	ASSERT_EQ(shapes[0].get().area(), 16);
+}
+
+TEST(algorithm, find_if_and_count_if) {
+	std::vector< shape_variant > shapes = { Square(2), Rectangle(2, 3), Square(1), Rectangle(1, 1) };
+
+	const auto is_rectangle = [](const auto &shape) {
+		return std::is_same_v< std::decay_t< decltype(shape) >, Rectangle >;
+	};
+
+	auto it = pv::find_if(shapes, is_rectangle);
+	ASSERT_EQ(it - shapes.begin(), 1);
+	ASSERT_EQ(pv::find_if(shapes, [](const auto &shape) { return shape.area() > 10; }), shapes.end());
+
+	ASSERT_EQ(pv::count_if(shapes, is_rectangle), 2);
+	ASSERT_EQ(pv::count_if(shapes, [](const auto &shape) { return shape.area() < 5; }), 3);
+}
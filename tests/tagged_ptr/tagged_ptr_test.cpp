@@ -0,0 +1,284 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/pmr.hpp>
+#include <pv/tagged_ptr.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+class Animal {
+public:
+	virtual ~Animal() = default;
+
+	virtual int legs() const = 0;
+};
+
+class Dog final : public Animal {
+public:
+	int legs() const override { return 4; }
+};
+
+class Bird final : public Animal {
+public:
+	bool can_fly;
+
+	Bird(bool fly) : can_fly(fly) {}
+
+	int legs() const override { return 2; }
+};
+
+class Named {
+public:
+	virtual ~Named() = default;
+
+	const char *name = "snake";
+};
+
+// The Animal subobject is not located at the start of the object
+class Snake final : public Named, public Animal {
+public:
+	int legs() const override { return 0; }
+};
+
+class Counted final : public Animal {
+public:
+	static inline int instances = 0;
+	static inline bool fail_copies = false;
+
+	Counted(bool fail = false) {
+		if (fail) {
+			throw std::runtime_error("Construction failed");
+		}
+		++instances;
+	}
+	Counted(const Counted &) {
+		if (fail_copies) {
+			throw std::runtime_error("Copy failed");
+		}
+		++instances;
+	}
+	~Counted() override { --instances; }
+
+	int legs() const override { return -1; }
+};
+
+template< int I > class Numbered final : public Animal {
+public:
+	int legs() const override { return I; }
+};
+
+using animal_ptr = pv::tagged_ptr< Animal, Dog, Bird, Snake, Counted >;
+
+// A tree node owning its children (through tagged pointers that can point to another Tree)
+class Tree final : public Animal {
+public:
+	std::vector< pv::tagged_ptr< Animal, Dog, Counted, Tree > > children;
+
+	int legs() const override { return static_cast< int >(children.size()); }
+};
+
+using tree_ptr = pv::tagged_ptr< Animal, Dog, Counted, Tree >;
+
+class PmrTree final : public Animal {
+public:
+	std::vector< pv::pmr::tagged_ptr< Animal, Dog, Counted, PmrTree > > children;
+
+	int legs() const override { return static_cast< int >(children.size()); }
+};
+
+static_assert(sizeof(animal_ptr) == sizeof(void *));
+static_assert(std::is_nothrow_move_assignable_v< animal_ptr >);
+static_assert(!std::is_nothrow_move_assignable_v< pv::pmr::tagged_ptr< Animal, Dog, Bird, Snake, Counted > >);
+
+} // namespace
+
+TEST(tagged_ptr, null) {
+	animal_ptr ptr;
+	ASSERT_FALSE(ptr);
+	ASSERT_EQ(ptr, nullptr);
+	ASSERT_EQ(ptr.get(), nullptr);
+	ASSERT_EQ(ptr.index(), std::variant_npos);
+	ASSERT_FALSE(ptr.holds_alternative< Dog >());
+	ASSERT_EQ(ptr.get_if< Dog >(), nullptr);
+}
+
+TEST(tagged_ptr, typed_access) {
+	animal_ptr ptr(std::in_place_type_t< Bird >{}, true);
+	ASSERT_TRUE(ptr);
+	ASSERT_EQ(ptr.index(), 1u);
+	ASSERT_EQ(ptr->legs(), 2);
+	ASSERT_TRUE(ptr.holds_alternative< Bird >());
+	ASSERT_FALSE(ptr.holds_alternative< Dog >());
+	ASSERT_EQ(ptr.get_if< Dog >(), nullptr);
+	ASSERT_EQ(ptr.get_if< Bird >(), ptr.get());
+	ASSERT_TRUE(ptr.get_if< Bird >()->can_fly);
+
+	// Base-class pointers to objects whose Animal subobject has an offset are adjusted correctly
+	ptr = Snake();
+	ASSERT_EQ(ptr.index(), 2u);
+	ASSERT_EQ(ptr->legs(), 0);
+	ASSERT_EQ(static_cast< Animal * >(ptr.get_if< Snake >()), ptr.get());
+	ASSERT_STREQ(ptr.get_if< Snake >()->name, "snake");
+}
+
+TEST(tagged_ptr, visit) {
+	const animal_ptr ptr = Snake();
+
+	ASSERT_EQ(pv::visit([](const auto &animal) { return animal.legs(); }, ptr), 0);
+	ASSERT_TRUE(ptr.visit([](auto &animal) { return std::is_same_v< decltype(animal), const Snake & >; }));
+
+	animal_ptr dog = Dog();
+	ASSERT_TRUE(std::move(dog).visit([](auto &&animal) { return std::is_same_v< decltype(animal), Dog && >; }));
+}
+
+TEST(tagged_ptr, ownership) {
+	{
+		animal_ptr first(std::in_place_type_t< Counted >{});
+		ASSERT_EQ(Counted::instances, 1);
+
+		animal_ptr second = std::move(first);
+		ASSERT_EQ(first, nullptr);
+		ASSERT_EQ(Counted::instances, 1);
+
+		second.emplace< Counted >();
+		ASSERT_EQ(Counted::instances, 1);
+
+		// A failed emplace keeps the current object
+		ASSERT_THROW(second.emplace< Counted >(true), std::runtime_error);
+		ASSERT_TRUE(second.holds_alternative< Counted >());
+		ASSERT_EQ(Counted::instances, 1);
+
+		first = Dog();
+		first.swap(second);
+		ASSERT_TRUE(first.holds_alternative< Counted >());
+		ASSERT_TRUE(second.holds_alternative< Dog >());
+
+		second = std::move(first);
+		ASSERT_EQ(Counted::instances, 1);
+	}
+
+	ASSERT_EQ(Counted::instances, 0);
+}
+
+TEST(tagged_ptr, allocator) {
+	using pmr_animal_ptr = pv::pmr::tagged_ptr< Animal, Dog, Bird, Snake, Counted >;
+
+	counting_resource resource;
+	counting_resource other_resource;
+
+	{
+		pmr_animal_ptr ptr(std::allocator_arg, &resource, std::in_place_type_t< Snake >{});
+		ASSERT_EQ(resource.allocated, sizeof(Snake));
+
+		ptr.emplace< Bird >(false);
+		ASSERT_EQ(resource.allocated, sizeof(Bird));
+		ASSERT_EQ(ptr.get_allocator().resource(), &resource);
+
+		// Moving into an object with a different memory resource moves the object into memory from that resource
+		pmr_animal_ptr other(&other_resource);
+		other = std::move(ptr);
+		ASSERT_EQ(resource.allocated, 0u);
+		ASSERT_EQ(other_resource.allocated, sizeof(Bird));
+		ASSERT_EQ(other.index(), 1u);
+		ASSERT_FALSE(other.get_if< Bird >()->can_fly);
+	}
+
+	ASSERT_EQ(other_resource.allocated, 0u);
+}
+
+TEST(tagged_ptr, failed_allocator_move) {
+	using pmr_animal_ptr = pv::pmr::tagged_ptr< Animal, Dog, Bird, Snake, Counted >;
+
+	counting_resource resource;
+	counting_resource other_resource;
+
+	{
+		pmr_animal_ptr ptr(std::allocator_arg, &resource, std::in_place_type_t< Counted >{});
+		pmr_animal_ptr other(std::allocator_arg, &other_resource, std::in_place_type_t< Bird >{}, true);
+
+		// Moving the object into memory of the other resource fails -> both pointers keep their objects
+		Counted::fail_copies = true;
+		ASSERT_THROW(other = std::move(ptr), std::runtime_error);
+		Counted::fail_copies = false;
+
+		ASSERT_TRUE(ptr.holds_alternative< Counted >());
+		ASSERT_TRUE(other.holds_alternative< Bird >());
+		ASSERT_TRUE(other.get_if< Bird >()->can_fly);
+		ASSERT_EQ(Counted::instances, 1);
+		ASSERT_EQ(resource.allocated, sizeof(Counted));
+		ASSERT_EQ(other_resource.allocated, sizeof(Bird));
+	}
+
+	ASSERT_EQ(Counted::instances, 0);
+	ASSERT_EQ(resource.allocated, 0u);
+	ASSERT_EQ(other_resource.allocated, 0u);
+}
+
+TEST(tagged_ptr, many_types) {
+	// More types than the alignment of Animal leaves unused bits for
+	using many_ptr = pv::tagged_ptr< Animal, Numbered< 0 >, Numbered< 1 >, Numbered< 2 >, Numbered< 3 >, Numbered< 4 >,
+									 Numbered< 5 >, Numbered< 6 >, Numbered< 7 >, Numbered< 8 >, Numbered< 9 > >;
+	static_assert(sizeof(many_ptr) == sizeof(void *));
+
+	many_ptr ptr = Numbered< 9 >();
+	ASSERT_EQ(ptr.index(), 9u);
+	ASSERT_EQ(ptr->legs(), 9);
+	ASSERT_NE(ptr.get_if< Numbered< 9 > >(), nullptr);
+
+	ptr.emplace< Numbered< 3 > >();
+	ASSERT_EQ(ptr.visit([](const auto &animal) { return animal.legs(); }), 3);
+}
+
+TEST(tagged_ptr, assign_owned_child) {
+	// The moved-from pointer is owned by the object that is replaced by the assignment
+	tree_ptr root(std::in_place_type_t< Tree >{});
+	root.get_if< Tree >()->children.emplace_back(std::in_place_type_t< Tree >{});
+	root.get_if< Tree >()->children.front().get_if< Tree >()->children.emplace_back(std::in_place_type_t< Counted >{});
+	ASSERT_EQ(Counted::instances, 1);
+
+	root = std::move(root.get_if< Tree >()->children.front());
+	ASSERT_TRUE(root.holds_alternative< Tree >());
+	ASSERT_EQ(root->legs(), 1);
+	ASSERT_EQ(Counted::instances, 1);
+
+	root = std::move(root.get_if< Tree >()->children.front());
+	ASSERT_TRUE(root.holds_alternative< Counted >());
+	ASSERT_EQ(Counted::instances, 1);
+
+	root.reset();
+	ASSERT_EQ(Counted::instances, 0);
+}
+
+TEST(tagged_ptr, assign_owned_child_unequal_allocators) {
+	using pmr_tree_ptr = pv::pmr::tagged_ptr< Animal, Dog, Counted, PmrTree >;
+
+	counting_resource resource;
+	counting_resource other_resource;
+
+	pmr_tree_ptr root(std::allocator_arg, &resource, std::in_place_type_t< PmrTree >{});
+	root.get_if< PmrTree >()->children.emplace_back(std::allocator_arg, &other_resource,
+													std::in_place_type_t< Counted >{});
+	ASSERT_EQ(Counted::instances, 1);
+
+	root = std::move(root.get_if< PmrTree >()->children.front());
+	ASSERT_TRUE(root.holds_alternative< Counted >());
+	ASSERT_EQ(Counted::instances, 1);
+	ASSERT_EQ(root.get_allocator().resource(), &resource);
+	ASSERT_EQ(other_resource.allocated, 0u);
+
+	root.reset();
+	ASSERT_EQ(Counted::instances, 0);
+	ASSERT_EQ(resource.allocated, 0u);
+}
@@ -0,0 +1,201 @@
+// Use of this source code is governed by a BSD-style license that can
+// be found in the LICENSE file at the root of the source tree or at
+// <https://github.com/Krzmbrzl/polymorphic_variant/blob/main/LICENSE>.
+
+#include <pv/tagged_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <test_definitions.hpp>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using vector_type  = pv::tagged_vector< Base, Base, Derived1, Derived2 >;
+using variant_type = vector_type::value_type;
+
+TEST(tagged_vector, keeps_index_in_sync) {
+	vector_type vec = { variant_type(Derived1{ 1 }), variant_type(Derived2{ 2 }) };
+
+	vec.push_back(variant_type(Base{ 3 }));
+	Derived2 &emplaced = vec.emplace_back< Derived2 >(4);
+	ASSERT_EQ(emplaced.the_value, 4);
+
+	ASSERT_EQ(vec.size(), 4u);
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 1, 2, 0, 2 }));
+
+	vec.assign(0, Derived2{ 5 });
+	vec.emplace< Base >(1, 6);
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 2, 0, 0, 2 }));
+	ASSERT_EQ(vec[0]->the_value, 5);
+	ASSERT_EQ(vec.get(1).the_value, 6);
+
+	vec.erase(1);
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 2, 0, 2 }));
+	ASSERT_EQ(vec[1]->the_value, 3);
+
+	vec.pop_back();
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 2, 0 }));
+
+	vec.clear();
+	ASSERT_TRUE(vec.empty());
+	ASSERT_TRUE(vec.type_indices().empty());
+}
+
+struct Throwing : Base {
+	static inline bool fail_copies = false;
+
+	Throwing(int i, bool fail = false) : Base(i) {
+		if (fail) {
+			throw std::runtime_error("Construction failed");
+		}
+	}
+	Throwing(const Throwing &other) : Base(other) {
+		if (fail_copies) {
+			throw std::runtime_error("Copy failed");
+		}
+	}
+};
+
+TEST(tagged_vector, failed_replacement) {
+	using throwing_vector = pv::tagged_vector< Base, Base, Derived1, Throwing >;
+
+	throwing_vector vec = { throwing_vector::value_type(Derived1{ 1 }), throwing_vector::value_type(Derived1{ 2 }) };
+
+	auto in_sync = [&vec]() {
+		for (std::size_t i = 0; i < vec.size(); ++i) {
+			if (vec.type_indices()[i] != static_cast< std::uint8_t >(vec[i].index())) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	ASSERT_THROW(vec.emplace< Throwing >(0, 3, true), std::runtime_error);
+	ASSERT_TRUE(in_sync());
+
+	const throwing_vector::value_type replacement(Throwing{ 4 });
+	Throwing::fail_copies = true;
+	ASSERT_THROW(vec.assign(1, replacement), std::runtime_error);
+	Throwing::fail_copies = false;
+	ASSERT_TRUE(in_sync());
+
+	const std::size_t remaining_derived1 = (vec[0].index() == 1 ? 1u : 0u) + (vec[1].index() == 1 ? 1u : 0u);
+	ASSERT_EQ(vec.count_if_type< Derived1 >(), remaining_derived1);
+	ASSERT_EQ(vec.count_if_type< Throwing >(), 0u);
+
+	// Replacing the elements again works as usual
+	vec.emplace< Throwing >(0, 5);
+	vec.assign(1, replacement);
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 2, 2 }));
+	ASSERT_EQ(vec.count_if_type< Throwing >(), 2u);
+}
+
+TEST(tagged_vector, failed_erase) {
+	using throwing_vector = pv::tagged_vector< Base, Base, Derived1, Throwing >;
+
+	throwing_vector vec = { throwing_vector::value_type(Derived1{ 1 }), throwing_vector::value_type(Throwing{ 2 }),
+							throwing_vector::value_type(Derived1{ 3 }) };
+
+	auto in_sync = [&vec]() {
+		for (std::size_t i = 0; i < vec.size(); ++i) {
+			if (vec.type_indices()[i] != static_cast< std::uint8_t >(vec[i].index())) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Shifting the Throwing element onto the erased position has to copy it (it has no move constructor)
+	Throwing::fail_copies = true;
+	ASSERT_THROW(vec.erase(0), std::runtime_error);
+	Throwing::fail_copies = false;
+	ASSERT_EQ(vec.type_indices().size(), vec.size());
+	ASSERT_TRUE(in_sync());
+
+	std::size_t derived1_count = 0;
+	for (std::size_t i = 0; i < vec.size(); ++i) {
+		derived1_count += vec[i].index() == 1 ? 1u : 0u;
+	}
+	ASSERT_EQ(vec.count_if_type< Derived1 >(), derived1_count);
+}
+
+TEST(tagged_vector, append_n) {
+	vector_type vec = { variant_type(Base{ 1 }) };
+
+	const std::vector< int > values = { 2, 3, 4 };
+	vec.append_n< Derived2 >(values.begin(), values.end());
+
+	int next = 5;
+	vec.append_n< Derived1 >(2, [&next]() { return next++; });
+
+	ASSERT_EQ(vec.size(), 6u);
+	ASSERT_EQ(vec.type_indices(), (std::vector< std::uint8_t >{ 0, 2, 2, 2, 1, 1 }));
+	ASSERT_EQ(vec.count_if_type< Derived2 >(), 3u);
+	for (std::size_t i = 0; i < vec.size(); ++i) {
+		ASSERT_EQ(vec[i]->the_value, static_cast< int >(i) + 1);
+	}
+}
+
+TEST(tagged_vector, type_queries) {
+	vector_type vec;
+	ASSERT_EQ(vec.count_if_type< Derived1 >(), 0u);
+	ASSERT_EQ(vec.find_first_of_type< Derived1 >(), 0u);
+	ASSERT_TRUE(vec.positions_of_type< Derived1 >().empty());
+
+	for (int i = 0; i < 100; ++i) {
+		if (i % 7 == 3) {
+			vec.emplace_back< Derived1 >(i);
+		} else {
+			vec.emplace_back< Derived2 >(i);
+		}
+	}
+
+	ASSERT_EQ(vec.count_if_type< Derived1 >(), 14u);
+	ASSERT_EQ(vec.count_if_type< Derived2 >(), 86u);
+	ASSERT_EQ(vec.count_if_type< Base >(), 0u);
+
+	ASSERT_EQ(vec.find_first_of_type< Derived1 >(), 3u);
+	ASSERT_EQ(vec.find_first_of_type< Derived2 >(), 0u);
+	ASSERT_EQ(vec.find_first_of_type< Base >(), vec.size());
+
+	const std::vector< std::size_t > positions = vec.positions_of_type< Derived1 >();
+	ASSERT_EQ(positions.size(), 14u);
+	for (std::size_t pos : positions) {
+		ASSERT_EQ(pos % 7, 3u);
+		ASSERT_EQ(vec[pos].index(), 1u);
+	}
+}
+
+TEST(tag_scan, kernels_agree) {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution< int > dist(0, 3);
+
+	const std::vector< const pv::details::tag_scan::kernels * > kernels = pv::details::tag_scan::available_kernels();
+	const pv::details::tag_scan::kernels &reference                      = pv::details::tag_scan::scalar_kernels();
+
+	// Cover sizes that are not a multiple of the SIMD width
+	for (std::size_t size : { 0u, 1u, 15u, 16u, 31u, 32u, 33u, 100u, 1000u }) {
+		std::vector< std::uint8_t > data(size);
+		for (std::uint8_t &current : data) {
+			current = static_cast< std::uint8_t >(dist(rng));
+		}
+
+		for (std::uint8_t tag = 0; tag < 5; ++tag) {
+			std::vector< std::size_t > expected_positions;
+			reference.positions(data.data(), size, tag, expected_positions);
+
+			for (const pv::details::tag_scan::kernels *current : kernels) {
+				ASSERT_EQ(current->count(data.data(), size, tag), reference.count(data.data(), size, tag))
+					<< current->name;
+				ASSERT_EQ(current->find_first(data.data(), size, tag), reference.find_first(data.data(), size, tag))
+					<< current->name;
+
+				std::vector< std::size_t > positions;
+				current->positions(data.data(), size, tag, positions);
+				ASSERT_EQ(positions, expected_positions) << current->name;
+			}
+		}
+	}
+}
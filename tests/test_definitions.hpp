@@ -5,6 +5,9 @@
 #ifndef PV_TESTS_TESTDEFINITIONS_HPP_
 #define PV_TESTS_TESTDEFINITIONS_HPP_
 
+#include <cstddef>
+#include <memory_resource>
+
 class Base {
 public:
 	static constexpr int test_value = 0;
@@ -47,4 +50,25 @@ public:
 	virtual int get_test() const override { return test_value; }
 };
 
+/**
+ * A memory resource that counts the bytes that are currently allocated from it
+ */
+class counting_resource : public std::pmr::memory_resource {
+public:
+	std::size_t allocated = 0;
+
+private:
+	void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+		allocated += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+		allocated -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
 #endif // PV_TESTS_TESTDEFINITIONS_HPP_